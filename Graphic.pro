@@ -4,7 +4,7 @@
 #
 #-------------------------------------------------
 
-QT       += core gui svg
+QT       += core gui svg concurrent
 
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
@@ -14,39 +14,78 @@ TEMPLATE = app
 
 SOURCES += \
     basicgraphs.cpp \
+    benchmark.cpp \
+    canvasedit.cpp \
     canvasscene.cpp \
     canvasview.cpp \
     colourfillcontroller.cpp \
     colourlinecontroller.cpp \
+    coordinatekernels.cpp \
     cornergrabber.cpp \
     edge.cpp \
+    elasticdrag.cpp \
+    forcelayout.cpp \
     graph.cpp \
+    graphcache.cpp \
+    graphdescription.cpp \
+    graphmetrics.cpp \
     graphmimedata.cpp \
+    implicitedges.cpp \
     label.cpp \
     labelcontroller.cpp \
     labelsizecontroller.cpp \
+    layeredlayout.cpp \
+    layoutgraph.cpp \
+    layoutrunner.cpp \
     main.cpp \
     mainwindow.cpp \
+    metricspanel.cpp \
+    multilevellayout.cpp \
     node.cpp \
+    overlapremoval.cpp \
     preview.cpp \
-    sizecontroller.cpp
+    sizecontroller.cpp \
+    spectrallayout.cpp \
+    stresslayout.cpp \
+    sweep.cpp \
+    undostack.cpp
 
 HEADERS += \
     basicgraphs.h \
+    benchmark.h \
+    canvasedit.h \
     canvasscene.h \
     canvasview.h \
     colourfillcontroller.h \
     colourlinecontroller.h \
+    coordinatekernels.h \
     edge.h \
+    elasticdrag.h \
+    fastrandom.h \
+    forcelayout.h \
     graph.h \
+    graphcache.h \
+    graphdescription.h \
+    graphmetrics.h \
     graphmimedata.h \
+    implicitedges.h \
     label.h \
     labelcontroller.h \
     labelsizecontroller.h \
+    layeredlayout.h \
+    layoutgraph.h \
+    layoutrunner.h \
     mainwindow.h \
+    metricspanel.h \
+    multilevellayout.h \
     node.h \
+    overlapremoval.h \
     preview.h \
-    sizecontroller.h
+    sizecontroller.h \
+    spectrallayout.h \
+    stresslayout.h \
+    sweep.h \
+    undostack.h
 
 
 FORMS += mainwindow.ui
@@ -10,35 +10,89 @@
  * (a) Fixed scaling of internal polygon of antiprisms so that it scales
  *     according to both height and width.
  * (b) (drive-by) made formatting more consistent.
+ * Oct 18, 2026:
+ * (a) The generators now write into a GraphDescription instead of
+ *     creating Nodes and Edges, so that they can run on any thread.
+ *     generate() picks the generator for a Graph_Type.
+ * (b) Added random graphs (Erdos-Renyi, Barabasi-Albert, random
+ *     regular and random geometric), for stress testing.  Each
+ *     takes time proportional to the number of nodes plus edges,
+ *     and the same seed (see setSeed()) gives the same graph.
+ * (c) Balanced trees are laid out a level at a time instead of
+ *     recursively, and may have any number of children per node.
  */
 
 #include "basicgraphs.h"
+#include "coordinatekernels.h"
+#include "fastrandom.h"
 
 #include <qmath.h>
-#include "node.h"
-#include "edge.h"
+#include <QPair>
+#include <QSet>
+#include <climits>
 #include <QDebug>
+#include <QtConcurrent/QtConcurrentMap>
 
 static const double PI = 3.14159265358979323846264338327950288419717;
 
 static const bool verbose = false; /* for debugging purposes */
 
+// Complete and complete bipartite graphs with more edges than this
+// get a single ImplicitEdges item instead of an Edge per edge.
+#define IMPLICIT_EDGE_THRESHOLD	5000
+
+// The seed the random graphs use unless setSeed() is called.
+#define DEFAULT_RANDOM_SEED	20261018
+
+// How many other edges a random regular graph tries to swap a
+// self-loop or repeated edge with before giving up on it.
+#define REGULAR_SWAP_TRIES	100
+
+// Levels of a balanced tree with at least this many nodes are split
+// between threads.
+#define TREE_PARALLEL_LEVEL_SIZE	16384
+
 // TODO: Use golden ratio in graphs with two cycles
 
 BasicGraphs::BasicGraphs()
 {
     Graph_Type_Name = { "None", "Antiprism", "Balanced Binary Tree",
-			"Bipartite", "Crown", "Cycle", "Dutch Windmill",
+			"Balanced k-ary Tree", "Bipartite", "Crown", "Cycle",
+			"Dutch Windmill",
 			"Gear (generalized)", "Grid", "Helm", "Path",
-			"Petersen (generalized)", "Prism", "Round", "Star",
-			"Wheel"
+			"Petersen (generalized)", "Prism",
+			"Random (Barabasi-Albert)", "Random (Erdos-Renyi)",
+			"Random (geometric)", "Random (regular)", "Round",
+			"Star", "Wheel"
     };
+    seed = DEFAULT_RANDOM_SEED;
+}
+
+
+/*
+ * Name:	BasicGraphs::setSeed
+ * Purpose:	Sets the seed of the random graph generators.
+ * Arguments:	the seed
+ * Outputs:	Nothing.
+ * Modifies:	seed.
+ * Returns:	Nothing.
+ * Assumptions:	none
+ * Bugs:	
+ * Notes:	Each random graph is generated from the seed alone, so
+ *		generating the same type and size twice gives the same
+ *		graph.
+ */
+
+void
+BasicGraphs::setSeed(quint64 aSeed)
+{
+    seed = aSeed;
 }
 
 
 /*
 * Function:	generate_wheel()
-* Paramters:	item: the graph
+* Paramters:	desc: the graph description
 *		height: the desired height of the graph (note that
 *		        many other functions get height / 2 as the
 *			corresponding parameter)
@@ -46,7 +100,7 @@ BasicGraphs::BasicGraphs()
 *		numOfNodes: the number of vertices in the graph
 *		complete: if True, draw the edges
 * Output:      none
-* Modifies:    item
+* Modifies:    desc
 * Returns:     void
 * Assumptions: none
 * Bugs:        none
@@ -54,36 +108,30 @@ BasicGraphs::BasicGraphs()
 */
 
 void
-BasicGraphs::generate_wheel(Graph * item, qreal width, qreal height,
-			    int numOfNodes, bool complete)
+BasicGraphs::generate_wheel(GraphDescription * desc, qreal width,
+			    qreal height, int numOfNodes, bool complete)
 {
     if (numOfNodes <= 0)
 	return;
 
-    item->nodes.cycle = create_cycle(item, width,height, numOfNodes - 1);
-    Node * node = new Node();
-    node->setPos(0, 0);
-    item->nodes.center = node;
-    node->setParentItem(item);
+    QVector<int> cycle = create_cycle(desc, width, height, numOfNodes - 1);
+    int center = desc->addNode(0, 0, GraphDescription::Center);
 
     if (! complete)
 	return;
 
-    for (int i = 0; i < item->nodes.cycle.count(); i++)
+    for (int i = 0; i < cycle.count(); i++)
     {
-	Edge * edge = new Edge(node, item->nodes.cycle.at(i));
-	edge->setParentItem(item);
-	edge = new Edge(item->nodes.cycle.at(i),
-			item->nodes.cycle.at((i + 1)
-					     % item->nodes.cycle.count()));
-	edge->setParentItem(item);
+	desc->addEdge(center, cycle.at(i));
+	desc->addEdge(cycle.at(i), cycle.at((i + 1) % cycle.count()));
     }
 }
 
 
 void
-BasicGraphs::generate_bipartite(Graph * item, int topNodes, int bottomNodes,
-				qreal height, qreal width, bool complete)
+BasicGraphs::generate_bipartite(GraphDescription * desc, int topNodes,
+				int bottomNodes, qreal height, qreal width,
+				bool complete)
 {
     /*
      * Calculates the space between each of the nodes within
@@ -104,464 +152,312 @@ BasicGraphs::generate_bipartite(Graph * item, int topNodes, int bottomNodes,
 	: width / -2. + topSpacing / 2.;
     qreal y = height / -2.;
 
-    for (int i = 0; i < topNodes; i++)
-    {
-        Node * node = new Node();
-        node->setPos(x, y);
-        item->nodes.bipartite_top.append(node);
-        node->setParentItem(item);
-        x += topSpacing;
-    }
+    int firstTop = desc->addNodes(topNodes, GraphDescription::BipartiteTop);
+    row_positions(desc->positions.data() + firstTop, topNodes,
+		  x, topSpacing, y);
 
     x = topNodes <= bottomNodes ? width / -2.
 	: width / -2. + bottomSpacing / 2.;
     y = height / 2.;
-    for (int i = 0; i < bottomNodes; i++)
-    {
-        Node * node = new Node();
-        node->setPos(x, y);
-        item->nodes.bipartite_bottom.append(node);
-        node->setParentItem(item);
-	x += bottomSpacing;
-    }
+    int firstBottom = desc->addNodes(bottomNodes,
+				     GraphDescription::BipartiteBottom);
+    row_positions(desc->positions.data() + firstBottom, bottomNodes,
+		  x, bottomSpacing, y);
 
     if (! complete)
 	return;
 
+    if ((qint64)topNodes * bottomNodes > IMPLICIT_EDGE_THRESHOLD)
+    {
+	desc->addImplicitEdges(GraphDescription::Across, firstTop, topNodes,
+			       firstBottom, bottomNodes);
+	return;
+    }
+
     for (int i = 0; i < topNodes; i++)
 	for (int j = 0; j < bottomNodes; j++)
-	{
-	    Edge * edge = new Edge(item->nodes.bipartite_top.at(i),
-				   item->nodes.bipartite_bottom.at(j));
-	    edge->setParentItem(item);
-	}
+	    desc->addEdge(firstTop + i, firstBottom + j);
 }
 
 
 void
-BasicGraphs::generate_cycle(Graph * item, qreal width, qreal height,
-			    int numOfNodes, bool complete)
+BasicGraphs::generate_cycle(GraphDescription * desc, qreal width,
+			    qreal height, int numOfNodes, bool complete)
 {
-    item->nodes.cycle = create_cycle(item, width, height, numOfNodes);
+    QVector<int> cycle = create_cycle(desc, width, height, numOfNodes);
 
     if (! complete)
 	return;
 
-    for (int i = 0; i < item->nodes.cycle.count(); i++)
-    {
-	Edge * edge = new Edge(item->nodes.cycle.at(i),
-			       item->nodes.cycle.at((i + 1)
-						 % item->nodes.cycle.count()));
-	edge->setParentItem(item);
-    }
+    for (int i = 0; i < cycle.count(); i++)
+	desc->addEdge(cycle.at(i), cycle.at((i + 1) % cycle.count()));
 }
 
 
 void
-BasicGraphs::generate_star(Graph * item, qreal width, qreal height,
-			   int numOfNodes, bool complete)
+BasicGraphs::generate_star(GraphDescription * desc, qreal width,
+			   qreal height, int numOfNodes, bool complete)
 {
     if (numOfNodes <= 0)
 	return;
 
-    item->nodes.cycle = create_cycle(item, width, height, numOfNodes - 1);
-    Node * node = new Node();
-    node->setPos(0, 0);
-    item->nodes.center = node;
-    node->setParentItem(item);
+    QVector<int> cycle = create_cycle(desc, width, height, numOfNodes - 1);
+    int center = desc->addNode(0, 0, GraphDescription::Center);
 
     if (! complete)
 	return;
 
-    for (int i = 0; i < item->nodes.cycle.count(); i++)
-    {
-	Edge * edge = new Edge(node, item->nodes.cycle.at(i));
-	edge->setParentItem(item);
-    }
+    for (int i = 0; i < cycle.count(); i++)
+	desc->addEdge(center, cycle.at(i));
 }
 
 
 void
-BasicGraphs::generate_complete(Graph * item, qreal width, qreal height,
-			       int numOfNodes, bool complete)
+BasicGraphs::generate_complete(GraphDescription * desc, qreal width,
+			       qreal height, int numOfNodes, bool complete)
 {
-    item->nodes.cycle = create_cycle(item, width, height, numOfNodes);
+    QVector<int> cycle = create_cycle(desc, width, height, numOfNodes);
     if (!complete)
 	return;
 
-    for (int i = 0; i < item->nodes.cycle.count(); i++)
-	for (int j = i + 1; j < item->nodes.cycle.count(); j++)
-	{
-	    Edge * edge = new Edge(item->nodes.cycle.at(i),
-				   item->nodes.cycle.at(j));
-	    edge->setParentItem(item);
-	}
+    if ((qint64)cycle.count() * (cycle.count() - 1) / 2
+	> IMPLICIT_EDGE_THRESHOLD)
+    {
+	desc->addImplicitEdges(GraphDescription::AllPairs, cycle.first(),
+			       cycle.count());
+	return;
+    }
+
+    desc->edges.reserve(desc->edgeCount()
+			+ cycle.count() * (cycle.count() - 1) / 2);
+    for (int i = 0; i < cycle.count(); i++)
+	for (int j = i + 1; j < cycle.count(); j++)
+	    desc->addEdge(cycle.at(i), cycle.at(j));
 }
 
 
 void
-BasicGraphs::generate_petersen(Graph * item, qreal width,
+BasicGraphs::generate_petersen(GraphDescription * desc, qreal width,
 			       qreal height, int numOfNodes,
 			       int starSkip, bool complete)
 {
-    item->nodes.double_cycle.append(create_cycle(item, width, height,
-						 numOfNodes));
-    item->nodes.double_cycle.append(create_cycle(item, width / 2, height / 2,
-						 numOfNodes));
+    QVector<int> outer = create_cycle(desc, width, height, numOfNodes, 0,
+				      GraphDescription::DoubleCycle, 0);
+    QVector<int> inner = create_cycle(desc, width / 2, height / 2,
+				      numOfNodes, 0,
+				      GraphDescription::DoubleCycle, 1);
     if (! complete)
 	return;
 
     for (int i = 0; i < numOfNodes; i++)
     {
-	Edge * edge = new Edge(item->nodes.double_cycle.at(0).at(i),
-			       item->nodes.double_cycle.at(0).at((i + 1)
-				 % item->nodes.double_cycle.at(0).count()));
-	edge->setParentItem(item);
+	desc->addEdge(outer.at(i), outer.at((i + 1) % outer.count()));
 
 	if (starSkip % numOfNodes != 0)
-	{
-	    edge = new Edge(item->nodes.double_cycle.at(1).at(i),
-			    item->nodes.double_cycle.at(1).at((i + starSkip)
-							      % numOfNodes));
-	    edge->setParentItem(item);
-	}
-	Edge * connectEdge = new Edge(item->nodes.double_cycle.at(0).at(i),
-				      item->nodes.double_cycle.at(1).at(i));
-	connectEdge->setParentItem(item);
+	    desc->addEdge(inner.at(i), inner.at((i + starSkip) % numOfNodes));
+	desc->addEdge(outer.at(i), inner.at(i));
     }
 }
 
 
 void
-BasicGraphs::generate_gear(Graph *item, qreal width, qreal height,
-			   int numOfNodes, bool complete)
+BasicGraphs::generate_gear(GraphDescription * desc, qreal width,
+			   qreal height, int numOfNodes, bool complete)
 {
-    qreal x1, y1,x2,y2;
+    QVector<int> cycle;
 
     if (numOfNodes % 2 != 0)
-        item->nodes.cycle = create_cycle(item, width, height, numOfNodes - 1);
+        cycle = create_cycle(desc, width, height, numOfNodes - 1);
     else
-        item->nodes.cycle = create_cycle(item, width, height, numOfNodes);
+        cycle = create_cycle(desc, width, height, numOfNodes);
 
-    for (int i = 0; i < item->nodes.cycle.count(); i++)
+    for (int i = 0; i < cycle.count(); i++)
     {
         if (i % 2 == 1)
         {
-            x1 = item->nodes.cycle.at((i - 1) % item->nodes.cycle.count())->x();
-            y1 = item->nodes.cycle.at((i - 1) % item->nodes.cycle.count())->y();
-            x2 = item->nodes.cycle.at((i + 1) % item->nodes.cycle.count())->x();
-            y2 = item->nodes.cycle.at((i + 1) % item->nodes.cycle.count())->y();
+            QPointF p1 = desc->positions.at(cycle.at((i - 1) % cycle.count()));
+            QPointF p2 = desc->positions.at(cycle.at((i + 1) % cycle.count()));
 
-            item->nodes.cycle.at(i)->setPos((x1 + x2) / 2, (y1 + y2) / 2);
+            desc->positions[cycle.at(i)] = (p1 + p2) / 2;
         }
     }
 
-    Node * center = new Node();
+    int center = -1;
     if (numOfNodes % 2 == 1)
-    {
-        center->setPos(0, 0);
-        center->setParentItem(item);
-        item->nodes.center = center;
-    }
+        center = desc->addNode(0, 0, GraphDescription::Center);
     if (! complete)
 	return;
 
-    for (int i = 0; i < item->nodes.cycle.count(); i++)
+    for (int i = 0; i < cycle.count(); i++)
     {
 	if (i % 2 == 0 && numOfNodes % 2 == 1)
-	{
-	    Edge * edge = new Edge(center, item->nodes.cycle.at(i));
-	    edge->setParentItem(item);
-	}
-	Edge * edge = new Edge(item->nodes.cycle.at(i),
-			       item->nodes.cycle.at((i + 1)
-					    % item->nodes.cycle.count()));
-	edge->setParentItem(item);
+	    desc->addEdge(center, cycle.at(i));
+	desc->addEdge(cycle.at(i), cycle.at((i + 1) % cycle.count()));
     }
 }
 
 
 void
-BasicGraphs::generate_helm(Graph * item, qreal width, qreal height,
-			   int numOfNodes, bool complete)
+BasicGraphs::generate_helm(GraphDescription * desc, qreal width,
+			   qreal height, int numOfNodes, bool complete)
 {
-    item->nodes.double_cycle.append(create_cycle(item, width, height,
-						 numOfNodes));
-    item->nodes.double_cycle.append(create_cycle(item, width * 0.65,
-                                                 height * 0.65, numOfNodes));
+    QVector<int> outer = create_cycle(desc, width, height, numOfNodes, 0,
+				      GraphDescription::DoubleCycle, 0);
+    QVector<int> inner = create_cycle(desc, width * 0.65, height * 0.65,
+				      numOfNodes, 0,
+				      GraphDescription::DoubleCycle, 1);
 
-    Node * node = new Node();
-    node->setPos(0,0);
-    node->setParentItem(item);
-    item->nodes.center = node;
+    int center = desc->addNode(0, 0, GraphDescription::Center);
 
     if (! complete)
 	return;
 
-    for (int i = 0; i < item->nodes.double_cycle.at(0).count(); i++)
+    for (int i = 0; i < outer.count(); i++)
     {
-	Edge * edge = new Edge(item->nodes.double_cycle.at(1).at(i),
-			       item->nodes.center);
-	edge->setParentItem(item);
-	edge = new Edge(item->nodes.double_cycle.at(1).at(i),
-			item->nodes.double_cycle.at(0).at(i));
-	edge->setParentItem(item);
-	edge = new Edge(item->nodes.double_cycle.at(1).at(i),
-			item->nodes.double_cycle.at(1).at((i + 1)
-				  % item->nodes.double_cycle.at(1).count()));
-	edge->setParentItem(item);
+	desc->addEdge(inner.at(i), center);
+	desc->addEdge(inner.at(i), outer.at(i));
+	desc->addEdge(inner.at(i), inner.at((i + 1) % inner.count()));
     }
 }
 
 
 void
-BasicGraphs::generate_crown(Graph * item, qreal width, qreal height,
-			    int numOfNodes, bool complete)
+BasicGraphs::generate_crown(GraphDescription * desc, qreal width,
+			    qreal height, int numOfNodes, bool complete)
 {
-    item->nodes.double_cycle.append(create_cycle(item, width, height,
-                                                 numOfNodes));
-    item->nodes.double_cycle.append(create_cycle(item, width * 0.65,
-						 height * 0.65, numOfNodes));
+    QVector<int> outer = create_cycle(desc, width, height, numOfNodes, 0,
+				      GraphDescription::DoubleCycle, 0);
+    QVector<int> inner = create_cycle(desc, width * 0.65, height * 0.65,
+				      numOfNodes, 0,
+				      GraphDescription::DoubleCycle, 1);
     if (! complete)
 	return;
 
-    for (int i = 0; i < item->nodes.double_cycle.at(1).count(); i++)
+    for (int i = 0; i < inner.count(); i++)
     {
-	Edge * edge = new Edge(item->nodes.double_cycle.at(0).at(i),
-			       item->nodes.double_cycle.at(1).at(i));
-	edge->setParentItem(item);
-	edge = new Edge(item->nodes.double_cycle.at(1).at(i),
-			item->nodes.double_cycle.at(1).at((i + 1)
-				  % item->nodes.double_cycle.at(1).count()));
-	edge->setParentItem(item);
+	desc->addEdge(outer.at(i), inner.at(i));
+	desc->addEdge(inner.at(i), inner.at((i + 1) % inner.count()));
     }
 }
 
 
 void
-BasicGraphs::generate_grid(Graph * item, qreal height, qreal width,
-			   int topNodes, int bottomNodes, bool complete)
+BasicGraphs::generate_grid(GraphDescription * desc, qreal height,
+			   qreal width, int topNodes, int bottomNodes,
+			   bool complete)
 {
-    qreal xSpace = width / (topNodes - 1);
-    qreal ySpace = height / (bottomNodes - 1);
-
-    qreal  x = 0;
-    qreal  y = 0;
-
-    for (int i = 0; i < bottomNodes; i++)
-    {
-        for (int j = 0; j < topNodes; j++)
-        {
-            Node * node = new Node();
-            qreal xcoord, ycoord;
-
-            xcoord = topNodes > 1 ? x - width / 2. : 0;
-            ycoord = bottomNodes > 1 ? y - height / 2. : 0;
-
-            node->setPos(xcoord, ycoord);
-	    node->setParentItem(item);
-            item->nodes.grid.append(node);
-            x += xSpace;
-        }
+    if (topNodes <= 0 || bottomNodes <= 0)
+	return;
 
-        x = 0;
-        y += ySpace;
-
-    }
+    int count = topNodes * bottomNodes;
+    int first = desc->addNodes(count, GraphDescription::Grid);
+    lattice_positions(desc->positions.data() + first,
+		      topNodes, bottomNodes, width, height);
 
     if (! complete)
 	return;
 
-    for (int i = 0; i < item->nodes.grid.count(); i++)
+    for (int i = 0; i < count; i++)
     {
 	if ((i + 1) % topNodes != 0)
-	{
-	    Edge * edge = new Edge(item->nodes.grid.at(i),
-				   item->nodes.grid.at(i + 1));
-	    edge->setParentItem(item);
-	}
-	if (i + topNodes < item->nodes.grid.count())
-	{
-	    Edge * edge = new Edge(item->nodes.grid.at(i),
-				   item->nodes.grid.at(i + topNodes));
-	    edge->setParentItem(item);
-	}
+	    desc->addEdge(first + i, first + i + 1);
+	if (i + topNodes < count)
+	    desc->addEdge(first + i, first + i + topNodes);
     }
 }
 
 
 void
-BasicGraphs::generate_antiprism(Graph * item, qreal width,
+BasicGraphs::generate_antiprism(GraphDescription * desc, qreal width,
 				qreal height, int numOfNodes,
 				bool complete)
 {
-    item->nodes.cycle = create_cycle(item, width, height, numOfNodes);
+    QVector<int> cycle = create_cycle(desc, width, height, numOfNodes);
 
-    qreal spacing =  (2 * PI) / numOfNodes;
-    qreal angle = 0;
-    qreal y = (height / 4) * qCos(angle) * -1;
-    qreal x = (width / 4) * qSin(angle);
+    // The odd nodes go on an inner ring, a quarter the size.
+    QVector<QPointF> inner(cycle.count());
+    ring_positions(inner.data(), cycle.count(), width / 4, height / 4);
 
-    for (int i = 0; i < item->nodes.cycle.count(); i++)
+    for (int i = 0; i < cycle.count(); i++)
     {
-        if (i % 2 == 0)
-        {
-            if (complete)
-            {
-                Edge * edge = new Edge(item->nodes.cycle.at(i),
-                                       item->nodes.cycle.at((i + 2)
-						% item->nodes.cycle.count()));
-                edge->setParentItem(item);
-            }
-        }
-        else
-        {
-            if (complete)
-            {
-                Edge * edge = new Edge(item->nodes.cycle.at(i),
-                                       item->nodes.cycle.at((i+2)
-						% item->nodes.cycle.count()));
-                edge->setParentItem(item);
-            }
-            item->nodes.cycle.at(i)->setPos(x, y);
-        }
         if (complete)
-        {
-            Edge * edge = new Edge(item->nodes.cycle.at(i),
-                                   item->nodes.cycle.at((i + 1)
-						% item->nodes.cycle.count()));
-            edge->setParentItem(item);
-        }
-        angle += spacing;
-        y = (height / 4) * qCos(angle) * -1;
-        x = (width / 4) * qSin(angle);
+            desc->addEdge(cycle.at(i), cycle.at((i + 2) % cycle.count()));
+        if (i % 2 == 1)
+            desc->positions[cycle.at(i)] = inner.at(i);
+        if (complete)
+            desc->addEdge(cycle.at(i), cycle.at((i + 1) % cycle.count()));
     }
 }
 
 
 void
-BasicGraphs::generate_path(Graph * item, qreal width, int numOfNodes,
-			   bool complete)
+BasicGraphs::generate_path(GraphDescription * desc, qreal width,
+			   int numOfNodes, bool complete)
 {
     if (numOfNodes < 1)
 	return;
 
     if (numOfNodes == 1)
     {
-        Node * node = new Node();
-        node->setPos(0,0);
-        node->setParentItem(item);
+        desc->addNode(0, 0);
 	return;
     }
 
-    qreal x = 0;
     qreal spacing = width / (numOfNodes -1);
-    for (int i = 0; i < numOfNodes; i++)
-    {
-	Node * node = new Node();
-	node->setPos(x - width / 2., 0);
-	node->setParentItem(item);
-	item->nodes.path.append(node);
-	x += spacing;
-    }
+    int first = desc->addNodes(numOfNodes, GraphDescription::Path);
+    row_positions(desc->positions.data() + first, numOfNodes,
+		  width / -2., spacing, 0);
 
     if (! complete)
 	return;
 
     for (int i = 0; i < numOfNodes - 1; i++)
-    {
-	Edge * edge = new Edge(item->nodes.path.at(i),
-			       item->nodes.path.at((i + 1)
-						   % item->nodes.path.count()));
-	edge->setParentItem(item);
-    }
-
+	desc->addEdge(first + i, first + i + 1);
 }
 
 
 void
-BasicGraphs::generate_prism(Graph * item, qreal width, qreal height,
-			    int numOfNodes, bool complete)
+BasicGraphs::generate_prism(GraphDescription * desc, qreal width,
+			    qreal height, int numOfNodes, bool complete)
 {
-    item->nodes.double_cycle.append(create_cycle(item, width, height,
-						 numOfNodes));
-    item->nodes.double_cycle.append(create_cycle(item, width / 2., height / 2.,
-                                                 numOfNodes));
+    QVector<int> outer = create_cycle(desc, width, height, numOfNodes, 0,
+				      GraphDescription::DoubleCycle, 0);
+    QVector<int> inner = create_cycle(desc, width / 2., height / 2.,
+				      numOfNodes, 0,
+				      GraphDescription::DoubleCycle, 1);
 
     if (! complete)
 	return;
 
-    for (int i = 0; i < item->nodes.double_cycle.at(0).count(); i++)
-    {
-	Edge * edge = new Edge(item->nodes.double_cycle.at(0).at(i),
-			       item->nodes.double_cycle.at(0).at((i + 1)
-				    % item->nodes.double_cycle.at(0).count()));
-	edge->setParentItem(item);
-
-	edge = new Edge(item->nodes.double_cycle.at(0).at(i),
-			item->nodes.double_cycle.at(1).at(i));
-	edge->setParentItem(item);
-    }
-    for (int i = 0; i < item->nodes.double_cycle.at(1).count(); i++)
+    for (int i = 0; i < outer.count(); i++)
     {
-	Edge * edge = new Edge(item->nodes.double_cycle.at(1).at(i),
-			       item->nodes.double_cycle.at(1).at((i + 1)
-				    % item->nodes.double_cycle.at(1).count()));
-	edge->setParentItem(item);
+	desc->addEdge(outer.at(i), outer.at((i + 1) % outer.count()));
+	desc->addEdge(outer.at(i), inner.at(i));
     }
+    for (int i = 0; i < inner.count(); i++)
+	desc->addEdge(inner.at(i), inner.at((i + 1) % inner.count()));
 }
 
 
 void
-BasicGraphs::generate_balanced_binary_tree(Graph * item,
+BasicGraphs::generate_balanced_binary_tree(GraphDescription * desc,
 					   qreal height, qreal width,
 					   int numOfNodes, bool complete)
 {
-    item->nodes.binaryHeap.resize(numOfNodes);
-    qreal treeDepth = floor(log2(numOfNodes));
-    recursive_binary_tree(item, 0, 0, height, width, treeDepth);
-
-    if (verbose)
-    {
-        Node * node00 = new Node();
-        node00->setPos(0, 0);
-        node00->setParentItem(item);
-        Node * nodew0 = new Node();
-        nodew0->setPos(width, 0);
-        Node * nodewh = new Node();
-        nodewh->setPos(width, height);
-        Node * node0h = new Node();
-        node0h->setPos(0, height);
-    }
-
-    if (! complete)
-	return;
-
-    for (int i = 0; i < item->nodes.binaryHeap.count() / 2; i++)
-    {
-	if (2 * i + 1 < item->nodes.binaryHeap.count())
-	{
-	    Edge * edge = new Edge(item->nodes.binaryHeap.at(i),
-				   item->nodes.binaryHeap.at(2 * i + 1));
-	    edge->setParentItem(item);
-	}
-	if (2 * i + 2 < item->nodes.binaryHeap.count())
-	{
-	    Edge * edge = new Edge(item->nodes.binaryHeap.at(i),
-				   item->nodes.binaryHeap.at(2 * i + 2));
-	    edge->setParentItem(item);
-	}
-    }
+    generate_balanced_tree(desc, height, width, numOfNodes, 2, complete);
 }
 
 
 
 /*
- * Name:	BasicGraphs::recursive_binary_tree
- * Purpose:	Lay out the nodes of a binary tree (really a heap).
- * Arguments:	
+ * Name:	BasicGraphs::generate_balanced_tree
+ * Purpose:	Lay out the nodes of a balanced k-ary tree (really a
+ *		heap), and join them.
+ * Arguments:	the description, the height and width of the tree,
+ *		the number of nodes, the number of children of each
+ *		node (k, at least 2) and whether to add the edges.
  * Outputs:	Nothing.
- * Modifies:	item.
+ * Modifies:	desc.
  * Returns:	Nothing.
  * Assumptions:	Args are meaningful.
  * Bugs:	
@@ -571,86 +467,417 @@ BasicGraphs::generate_balanced_binary_tree(Graph * item,
  *		- The leaves on a non-full tree are in the same
  *		  positions they would be if the bottom row was full.
  *		- The leaves of a full tree are evenly distributed
- *		  from 0 (left) to width (right).  This means the
- *		  inter-leaf spacing is width(N - 1) where N is the
- *		  number of leaves in the full tree.
- *		- Since the X coord of the parents of the leaves are
- *		  half way between two leaves, we actually use a
- *		  spacing value of width/2*(N-1).
+ *		  from 0 (left) to width (right).
+ *		- Every other node is centred over the leaves its
+ *		  subtree would have if the tree was full.
+ *		For k = 2 this is the layout the old recursive
+ *		binary tree code produced.
+ *		The tree is built a level at a time (see
+ *		tree_level()), and wide levels are split between
+ *		threads.  The nodes are still numbered in preorder,
+ *		as they were when the tree was laid out recursively,
+ *		so the labels don't change.
  */
 
 void
-BasicGraphs::recursive_binary_tree(Graph * item, int depth, int index,
-				   qreal height, qreal width, int treeDepth)
+BasicGraphs::generate_balanced_tree(GraphDescription * desc,
+				    qreal height, qreal width,
+				    int numOfNodes, int arity, bool complete)
 {
-    if (index >= item->nodes.binaryHeap.size())
+    if (numOfNodes <= 0)
 	return;
 
-    int leftChildIndex = index * 2 + 1;
-    int rightChildIndex = index * 2 + 2;
-    qreal x;
-    qreal y;
+    Tree_Layout tree;
+    tree.numOfNodes = numOfNodes;
+    tree.arity = qMax(2, arity);
+    tree.height = height;
+    tree.width = width;
 
-    if (treeDepth == 0)
-	y = height / 2;
-    else
-	y = depth * height / treeDepth;
+    // levelStart[L] is the heap index of the first node on level L.
+    qint64 start = 0;
+    while (start < numOfNodes)
+    {
+	tree.levelStart.append((int)start);
+	start = start * tree.arity + 1;
+    }
+    tree.levelStart.append(numOfNodes);
+    tree.depth = tree.levelStart.count() - 2;
+    tree.leaves = qPow(tree.arity, tree.depth);
+
+    tree.first = desc->addNodes(numOfNodes, GraphDescription::Heap);
+    tree.positions = desc->positions.data() + tree.first;
+    tree.groups = desc->groups.data() + tree.first;
+    tree.heap.resize(numOfNodes);
+    tree.rank.resize(numOfNodes);
+
+    // The root.
+    tree.rank[0] = 0;
+    tree.heap[0] = tree.first;
+    tree.positions[0] = tree_position(tree, 0, 0);
+    tree.groups[0] = 0;
+
+    // Each level is placed by its parents on the level above.
+    for (int level = 0; level < tree.depth; level++)
+    {
+	int begin = tree.levelStart.at(level);
+	int end = tree.levelStart.at(level + 1);
+	int levelWidth = tree.levelStart.at(level + 2) - end;
+
+	if (levelWidth < TREE_PARALLEL_LEVEL_SIZE)
+	{
+	    tree_level(tree, level, begin, end);
+	    continue;
+	}
+
+	QVector<QPair<int, int> > chunks;
+	int parentsPerChunk = qMax(1, TREE_PARALLEL_LEVEL_SIZE / tree.arity);
+	for (int p = begin; p < end; p += parentsPerChunk)
+	    chunks.append(qMakePair(p, qMin(end, p + parentsPerChunk)));
+	QtConcurrent::blockingMap(chunks, [&](QPair<int, int> & chunk)
+	{
+	    tree_level(tree, level, chunk.first, chunk.second);
+	});
+    }
+
+    // Mark the origin.
+    if (verbose)
+        desc->addNode(0, 0);
+
+    if (! complete)
+	return;
+
+    desc->edges.reserve(desc->edgeCount() + numOfNodes - 1);
+    for (int i = 1; i < numOfNodes; i++)
+	desc->addEdge(tree.heap.at((i - 1) / tree.arity), tree.heap.at(i));
+}
+
+
+
+/*
+ * Name:	BasicGraphs::tree_position
+ * Purpose:	Works out where a node of a balanced tree goes.
+ * Arguments:	the tree, the node's level and its index on the level
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	The position, relative to the centre of the tree.
+ * Assumptions:	none
+ * Bugs:	
+ * Notes:	The node is centred over the leaves [index * span,
+ *		(index + 1) * span) of the full tree, where span is
+ *		k^(depth - level); the leaves are width / (leaves - 1)
+ *		apart.
+ */
+
+QPointF
+BasicGraphs::tree_position(const Tree_Layout & tree, int level, int index)
+{
+    qreal x, y;
 
-    if (depth == 0)
-	x = width / 2;
+    if (tree.depth == 0)
+    {
+	x = tree.width / 2;
+	y = tree.height / 2;
+    }
     else
     {
-	int spaceFactor = 1 << (treeDepth - depth + 1);
-	int spaceOffset = 0;
-	if (treeDepth != depth)
-	    spaceOffset = (1 << (treeDepth - depth)) - 1;
-
-	int startIndexThisLevel = (1 << depth) - 1;
-	x = ((index - startIndexThisLevel) * spaceFactor + spaceOffset)
-	    * (qreal)width / (2 * ((1 << treeDepth) - 1));
+	qreal span = qPow(tree.arity, tree.depth - level);
+	x = (index * span + (span - 1) / 2) * tree.width / (tree.leaves - 1);
+	y = level * tree.height / tree.depth;
     }
-    if (verbose)
-        qDebug() << "Node" << index << "at depth" << depth
-                 << "is at (" << x << "," << y << ") where treeDepth is"
-                 << treeDepth;
-
-    Node * node = new Node();
-    node->setPos(x - width / 2., y - height / 2.);
-    item->nodes.binaryHeap[index] = node;
-    node->setParentItem(item);
-
-    if (leftChildIndex < item->nodes.binaryHeap.size())
-        recursive_binary_tree(item, depth + 1, leftChildIndex, height,
-			      width, treeDepth);
-    if (rightChildIndex < item->nodes.binaryHeap.size())
-        recursive_binary_tree(item, depth + 1, rightChildIndex, height,
-			      width, treeDepth);
-    return;
+
+    return QPointF(x - tree.width / 2., y - tree.height / 2.);
 }
 
 
-QList<Node *>
-BasicGraphs::create_cycle(Graph * item, qreal width, qreal height,
-			  int numOfNodes, qreal radians)
+
+/*
+ * Name:	BasicGraphs::tree_level
+ * Purpose:	Places the children of some of the nodes on one level
+ *		of a balanced tree.
+ * Arguments:	the tree, the parents' level, and the heap indices
+ *		[begin, end) of the parents
+ * Outputs:	Nothing.
+ * Modifies:	the tree's positions, groups, heap and rank of the
+ *		children.
+ * Returns:	Nothing.
+ * Assumptions:	The parents have been placed.
+ * Bugs:	
+ * Notes:	Only writes to the children of these parents, so
+ *		different ranges of one level may be done on different
+ *		threads.
+ *		The preorder number (rank) of a child is its parent's
+ *		plus one plus the sizes of the subtrees of its older
+ *		siblings.  A subtree's size is that of a full tree
+ *		with depth - level levels, plus however many of its
+ *		bottom-level leaves exist.
+ */
+
+void
+BasicGraphs::tree_level(Tree_Layout & tree, int level, int begin, int end)
 {
-    QList<Node *> nodes;
+    int childLevel = level + 1;
+    int childStart = tree.levelStart.at(childLevel);
+    qint64 lastLevelCount = tree.numOfNodes - tree.levelStart.at(tree.depth);
+    qint64 span = (qint64)qPow(tree.arity, tree.depth - childLevel);
+    qint64 fullSize = (span - 1) / (tree.arity - 1);
 
-    qreal spacing =  (2 * PI) / numOfNodes;
-    for (int i = 0; i < numOfNodes; i++)
+    for (int parent = begin; parent < end; parent++)
     {
-        qreal y =  height * -qCos(radians);
-        qreal x = width * qSin(radians);
-        Node * node = new Node();
-        node->setPos(x, y);
-        nodes.append(node);
-        node->setParentItem(item);
-        radians += spacing;
+	int rank = tree.rank.at(parent) + 1;
+
+	for (int c = 1; c <= tree.arity; c++)
+	{
+	    int child = parent * tree.arity + c;
+	    if (child >= tree.numOfNodes)
+		return;
+
+	    int index = child - childStart;
+	    tree.rank[child] = rank;
+	    tree.heap[child] = tree.first + rank;
+	    tree.positions[rank] = tree_position(tree, childLevel, index);
+	    tree.groups[rank] = child;
+
+	    rank += (int)(fullSize + qBound(Q_INT64_C(0),
+					    lastLevelCount - index * span,
+					    span));
+	}
     }
+}
+
+
+/*
+ * Name:	BasicGraphs::create_cycle
+ * Purpose:	Adds the nodes of a cycle, placed on an ellipse.
+ * Arguments:	the description, the horizontal and vertical radii of
+ *		the ellipse, the number of nodes, the angle of the
+ *		first node (0 is the top), and the role and group
+ *		given to the nodes.
+ * Outputs:	Nothing.
+ * Modifies:	desc.
+ * Returns:	The indices of the new nodes, in order.
+ * Assumptions:	none
+ * Bugs:	
+ * Notes:	No edges are added.  The positions are computed by
+ *		ring_positions().
+ */
+
+QVector<int>
+BasicGraphs::create_cycle(GraphDescription * desc, qreal width,
+			  qreal height, int numOfNodes, qreal radians,
+			  int role, int group)
+{
+    QVector<int> nodes;
+
+    if (numOfNodes <= 0)
+	return nodes;
+
+    int first = desc->addNodes(numOfNodes, role, group);
+    ring_positions(desc->positions.data() + first, numOfNodes,
+		   width, height, radians);
+
+    nodes.resize(numOfNodes);
+    for (int i = 0; i < numOfNodes; i++)
+	nodes[i] = first + i;
 
     return nodes;
 }
 
 
+/*
+ * Name:	BasicGraphs::generate
+ * Purpose:	Describes a graph of one of the basic types.
+ * Arguments:	the description to add to, the Graph_Type, the two
+ *		node counts from the UI, the height and width (in
+ *		pixels) and whether to add the edges.
+ * Outputs:	Nothing.
+ * Modifies:	desc.
+ * Returns:	Nothing.
+ * Assumptions:	none
+ * Bugs:	
+ * Notes:	Creates no QGraphicsItems, so may be called from any
+ *		thread; see GraphDescription::materialize().
+ */
+
+void
+BasicGraphs::generate(GraphDescription * desc, int graphType,
+		      int topNodes, int bottomNodes,
+		      qreal height, qreal width, bool complete)
+{
+    switch (graphType) {
+    case Bipartite:
+        generate_bipartite(desc, topNodes, bottomNodes, height, width,
+			   complete);
+        break;
+
+    case Complete:
+        generate_complete(desc, width / 2, height / 2, topNodes, complete);
+        break;
+
+    case Cycle:
+        generate_cycle(desc, width / 2, height / 2, topNodes, complete);
+        break;
+
+    case Star:
+        generate_star(desc, width / 2, height / 2, topNodes, complete);
+        break;
+
+    case Wheel:
+        generate_wheel(desc, width / 2, height / 2, topNodes, complete);
+        break;
+
+    case Petersen:
+        generate_petersen(desc, width / 2, height / 2,
+			  topNodes, bottomNodes, complete);
+        break;
+
+    case BBTree:
+        generate_balanced_binary_tree(desc, height, width, topNodes,
+				      complete);
+        break;
+
+    case KTree:
+        generate_balanced_tree(desc, height, width, topNodes, bottomNodes,
+			       complete);
+        break;
+
+    case Crown:
+        generate_crown(desc, width / 2, height / 2, topNodes, complete);
+        break;
+
+    case Windmill:
+        generate_dutch_windmill(desc, height, topNodes, bottomNodes,
+				complete);
+        break;
+
+    case Gear:
+        generate_gear(desc, width / 2, height / 2, topNodes, complete);
+        break;
+
+    case Grid:
+        generate_grid(desc, height, width, topNodes, bottomNodes, complete);
+        break;
+
+    case Helm:
+        generate_helm(desc, width / 2, height / 2, topNodes, complete);
+        break;
+
+    case Path:
+        generate_path(desc, width, topNodes, complete);
+        break;
+
+    case Prism:
+        generate_prism(desc, width / 2, height / 2, topNodes, complete);
+        break;
+
+    case Antiprism:
+        generate_antiprism(desc, width / 2, height / 2, topNodes, complete);
+        break;
+
+    case RandomBA:
+        generate_random_ba(desc, width / 2, height / 2, topNodes,
+			   bottomNodes, complete);
+        break;
+
+    case RandomER:
+        generate_random_er(desc, width / 2, height / 2, topNodes,
+			   bottomNodes, complete);
+        break;
+
+    case RandomGeometric:
+        generate_random_geometric(desc, height, width, topNodes,
+				  bottomNodes, complete);
+        break;
+
+    case RandomRegular:
+        generate_random_regular(desc, width / 2, height / 2, topNodes,
+				bottomNodes, complete);
+        break;
+
+    default:
+        break;
+    }
+}
+
+
+/*
+ * Name:	BasicGraphs::estimate_size
+ * Purpose:	Estimates how big a basic graph will be.
+ * Arguments:	the Graph_Type, the two node counts from the UI and
+ *		whether the edges will be added.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	Roughly the number of nodes plus the number of edges.
+ * Assumptions:	none
+ * Bugs:	
+ * Notes:	Used to decide whether a graph is big enough to be
+ *		worth generating on another thread.  A set of implicit
+ *		edges counts as one item.
+ */
+
+qint64
+BasicGraphs::estimate_size(int graphType, int topNodes, int bottomNodes,
+			   bool complete)
+{
+    qint64 top = qMax(topNodes, 0);
+    qint64 bottom = qMax(bottomNodes, 0);
+    qint64 nodes, edges;
+
+    switch (graphType) {
+    case Bipartite:
+        nodes = top + bottom;
+        edges = top * bottom;
+        if (edges > IMPLICIT_EDGE_THRESHOLD)
+            edges = 1;
+        break;
+
+    case Complete:
+        nodes = top;
+        edges = top * (top - 1) / 2;
+        if (edges > IMPLICIT_EDGE_THRESHOLD)
+            edges = 1;
+        break;
+
+    case Grid:
+        nodes = top * bottom;
+        edges = 2 * nodes;
+        break;
+
+    case Windmill:
+        nodes = top * bottom;
+        edges = nodes + top;
+        break;
+
+    case RandomBA:
+        nodes = top;
+        edges = top * bottom;
+        break;
+
+    case BBTree:
+    case KTree:
+        nodes = top;
+        edges = top - 1;
+        break;
+
+    case RandomER:
+    case RandomGeometric:
+    case RandomRegular:
+        // bottomNodes is the (average) degree.
+        nodes = top;
+        edges = top * bottom / 2;
+        break;
+
+    default:
+        // Every other type has at most 3 cycles of topNodes nodes
+        // and 3 edges per node.
+        nodes = 3 * top;
+        edges = 3 * nodes;
+        break;
+    }
+
+    return complete ? nodes + edges : nodes;
+}
+
+
 QString
 BasicGraphs::getGraphName(int enumValue)
 {
@@ -660,7 +887,7 @@ BasicGraphs::getGraphName(int enumValue)
 
 /*
 * Function:	generate_dutch_windmill()
-* Paramters:	g: the graph
+* Paramters:	desc: the graph description
 *		height: the desired height of the graph (note that
 *		        many other functions get height / 2 as the
 *			corresponding parameter)
@@ -688,7 +915,7 @@ BasicGraphs::getGraphName(int enumValue)
 */
 
 void
-BasicGraphs::generate_dutch_windmill(Graph * g, qreal height,
+BasicGraphs::generate_dutch_windmill(GraphDescription * desc, qreal height,
 				     int blades, int bladeSize, bool complete)
 {
     qreal cycleHeight, cycleWidth;
@@ -706,9 +933,7 @@ BasicGraphs::generate_dutch_windmill(Graph * g, qreal height,
 	qDebug() << "bladeWidth * #verts / (#v -2) / Pi = "
 		 << bladeWidth * bladeSize / (bladeSize - 2) / PI;
     }
-    g->nodes.center = new Node();
-    g->nodes.center->setPos(0, 0);
-    g->nodes.center->setParentItem(g);
+    int center = desc->addNode(0, 0, GraphDescription::Center);
 
     // cycleHeight is the vertical "radius", not "diameter"
     cycleHeight = height / 4;
@@ -725,50 +950,404 @@ BasicGraphs::generate_dutch_windmill(Graph * g, qreal height,
 	qDebug() << "cycleHeight will be " << cycleHeight;
     }
 
-    QList <QList <Node *>> list_of_cycles = g->nodes.list_of_cycles;
+    // Every blade is the same cycle, with a single vertex at the
+    // bottom, only rotated; lay it out once.  The bottom vertex is
+    // left out, and its neighbours will eventually be joined to the
+    // center vertex.
+    QVector<QPointF> blade(qMax(bladeSize, 0));
+    ring_positions(blade.data(), bladeSize, cycleWidth, cycleHeight, PI);
 
     for (int i = 0; i < blades; i++)
     {
-	list_of_cycles.append(create_cycle(g, cycleWidth, cycleHeight,
-					   bladeSize, PI));
-
-	// Create a cycle with a single vertex at the bottom
-	// and then remove that vertex.  It's neighbours will
-	// eventually be joined to the g->node.center vertex.
-	QList <Node *> i_cycle = list_of_cycles.at(i);
-	i_cycle.at(0)->setParentItem(nullptr);
-	i_cycle.removeFirst();
+	const qreal c = qCos(angle);
+	const qreal s = qSin(angle);
+	QVector<int> i_cycle;
+	int first = desc->addNodes(qMax(bladeSize - 1, 0),
+				   GraphDescription::Blade, i);
 
-	for (int j = 0; j < i_cycle.count(); j++)
+	for (int j = 1; j < bladeSize; j++)
 	{
 	    // Translate the cycle up so that the center node is where
-	    // the deleted vertex should have been:
-	    i_cycle.at(j)->setY(i_cycle.at(j)->y() - cycleHeight);
+	    // the missing vertex should have been:
+	    qreal x = blade.at(j).x();
+	    qreal y = blade.at(j).y() - cycleHeight;
 
 	    // Now rotate the cycle around (0, 0):
-	    qreal x = i_cycle.at(j)->x();
-	    qreal y = i_cycle.at(j)->y();
+	    desc->positions[first + j - 1] = QPointF(x * c - y * s,
+						     x * s + y * c);
+	    i_cycle.append(first + j - 1);
+	}
+	angle += bladeSpacing;
 
-	    i_cycle.at(j)->setY(x * qSin(angle) + y * qCos(angle));
-	    i_cycle.at(j)->setX(x * qCos(angle) - y * qSin(angle));
-	    i_cycle.at(j)->setParentItem(g);
+	if (i_cycle.isEmpty() || ! complete)
+	    continue;
 
-	    if (complete && j != i_cycle.count() - 1)
-	    {
-		Edge * edge = new Edge(i_cycle.at(j),
-				       i_cycle.at((j + 1) % i_cycle.count()));
-		edge->setParentItem(g);
-	    }
+	for (int j = 0; j < i_cycle.count() - 1; j++)
+	    desc->addEdge(i_cycle.at(j), i_cycle.at(j + 1));
+	desc->addEdge(i_cycle.at(0), center);
+	desc->addEdge(i_cycle.at(i_cycle.count() - 1), center);
+    }
+}
+
+
+/*
+ * Name:	BasicGraphs::generate_random_er
+ * Purpose:	Describes an Erdos-Renyi random graph G(n, p).
+ * Arguments:	the description, the horizontal and vertical radii of
+ *		the ellipse the nodes are placed on, the number of
+ *		nodes, the average degree wanted and whether to add
+ *		the edges.
+ * Outputs:	Nothing.
+ * Modifies:	desc.
+ * Returns:	Nothing.
+ * Assumptions:	none
+ * Bugs:	
+ * Notes:	Each pair of nodes is joined with probability
+ *		p = degree / (n - 1).  Rather than trying every pair,
+ *		the number of pairs to skip before the next edge is
+ *		drawn from the geometric distribution (Batagelj and
+ *		Brandes, "Efficient generation of large random
+ *		networks", 2005), so the time is proportional to the
+ *		number of nodes plus edges.
+ */
+
+void
+BasicGraphs::generate_random_er(GraphDescription * desc, qreal width,
+				qreal height, int numOfNodes, int degree,
+				bool complete)
+{
+    QVector<int> cycle = create_cycle(desc, width, height, numOfNodes);
+
+    if (! complete || numOfNodes < 2 || degree <= 0)
+	return;
+
+    qint64 n = numOfNodes;
+    int first = cycle.first();
+    double p = qMin(1., (double)degree / (n - 1));
+
+    desc->edges.reserve(desc->edgeCount()
+			+ (int)qMin(p * n * (n - 1) / 2 * 1.05, 1e9));
+
+    if (p >= 1)
+    {
+	for (int i = 0; i < numOfNodes; i++)
+	    for (int j = i + 1; j < numOfNodes; j++)
+		desc->addEdge(first + i, first + j);
+	return;
+    }
+
+    // Pairs (v, w) with w < v are visited in order; the next edge is
+    // 1 + skip pairs on, where skip is geometrically distributed.
+    FastRandom random(seed);
+    double logQ = qLn(1 - p);
+    qint64 v = 1, w = -1;
+
+    while (v < n)
+    {
+	w += 1 + (qint64)qFloor(qLn(1 - random.uniform()) / logQ);
+	while (w >= v && v < n)
+	{
+	    w -= v;
+	    v++;
 	}
-	angle += bladeSpacing;
+	if (v < n)
+	    desc->addEdge(first + (int)w, first + (int)v);
+    }
+}
+
+
+/*
+ * Name:	BasicGraphs::generate_random_ba
+ * Purpose:	Describes a Barabasi-Albert (preferential attachment)
+ *		random graph.
+ * Arguments:	the description, the horizontal and vertical radii of
+ *		the ellipse the nodes are placed on, the number of
+ *		nodes, the number of edges from each new node to the
+ *		nodes before it and whether to add the edges.
+ * Outputs:	Nothing.
+ * Modifies:	desc.
+ * Returns:	Nothing.
+ * Assumptions:	none
+ * Bugs:	
+ * Notes:	The first links + 1 nodes form a complete graph.  Every
+ *		later node is joined to links distinct earlier nodes,
+ *		chosen with probability proportional to their degree.
+ *		As in Batagelj and Brandes, both ends of every edge are
+ *		kept in one array, so a uniformly chosen entry of it is
+ *		a node chosen by degree, in constant time.
+ */
+
+void
+BasicGraphs::generate_random_ba(GraphDescription * desc, qreal width,
+				qreal height, int numOfNodes, int links,
+				bool complete)
+{
+    QVector<int> cycle = create_cycle(desc, width, height, numOfNodes);
+
+    if (! complete || numOfNodes < 2 || links <= 0)
+	return;
+
+    int m = qMin(links, numOfNodes - 1);
+    if ((qint64)numOfNodes * m * 2 > INT_MAX)
+	m = INT_MAX / 2 / numOfNodes;
+    int first = cycle.first();
 
-	if (complete)
+    QVector<int> ends;
+    ends.reserve(2 * numOfNodes * m);
+    desc->edges.reserve(desc->edgeCount() + numOfNodes * m);
+
+    for (int i = 0; i <= m; i++)
+	for (int j = i + 1; j <= m; j++)
+	{
+	    desc->addEdge(first + i, first + j);
+	    ends.append(i);
+	    ends.append(j);
+	}
+
+    // chosenBy[u] == v once v has chosen u, so that no edge is
+    // added twice.
+    FastRandom random(seed);
+    QVector<int> chosenBy(numOfNodes, -1);
+    QVector<int> targets(m);
+
+    for (int v = m + 1; v < numOfNodes; v++)
+    {
+	int count = 0;
+	while (count < m)
+	{
+	    int u = ends.at(random.below(ends.count()));
+	    if (chosenBy.at(u) == v)
+		continue;
+	    chosenBy[u] = v;
+	    targets[count++] = u;
+	}
+	foreach (int u, targets)
 	{
-	    Edge * edge = new Edge(i_cycle.at(0), g->nodes.center);
-	    edge->setParentItem(g);
-	    edge = new Edge(i_cycle.at(i_cycle.count() - 1),
-			    g->nodes.center);
-	    edge->setParentItem(g);
+	    desc->addEdge(first + u, first + v);
+	    ends.append(u);
+	    ends.append(v);
 	}
     }
 }
+
+
+/*
+ * Name:	BasicGraphs::generate_random_regular
+ * Purpose:	Describes a random regular graph.
+ * Arguments:	the description, the horizontal and vertical radii of
+ *		the ellipse the nodes are placed on, the number of
+ *		nodes, the degree of every node and whether to add
+ *		the edges.
+ * Outputs:	Nothing.
+ * Modifies:	desc.
+ * Returns:	Nothing.
+ * Assumptions:	none
+ * Bugs:	A self-loop or repeated edge that can't be swapped away
+ *		in REGULAR_SWAP_TRIES tries is dropped, leaving its
+ *		nodes one short.  This is very rare unless the degree
+ *		is close to the number of nodes.
+ * Notes:	Uses the configuration model: each node gets degree
+ *		"stubs", the stubs are shuffled and paired off.  Rather
+ *		than starting again whenever a pair is a self-loop or
+ *		repeats an edge, that pair swaps ends with a random
+ *		good pair.  If n * degree is odd, or degree >= n, the
+ *		degree is reduced to make the graph possible.
+ */
+
+void
+BasicGraphs::generate_random_regular(GraphDescription * desc, qreal width,
+				     qreal height, int numOfNodes,
+				     int degree, bool complete)
+{
+    QVector<int> cycle = create_cycle(desc, width, height, numOfNodes);
+
+    if (! complete || numOfNodes < 2)
+	return;
+
+    int d = qMin(degree, numOfNodes - 1);
+    if ((qint64)numOfNodes * d > INT_MAX)
+	d = INT_MAX / numOfNodes;
+    if ((numOfNodes * d) % 2 != 0)
+	d--;
+    if (d <= 0)
+	return;
+
+    int first = cycle.first();
+    int pairs = numOfNodes * d / 2;
+    FastRandom random(seed);
+
+    QVector<int> stubs(numOfNodes * d);
+    for (int i = 0; i < stubs.count(); i++)
+	stubs[i] = i / d;
+    for (int i = stubs.count() - 1; i > 0; i--)
+	qSwap(stubs[i], stubs[random.below(i + 1)]);
+
+    // Pair k is stubs[2k] - stubs[2k + 1].
+    auto edgeKey = [](int a, int b)
+    {
+	if (a > b)
+	    qSwap(a, b);
+	return ((quint64)(quint32)a << 32) | (quint32)b;
+    };
+
+    QSet<quint64> used;
+    QVector<bool> good(pairs, false);
+    QVector<int> bad;
+    used.reserve(pairs);
+
+    for (int k = 0; k < pairs; k++)
+    {
+	int a = stubs.at(2 * k), b = stubs.at(2 * k + 1);
+	if (a != b && !used.contains(edgeKey(a, b)))
+	{
+	    used.insert(edgeKey(a, b));
+	    good[k] = true;
+	}
+	else
+	    bad.append(k);
+    }
+
+    // Swap a - b and c - d for a - c and b - d (or a - d and b - c).
+    foreach (int k, bad)
+    {
+	int a = stubs.at(2 * k), b = stubs.at(2 * k + 1);
+
+	for (int t = 0; t < REGULAR_SWAP_TRIES; t++)
+	{
+	    int l = random.below(pairs);
+	    if (!good.at(l))
+		continue;
+
+	    int c = stubs.at(2 * l), dd = stubs.at(2 * l + 1);
+	    if (t % 2 == 1)
+		qSwap(c, dd);
+	    if (a == c || b == dd || edgeKey(a, c) == edgeKey(b, dd)
+		|| used.contains(edgeKey(a, c))
+		|| used.contains(edgeKey(b, dd)))
+		continue;
+
+	    used.remove(edgeKey(c, dd));
+	    used.insert(edgeKey(a, c));
+	    used.insert(edgeKey(b, dd));
+	    stubs[2 * k] = a;
+	    stubs[2 * k + 1] = c;
+	    stubs[2 * l] = b;
+	    stubs[2 * l + 1] = dd;
+	    good[k] = true;
+	    break;
+	}
+    }
+
+    desc->edges.reserve(desc->edgeCount() + pairs);
+    for (int k = 0; k < pairs; k++)
+	if (good.at(k))
+	    desc->addEdge(first + stubs.at(2 * k), first + stubs.at(2 * k + 1));
+}
+
+
+/*
+ * Name:	BasicGraphs::generate_random_geometric
+ * Purpose:	Describes a random geometric graph.
+ * Arguments:	the description, the height and width of the graph,
+ *		the number of nodes, the average degree wanted and
+ *		whether to add the edges.
+ * Outputs:	Nothing.
+ * Modifies:	desc.
+ * Returns:	Nothing.
+ * Assumptions:	none
+ * Bugs:	Nodes near the edges of the rectangle have fewer
+ *		neighbours, so the average degree is a little low.
+ * Notes:	The nodes are placed uniformly at random in a unit
+ *		square, and two nodes are joined if they are within r
+ *		of each other, where n * Pi * r^2 = degree.  The square
+ *		is then stretched to width x height, so that resizing
+ *		the graph doesn't change which nodes are joined.
+ *		The square is cut into cells at least r wide, and the
+ *		nodes sorted into them, so each node is only compared
+ *		with the nodes in its own and the neighbouring cells.
+ */
+
+void
+BasicGraphs::generate_random_geometric(GraphDescription * desc,
+				       qreal height, qreal width,
+				       int numOfNodes, int degree,
+				       bool complete)
+{
+    if (numOfNodes <= 0)
+	return;
+
+    FastRandom random(seed);
+    QVector<QPointF> unit(numOfNodes);
+    int first = desc->addNodes(numOfNodes);
+    QPointF * out = desc->positions.data() + first;
+
+    for (int i = 0; i < numOfNodes; i++)
+    {
+	qreal x = random.uniform();
+	qreal y = random.uniform();
+	unit[i] = QPointF(x, y);
+	out[i] = QPointF((x - 0.5) * width, (y - 0.5) * height);
+    }
+
+    if (! complete || numOfNodes < 2 || degree <= 0)
+	return;
+
+    double r = qSqrt(degree / (PI * (numOfNodes - 1)));
+    double r2 = r * r;
+    int side = qBound(1, (int)(1 / r), qMax(1, (int)qSqrt(numOfNodes)));
+    int cells = side * side;
+
+    // Counting sort of the nodes by cell: the nodes in cell c are
+    // order[start[c]] ... order[start[c + 1] - 1].
+    QVector<int> cellOf(numOfNodes);
+    QVector<int> start(cells + 1, 0);
+    QVector<int> order(numOfNodes);
+
+    for (int i = 0; i < numOfNodes; i++)
+    {
+	int cx = qMin(side - 1, (int)(unit.at(i).x() * side));
+	int cy = qMin(side - 1, (int)(unit.at(i).y() * side));
+	cellOf[i] = cy * side + cx;
+	start[cellOf.at(i) + 1]++;
+    }
+    for (int c = 0; c < cells; c++)
+	start[c + 1] += start.at(c);
+    QVector<int> fill = start;
+    for (int i = 0; i < numOfNodes; i++)
+	order[fill[cellOf.at(i)]++] = i;
+
+    desc->edges.reserve(desc->edgeCount()
+			+ (int)qMin((double)numOfNodes * degree / 2, 1e9));
+
+    // Each pair of neighbouring cells is visited once: a cell is
+    // compared with itself and the cells E, SW, S and SE of it.
+    static const int dx[] = {0, 1, -1, 0, 1};
+    static const int dy[] = {0, 0, 1, 1, 1};
+
+    for (int cy = 0; cy < side; cy++)
+	for (int cx = 0; cx < side; cx++)
+	{
+	    int c = cy * side + cx;
+	    for (int s = 0; s < 5; s++)
+	    {
+		int nx = cx + dx[s], ny = cy + dy[s];
+		if (nx < 0 || nx >= side || ny >= side)
+		    continue;
+		int nc = ny * side + nx;
+
+		for (int a = start.at(c); a < start.at(c + 1); a++)
+		{
+		    int i = order.at(a);
+		    int b = s == 0 ? a + 1 : start.at(nc);
+		    for (; b < start.at(nc + 1); b++)
+		    {
+			int j = order.at(b);
+			QPointF d = unit.at(i) - unit.at(j);
+			if (d.x() * d.x() + d.y() * d.y() <= r2)
+			    desc->addEdge(first + qMin(i, j),
+					  first + qMax(i, j));
+		    }
+		}
+	    }
+	}
+}
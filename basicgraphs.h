@@ -11,55 +11,105 @@
 #ifndef BASICGRAPHS_H
 #define BASICGRAPHS_H
 
-#include <graph.h>
+#include "graphdescription.h"
+
+#include <QString>
+#include <QVector>
+
+// The shared state of generate_balanced_tree() and its helpers.
+typedef struct tLayout
+{
+    int numOfNodes;
+    int arity;			// Children per node.
+    int depth;			// Of the deepest level; the root is 0.
+    int first;			// Description index of the root.
+    qreal height, width;
+    qreal leaves;		// On the bottom level of the full tree.
+    QVector<int> levelStart;	// Heap index of each level's first node.
+    QVector<int> heap;		// Description index of each heap node...
+    QVector<int> rank;		// ... less first (its preorder number).
+    QPointF * positions;	// Indexed by rank.
+    int * groups;		// Indexed by rank.
+} Tree_Layout;
 
 class BasicGraphs
 {
   public:
     BasicGraphs();
-    void generate_wheel(Graph * item, qreal width, qreal height,
+    void generate(GraphDescription * desc, int graphType,
+		  int topNodes, int bottomNodes,
+		  qreal height, qreal width, bool complete);
+    static qint64 estimate_size(int graphType, int topNodes,
+				int bottomNodes, bool complete);
+
+    void generate_wheel(GraphDescription * desc, qreal width, qreal height,
 			int numOfNodes, bool complete);
-    void generate_bipartite(Graph * item, int topNodes,int bottomNodes,
-			    qreal height, qreal width, bool complete);
-    void generate_cycle(Graph * item, qreal width, qreal height,
+    void generate_bipartite(GraphDescription * desc, int topNodes,
+			    int bottomNodes, qreal height, qreal width,
+			    bool complete);
+    void generate_cycle(GraphDescription * desc, qreal width, qreal height,
 			int numOfNodes, bool complete);
-    void generate_star(Graph * item, qreal width, qreal height,
+    void generate_star(GraphDescription * desc, qreal width, qreal height,
 		       int numOfNodes, bool complete);
-    void generate_complete(Graph * item, qreal width, qreal height,
-			   int numOfNodes, bool complete);
-    void generate_petersen(Graph * item, qreal width, qreal height,
-			   int numOfNodes, int starSkip, bool complete);
-    void generate_gear(Graph * item, qreal width, qreal height,
+    void generate_complete(GraphDescription * desc, qreal width,
+			   qreal height, int numOfNodes, bool complete);
+    void generate_petersen(GraphDescription * desc, qreal width,
+			   qreal height, int numOfNodes, int starSkip,
+			   bool complete);
+    void generate_gear(GraphDescription * desc, qreal width, qreal height,
 		       int numOfNodes, bool complete);
-    void generate_helm(Graph * item, qreal width, qreal height,
+    void generate_helm(GraphDescription * desc, qreal width, qreal height,
 		       int numOfNodes, bool complete);
-    void generate_crown(Graph * item, qreal width, qreal height,
+    void generate_crown(GraphDescription * desc, qreal width, qreal height,
 			int numOfNodes, bool complete);
-    void generate_grid(Graph * item, qreal height, qreal width,
+    void generate_grid(GraphDescription * desc, qreal height, qreal width,
 		       int topNodes, int bottomNodes, bool complete);
-    void generate_antiprism(Graph * item, qreal width, qreal height,
-			    int topNode, bool complete);
-    void generate_path(Graph * item, qreal width, int numOfNodes,
+    void generate_antiprism(GraphDescription * desc, qreal width,
+			    qreal height, int topNode, bool complete);
+    void generate_path(GraphDescription * desc, qreal width, int numOfNodes,
 		       bool complete);
-    void generate_prism(Graph * item, qreal width, qreal height,
+    void generate_prism(GraphDescription * desc, qreal width, qreal height,
 			int numOfNodes, bool complete);
-    void generate_balanced_binary_tree(Graph * item, qreal height,
-				       qreal width, int numOfNodes,
-				       bool complete);
-    void recursive_binary_tree(Graph * item, int depth, int index,
-			       qreal height, qreal width, int treeDepth);
-    void generate_dutch_windmill(Graph * g, qreal height, int blades,
-				 int bladeSize, bool complete);
-    QList<Node *> create_cycle(Graph * item, qreal width, qreal height,
-			       int numOfNodes, qreal radians = 0);
+    void generate_balanced_binary_tree(GraphDescription * desc,
+				       qreal height, qreal width,
+				       int numOfNodes, bool complete);
+    void generate_balanced_tree(GraphDescription * desc, qreal height,
+				qreal width, int numOfNodes, int arity,
+				bool complete);
+    void generate_dutch_windmill(GraphDescription * desc, qreal height,
+				 int blades, int bladeSize, bool complete);
+    void generate_random_er(GraphDescription * desc, qreal width,
+			    qreal height, int numOfNodes, int degree,
+			    bool complete);
+    void generate_random_ba(GraphDescription * desc, qreal width,
+			    qreal height, int numOfNodes, int links,
+			    bool complete);
+    void generate_random_regular(GraphDescription * desc, qreal width,
+				 qreal height, int numOfNodes, int degree,
+				 bool complete);
+    void generate_random_geometric(GraphDescription * desc, qreal height,
+				   qreal width, int numOfNodes, int degree,
+				   bool complete);
+    void setSeed(quint64 aSeed);
+    QVector<int> create_cycle(GraphDescription * desc, qreal width,
+			      qreal height, int numOfNodes, qreal radians = 0,
+			      int role = GraphDescription::Cycle,
+			      int group = 0);
 
-    enum Graph_Type {Antiprism = 1, BBTree, Bipartite, Crown, Cycle,
+    enum Graph_Type {Antiprism = 1, BBTree, KTree, Bipartite, Crown, Cycle,
 		     Windmill, Gear, Grid, Helm, Path, Petersen, Prism,
+		     RandomBA, RandomER, RandomGeometric, RandomRegular,
 		     Complete, Star, Wheel, Count};
     QString getGraphName(int enumValue);
 
   private:
+    static QPointF tree_position(const Tree_Layout & tree, int level,
+				 int index);
+    static void tree_level(Tree_Layout & tree, int level, int begin,
+			   int end);
+
     QVector<QString> Graph_Type_Name;
+    quint64 seed;		// For the random graphs.
 };
 
 #endif // BASICGRAPHS_H
@@ -0,0 +1,283 @@
+/*
+ * File:    benchmark.cpp
+ * Date:    2026/10/18
+ * Version: 1.0
+ *
+ * Purpose: Headless benchmarks of the graph generators, run by
+ *          "Graphic --benchmark [numOfNodes]" (1000000 nodes by
+ *          default).  Each one prints the best time of
+ *          BENCHMARK_REPEATS runs.
+ *
+ * Notes:   The coordinate kernels are compared against the per-node
+ *          code they replaced (one sin and cos per node, one append
+ *          per node), which is kept here for that purpose only.
+ */
+
+#include "benchmark.h"
+#include "basicgraphs.h"
+#include "coordinatekernels.h"
+#include "graphdescription.h"
+
+#include <qmath.h>
+#include <QElapsedTimer>
+#include <QTextStream>
+
+// Number of times each benchmark is run; the best time is reported.
+#define BENCHMARK_REPEATS	5
+
+// The (average) degree of the random graphs.
+#define BENCHMARK_DEGREE	8
+
+// The number of children per node of the k-ary tree.
+#define BENCHMARK_ARITY		4
+
+static const double PI = 3.14159265358979323846264338327950288419717;
+
+
+/*
+ * Name:	per_node_ring
+ * Purpose:	The node placement of BasicGraphs::create_cycle() before
+ *		ring_positions() replaced it.
+ * Arguments:	as ring_positions(), but into a description
+ * Outputs:	Nothing.
+ * Modifies:	desc
+ * Returns:	Nothing.
+ * Assumptions:	none
+ * Bugs:	
+ * Notes:	none
+ */
+
+static void
+per_node_ring(GraphDescription * desc, int numOfNodes,
+	      qreal width, qreal height, qreal radians)
+{
+    qreal spacing =  (2 * PI) / numOfNodes;
+    for (int i = 0; i < numOfNodes; i++)
+    {
+        qreal y =  height * -qCos(radians);
+        qreal x = width * qSin(radians);
+        desc->addNode(x, y);
+        radians += spacing;
+    }
+}
+
+
+/*
+ * Name:	per_node_lattice
+ * Purpose:	The node placement of BasicGraphs::generate_grid() before
+ *		lattice_positions() replaced it.
+ * Arguments:	as lattice_positions(), but into a description
+ * Outputs:	Nothing.
+ * Modifies:	desc
+ * Returns:	Nothing.
+ * Assumptions:	none
+ * Bugs:	
+ * Notes:	none
+ */
+
+static void
+per_node_lattice(GraphDescription * desc, int columns, int rows,
+		 qreal width, qreal height)
+{
+    qreal xSpace = width / (columns - 1);
+    qreal ySpace = height / (rows - 1);
+    qreal x = 0;
+    qreal y = 0;
+
+    for (int i = 0; i < rows; i++)
+    {
+        for (int j = 0; j < columns; j++)
+        {
+            desc->addNode(columns > 1 ? x - width / 2. : 0,
+			  rows > 1 ? y - height / 2. : 0);
+            x += xSpace;
+        }
+        x = 0;
+        y += ySpace;
+    }
+}
+
+
+/*
+ * Name:	max_difference
+ * Purpose:	Finds how far apart two sets of positions are.
+ * Arguments:	the two descriptions
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	The largest difference in any coordinate.
+ * Assumptions:	They have the same number of nodes.
+ * Bugs:	
+ * Notes:	none
+ */
+
+static qreal
+max_difference(const GraphDescription & a, const GraphDescription & b)
+{
+    qreal diff = 0;
+
+    for (int i = 0; i < a.nodeCount(); i++)
+    {
+	QPointF d = a.positions.at(i) - b.positions.at(i);
+	diff = qMax(diff, qMax(qAbs(d.x()), qAbs(d.y())));
+    }
+    return diff;
+}
+
+
+/*
+ * Name:	report
+ * Purpose:	Prints one benchmark result.
+ * Arguments:	the output stream, the name of the benchmark, the best
+ *		time (ns) and the number of items processed
+ * Outputs:	One line.
+ * Modifies:	Nothing.
+ * Returns:	Nothing.
+ * Assumptions:	none
+ * Bugs:	
+ * Notes:	none
+ */
+
+static void
+report(QTextStream & out, const QString & name, qint64 ns, qint64 items)
+{
+    out << qSetFieldWidth(32) << left << name << qSetFieldWidth(0)
+	<< QString::number(ns / 1e6, 'f', 3) << " ms  ("
+	<< QString::number(items > 0 ? (double)ns / items : 0., 'f', 2)
+	<< " ns/item)" << endl;
+}
+
+
+/*
+ * Name:	run_benchmark
+ * Purpose:	Runs the benchmarks and prints the results.
+ * Arguments:	the number of nodes in each benchmark graph
+ * Outputs:	The results, on stdout.
+ * Modifies:	Nothing.
+ * Returns:	An exit status (0 = success).
+ * Assumptions:	none
+ * Bugs:	
+ * Notes:	Needs no GUI: only descriptions are generated.
+ */
+
+int
+run_benchmark(int numOfNodes)
+{
+    QTextStream out(stdout);
+    QElapsedTimer timer;
+    qint64 best;
+    int side = qMax(2, (int)qSqrt(numOfNodes));
+    GraphDescription before, after;
+
+    if (numOfNodes < 2)
+    {
+	out << "The benchmark needs at least 2 nodes." << endl;
+	return 1;
+    }
+
+    out << "Coordinate kernels, " << numOfNodes << " nodes:" << endl;
+
+    best = -1;
+    for (int r = 0; r < BENCHMARK_REPEATS; r++)
+    {
+	before.clear();
+	timer.start();
+	per_node_ring(&before, numOfNodes, 500, 500, 0);
+	best = best < 0 ? timer.nsecsElapsed() : qMin(best, timer.nsecsElapsed());
+    }
+    report(out, "ring, per node", best, numOfNodes);
+
+    best = -1;
+    for (int r = 0; r < BENCHMARK_REPEATS; r++)
+    {
+	after.clear();
+	timer.start();
+	int first = after.addNodes(numOfNodes);
+	ring_positions(after.positions.data() + first, numOfNodes, 500, 500);
+	best = best < 0 ? timer.nsecsElapsed() : qMin(best, timer.nsecsElapsed());
+    }
+    report(out, "ring, ring_positions()", best, numOfNodes);
+    out << "  largest difference: " << max_difference(before, after) << endl;
+
+    best = -1;
+    for (int r = 0; r < BENCHMARK_REPEATS; r++)
+    {
+	before.clear();
+	timer.start();
+	per_node_lattice(&before, side, side, 1000, 1000);
+	best = best < 0 ? timer.nsecsElapsed() : qMin(best, timer.nsecsElapsed());
+    }
+    report(out, "lattice, per node", best, (qint64)side * side);
+
+    best = -1;
+    for (int r = 0; r < BENCHMARK_REPEATS; r++)
+    {
+	after.clear();
+	timer.start();
+	int first = after.addNodes(side * side);
+	lattice_positions(after.positions.data() + first, side, side,
+			  1000, 1000);
+	best = best < 0 ? timer.nsecsElapsed() : qMin(best, timer.nsecsElapsed());
+    }
+    report(out, "lattice, lattice_positions()", best, (qint64)side * side);
+    out << "  largest difference: " << max_difference(before, after) << endl;
+
+    out << endl << "Generators (no edges), " << numOfNodes << " nodes:"
+	<< endl;
+
+    BasicGraphs generator;
+    const int types[] = {BasicGraphs::Cycle, BasicGraphs::Prism,
+			 BasicGraphs::Grid, BasicGraphs::Bipartite,
+			 BasicGraphs::Path, BasicGraphs::BBTree,
+			 BasicGraphs::KTree};
+    for (int type : types)
+    {
+	int top = numOfNodes, bottom = 0;
+	if (type == BasicGraphs::Prism)
+	    top = numOfNodes / 2;
+	else if (type == BasicGraphs::Grid)
+	    top = bottom = side;
+	else if (type == BasicGraphs::Bipartite)
+	    top = bottom = numOfNodes / 2;
+	else if (type == BasicGraphs::KTree)
+	    bottom = BENCHMARK_ARITY;
+
+	best = -1;
+	for (int r = 0; r < BENCHMARK_REPEATS; r++)
+	{
+	    after.clear();
+	    timer.start();
+	    generator.generate(&after, type, top, bottom, 1000, 1000, false);
+	    best = best < 0 ? timer.nsecsElapsed()
+		: qMin(best, timer.nsecsElapsed());
+	}
+	report(out, generator.getGraphName(type), best, after.nodeCount());
+    }
+
+    out << endl << "Random graphs, " << numOfNodes << " nodes, degree "
+	<< BENCHMARK_DEGREE << ":" << endl;
+
+    const int randomTypes[] = {BasicGraphs::RandomER, BasicGraphs::RandomBA,
+			       BasicGraphs::RandomRegular,
+			       BasicGraphs::RandomGeometric};
+    for (int type : randomTypes)
+    {
+	int degree = BENCHMARK_DEGREE;
+	if (type == BasicGraphs::RandomBA)
+	    degree /= 2;
+
+	best = -1;
+	for (int r = 0; r < BENCHMARK_REPEATS; r++)
+	{
+	    after.clear();
+	    timer.start();
+	    generator.generate(&after, type, numOfNodes, degree,
+			       1000, 1000, true);
+	    best = best < 0 ? timer.nsecsElapsed()
+		: qMin(best, timer.nsecsElapsed());
+	}
+	report(out, generator.getGraphName(type), best,
+	       (qint64)after.nodeCount() + after.edgeCount());
+    }
+
+    return 0;
+}
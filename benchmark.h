@@ -0,0 +1,14 @@
+/*
+ * File:	benchmark.h
+ * Date:	2026/10/18
+ * Version:	1.0
+ *
+ * Purpose:	Declares the headless benchmarks run by "Graphic --benchmark".
+ */
+
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+int run_benchmark(int numOfNodes);
+
+#endif // BENCHMARK_H
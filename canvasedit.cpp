@@ -0,0 +1,872 @@
+/*
+ * File:    canvasedit.cpp
+ * Date:    2026/10/18
+ * Version: 1.0
+ *
+ * Purpose: Records one edit of the canvas (a drag, a deletion, a join,
+ *          a new edge, a change of style) so that it can be undone and
+ *          redone.
+ *
+ * Notes:   An edit is kept as the list of small changes (deltas) it
+ *          made, each with the values before and after, rather than as
+ *          a copy of the canvas: moving 10 nodes of a 10000 node graph
+ *          records 10 positions.
+ *          Nothing is deleted by an edit.  An item taken off the
+ *          canvas is just detached from its parent, its nodes and the
+ *          scene, so undoing the deletion of a big graph only puts the
+ *          same items back.  While taken off, the items belong to the
+ *          edit, which deletes them once it is dropped from the history
+ *          (likewise the items an undone edit had added).
+ */
+
+#include "canvasedit.h"
+#include "canvasscene.h"
+#include "node.h"
+#include "edge.h"
+#include "graph.h"
+
+#include <QColor>
+#include <QDateTime>
+#include <QGraphicsScene>
+#include <QSet>
+#include <QStringList>
+
+// Edits of the same items (moves or styles) made less than this many
+// ms apart are merged, and undone in one step.
+#define EDIT_MERGE_INTERVAL	1000
+
+// About the memory (in bytes) an item taken off the canvas uses, with
+// its label, counted against the size of the undo history.
+#define EDIT_ITEM_COST		2048
+
+
+/*
+ * Name:        item_cost
+ * Purpose:     Estimates the memory an item and its children use.
+ * Arguments:   the item
+ * Output:      none
+ * Modifies:    nothing
+ * Returns:     the estimate, in bytes
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       A graph taken off the canvas keeps all of its nodes,
+ *              edges and implicit edge sets alive, so they are all
+ *              counted.  Labels are part of their node's or edge's
+ *              EDIT_ITEM_COST.
+ */
+
+static qint64
+item_cost(QGraphicsItem * item)
+{
+    qint64 bytes = 0;
+
+    if (item->type() == Label::Type)
+	return 0;
+    if (item->type() == ImplicitEdges::Type)
+	bytes = static_cast<ImplicitEdges *>(item)->bytesUsed();
+    else
+	bytes = EDIT_ITEM_COST;
+    foreach (QGraphicsItem * child, item->childItems())
+	bytes += item_cost(child);
+    return bytes;
+}
+
+
+/*
+ * Name:        style_of
+ * Purpose:     Finds one style of an item.
+ * Arguments:   the node or edge, and the style
+ * Output:      none
+ * Modifies:    nothing
+ * Returns:     its value
+ * Assumptions: The style is one the item has.
+ * Bugs:        none
+ * Notes:       A node's label is kept as its HTML and its text, so
+ *              that subscripts come back too.
+ */
+
+static QVariant
+style_of(QGraphicsItem * item, int style)
+{
+    if (item->type() == Node::Type)
+    {
+	Node * node = qgraphicsitem_cast<Node *>(item);
+	switch (style)
+	{
+	  case CanvasEdit::NodeDiameter:
+	    return node->getDiameter();
+	  case CanvasEdit::NodeFill:
+	    return node->getFillColour();
+	  case CanvasEdit::NodeLine:
+	    return node->getLineColour();
+	  case CanvasEdit::NodeLabel:
+	    return QStringList() << node->getLabelHtml() << node->getLabel();
+	  case CanvasEdit::NodeLabelSize:
+	    return node->getLabelSize();
+	}
+    }
+    else if (item->type() == Edge::Type)
+    {
+	Edge * edge = qgraphicsitem_cast<Edge *>(item);
+	switch (style)
+	{
+	  case CanvasEdit::EdgeWidth:
+	    return edge->getPenWidth();
+	  case CanvasEdit::EdgeColour:
+	    return edge->getColour();
+	  case CanvasEdit::EdgeWeight:
+	    return edge->getWeight();
+	  case CanvasEdit::EdgeWeightSize:
+	    return edge->getWeightLabelSize();
+	}
+    }
+    return QVariant();
+}
+
+
+/*
+ * Name:        set_style
+ * Purpose:     Changes one style of an item.
+ * Arguments:   the node or edge, the style and its new value
+ * Output:      none
+ * Modifies:    the item
+ * Returns:     none
+ * Assumptions: The style is one the item has.
+ * Bugs:        none
+ * Notes:       A node label may be given as a number, as text, or as
+ *              style_of() returns it.
+ */
+
+static void
+set_style(QGraphicsItem * item, int style, const QVariant & value)
+{
+    if (item->type() == Node::Type)
+    {
+	Node * node = qgraphicsitem_cast<Node *>(item);
+	switch (style)
+	{
+	  case CanvasEdit::NodeDiameter:
+	    node->setDiameter(value.toReal());
+	    break;
+	  case CanvasEdit::NodeFill:
+	    node->setFillColour(value.value<QColor>());
+	    break;
+	  case CanvasEdit::NodeLine:
+	    node->setLineColour(value.value<QColor>());
+	    break;
+	  case CanvasEdit::NodeLabel:
+	    if (value.type() == QVariant::StringList)
+		node->setNodeLabel(value.toStringList().at(0),
+				   node->getLabelSize(),
+				   value.toStringList().at(1));
+	    else if (value.type() == QVariant::Double)
+		node->setNodeLabel(value.toReal());
+	    else
+		node->setNodeLabel(value.toString());
+	    break;
+	  case CanvasEdit::NodeLabelSize:
+	    node->setNodeLabelSize(value.toReal());
+	    break;
+	}
+    }
+    else if (item->type() == Edge::Type)
+    {
+	Edge * edge = qgraphicsitem_cast<Edge *>(item);
+	switch (style)
+	{
+	  case CanvasEdit::EdgeWidth:
+	    edge->setPenWidth(value.toReal());
+	    break;
+	  case CanvasEdit::EdgeColour:
+	    edge->setColour(value.value<QColor>());
+	    break;
+	  case CanvasEdit::EdgeWeight:
+	    edge->setWeight(value.toString());
+	    break;
+	  case CanvasEdit::EdgeWeightSize:
+	    edge->setWeightLabelSize(value.toReal());
+	    break;
+	}
+    }
+}
+
+
+/*
+ * Name:        CanvasEdit
+ * Purpose:     Constructor for CanvasEdit.
+ * Arguments:   the scene the edit is made in
+ * Output:      none
+ * Modifies:    none
+ * Returns:     none
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       The edit starts out empty, and done.
+ */
+
+CanvasEdit::CanvasEdit(QGraphicsScene * aScene)
+{
+    scene = aScene;
+    done = true;
+    stamp = QDateTime::currentMSecsSinceEpoch();
+    bytes = -1;
+}
+
+
+/*
+ * Name:        ~CanvasEdit
+ * Purpose:     Deletes the items that belong to the edit.
+ * Arguments:   none
+ * Output:      none
+ * Modifies:    none
+ * Returns:     none
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       If the edit is done, those are the items it took off the
+ *              canvas (and didn't put back); if it is undone, those it
+ *              had put on.  A detached item has no parent, so no item
+ *              is deleted twice.
+ */
+
+CanvasEdit::~CanvasEdit()
+{
+    QSet<QGraphicsItem *> owned;
+
+    if (done)
+    {
+	for (int d = 0; d < deltas.count(); d++)
+	    if (deltas.at(d).kind == Attach)
+		owned.remove(deltas.at(d).item);
+	    else if (deltas.at(d).kind == Detach)
+		owned.insert(deltas.at(d).item);
+    }
+    else
+    {
+	for (int d = deltas.count() - 1; d >= 0; d--)
+	    if (deltas.at(d).kind == Detach)
+		owned.remove(deltas.at(d).item);
+	    else if (deltas.at(d).kind == Attach)
+		owned.insert(deltas.at(d).item);
+    }
+
+    foreach (QGraphicsItem * item, owned)
+	delete item;
+}
+
+
+bool
+CanvasEdit::isEmpty() const
+{
+    return deltas.isEmpty();
+}
+
+
+/*
+ * Name:        record
+ * Purpose:     Adds a delta to the edit.
+ * Arguments:   its kind and item
+ * Output:      none
+ * Modifies:    deltas, stamp
+ * Returns:     the delta, for the caller to fill in
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       The reference is only good until the next delta is
+ *              added.
+ */
+
+CanvasEdit::Canvas_Delta &
+CanvasEdit::record(int kind, QGraphicsItem * item)
+{
+    Canvas_Delta delta;
+
+    delta.kind = kind;
+    delta.style = 0;
+    delta.item = item;
+    delta.oldItem = nullptr;
+    delta.newItem = nullptr;
+    delta.index = -1;
+    deltas.append(delta);
+    stamp = QDateTime::currentMSecsSinceEpoch();
+    return deltas.last();
+}
+
+
+/*
+ * Name:        remove
+ * Purpose:     Takes an item off the canvas.
+ * Arguments:   the item
+ * Output:      none
+ * Modifies:    the item, its parent, and (for an edge) its nodes
+ * Returns:     none
+ * Assumptions: A node has no edges left (see removeNode()).
+ * Bugs:        none
+ * Notes:       none
+ */
+
+void
+CanvasEdit::remove(QGraphicsItem * item)
+{
+    Canvas_Delta & delta = record(Detach, item);
+
+    delta.oldItem = item->parentItem();
+    detach(item);
+}
+
+
+/*
+ * Name:        removeNode
+ * Purpose:     Takes a node and all of its edges off the canvas.
+ * Arguments:   the node
+ * Output:      none
+ * Modifies:    the node, its edges, and its implicit edge sets
+ * Returns:     none
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       none
+ */
+
+void
+CanvasEdit::removeNode(Node * node)
+{
+    foreach (ImplicitEdges * implicit, node->implicitEdges)
+    {
+	Canvas_Delta & delta = record(ForgetNode, implicit);
+	delta.oldItem = node;
+	delta.index = nodeSlots.count();
+	nodeSlots.append(implicit->removeNode(node));
+    }
+
+    // Last first, so that each is found at once at the end of the
+    // node's list (see Node::removeEdge()).
+    QList<Edge *> edges = node->edgeList;
+    for (int e = edges.count() - 1; e >= 0; e--)
+	remove(edges.at(e));
+    remove(node);
+}
+
+
+void
+CanvasEdit::removePair(ImplicitEdges * implicit, Node * source, Node * dest)
+{
+    Canvas_Delta & delta = record(ForgetPair, implicit);
+
+    delta.oldItem = source;
+    delta.newItem = dest;
+    implicit->removePair(source, dest);
+}
+
+
+/*
+ * Name:        reparent
+ * Purpose:     Gives an item a new parent.
+ * Arguments:   the item, and the parent (nullptr for none)
+ * Output:      none
+ * Modifies:    the item and both parents
+ * Returns:     none
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       As with setParentItem(), the item's position isn't
+ *              mapped.
+ */
+
+void
+CanvasEdit::reparent(QGraphicsItem * item, QGraphicsItem * parent)
+{
+    Canvas_Delta & delta = record(Reparent, item);
+
+    delta.oldItem = item->parentItem();
+    delta.newItem = parent;
+    item->setParentItem(parent);
+}
+
+
+void
+CanvasEdit::move(QGraphicsItem * item, QPointF pos)
+{
+    Canvas_Delta & delta = record(Move, item);
+
+    delta.oldPos = item->pos();
+    delta.newPos = pos;
+    item->setPos(pos);
+}
+
+
+void
+CanvasEdit::rotate(QGraphicsItem * item, qreal rotation)
+{
+    Canvas_Delta & delta = record(Rotate, item);
+
+    delta.oldPos.setX(item->rotation());
+    delta.newPos.setX(rotation);
+    item->setRotation(rotation);
+}
+
+
+/*
+ * Name:        setEnd
+ * Purpose:     Moves one end of an edge to another node.
+ * Arguments:   the edge, the node it leaves and the node it goes to
+ * Output:      none
+ * Modifies:    the edge and both nodes' lists of edges
+ * Returns:     none
+ * Assumptions: from is an end of the edge.
+ * Bugs:        none
+ * Notes:       none
+ */
+
+void
+CanvasEdit::setEnd(Edge * edge, Node * from, Node * to)
+{
+    Canvas_Delta & delta
+	= record(edge->sourceNode() == from ? SourceEnd : DestEnd, edge);
+
+    delta.oldItem = from;
+    delta.newItem = to;
+    apply(delta, true);
+}
+
+
+/*
+ * Name:        restyle
+ * Purpose:     Changes one style of a node or edge.
+ * Arguments:   the item, the style and its new value
+ * Output:      none
+ * Modifies:    the item, values
+ * Returns:     none
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       See set_style() for the value.
+ */
+
+void
+CanvasEdit::restyle(QGraphicsItem * item, int style, const QVariant & value)
+{
+    Canvas_Delta & delta = record(Restyle, item);
+
+    delta.style = style;
+    delta.index = values.count();
+    values.append(style_of(item, style));
+    set_style(item, style, value);
+    values.append(style_of(item, style));
+}
+
+
+/*
+ * Name:        materializeAll
+ * Purpose:     Replaces every ImplicitEdges under an item by Edges.
+ * Arguments:   the item
+ * Output:      none
+ * Modifies:    the item and its descendants
+ * Returns:     none
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       Used before two graphs are joined, since joining moves
+ *              edges from one node to another.  Each Edge gets the
+ *              pen, colour and radius of its ImplicitEdges, which is
+ *              taken off the canvas, not deleted, so that the join can
+ *              be undone.
+ */
+
+void
+CanvasEdit::materializeAll(QGraphicsItem * root)
+{
+    if (root == nullptr)
+	return;
+
+    foreach (QGraphicsItem * child, root->childItems())
+    {
+	if (child->type() != ImplicitEdges::Type)
+	{
+	    materializeAll(child);
+	    continue;
+	}
+
+	ImplicitEdges * implicit = static_cast<ImplicitEdges *>(child);
+	implicit->forEachPair([&](Node * a, Node * b)
+	{
+	    Edge * edge = new Edge(a, b);
+	    edge->setPenWidth(implicit->getPenWidth());
+	    edge->setColour(implicit->getColour());
+	    edge->setSourceRadius(implicit->getRadius());
+	    edge->setDestRadius(implicit->getRadius());
+	    edge->setParentItem(root);
+	    added(edge);
+	});
+	remove(implicit);
+    }
+}
+
+
+/*
+ * Name:        added
+ * Purpose:     Records that an item has been put on the canvas.
+ * Arguments:   the item
+ * Output:      none
+ * Modifies:    deltas
+ * Returns:     none
+ * Assumptions: The item is in the scene, with its final parent; an
+ *              edge is in its nodes' lists.
+ * Bugs:        none
+ * Notes:       none
+ */
+
+void
+CanvasEdit::added(QGraphicsItem * item)
+{
+    Canvas_Delta & delta = record(Attach, item);
+
+    delta.newItem = item->parentItem();
+}
+
+
+/*
+ * Name:        moved
+ * Purpose:     Records that an item has been moved.
+ * Arguments:   the item, and where it was (in its parent's coordinates)
+ * Output:      none
+ * Modifies:    deltas
+ * Returns:     none
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       Used for drags and layouts, which move the items
+ *              themselves.  An item that is back where it was isn't
+ *              recorded.
+ */
+
+void
+CanvasEdit::moved(QGraphicsItem * item, QPointF from)
+{
+    if (item->pos() == from)
+	return;
+
+    Canvas_Delta & delta = record(Move, item);
+    delta.oldPos = from;
+    delta.newPos = item->pos();
+}
+
+
+/*
+ * Name:        undo
+ * Purpose:     Undoes the edit.
+ * Arguments:   none
+ * Output:      none
+ * Modifies:    the items the edit changed, done
+ * Returns:     none
+ * Assumptions: none
+ * Bugs:        The Edit Graph tab isn't told of changed styles until
+ *              it is shown again.
+ * Notes:       The deltas are undone newest first.
+ */
+
+void
+CanvasEdit::undo()
+{
+    applyAll(false);
+    done = false;
+}
+
+
+void
+CanvasEdit::redo()
+{
+    applyAll(true);
+    done = true;
+}
+
+
+/*
+ * Name:        applyAll
+ * Purpose:     Redoes (or undoes) every delta.
+ * Arguments:   true to redo, false to undo
+ * Output:      none
+ * Modifies:    the items the edit changed
+ * Returns:     none
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       Nodes are moved as one batch (see Node::moveQuietly()),
+ *              so undoing a layout doesn't adjust every edge twice.
+ */
+
+void
+CanvasEdit::applyAll(bool forward)
+{
+    Node_Moves moves;
+
+    for (int k = 0; k < deltas.count(); k++)
+    {
+	const Canvas_Delta & delta
+	    = deltas.at(forward ? k : deltas.count() - 1 - k);
+	if (delta.kind != Move || delta.item->type() != Node::Type)
+	{
+	    apply(delta, forward);
+	    continue;
+	}
+
+	Node * node = qgraphicsitem_cast<Node *>(delta.item);
+	node->moveQuietly(forward ? delta.newPos : delta.oldPos, moves);
+    }
+    Node::finishMoves(moves);
+}
+
+
+/*
+ * Name:        apply
+ * Purpose:     Redoes (or undoes) one delta.
+ * Arguments:   the delta, and true to redo, false to undo
+ * Output:      none
+ * Modifies:    the delta's item, and the items it links to
+ * Returns:     none
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       none
+ */
+
+void
+CanvasEdit::apply(const Canvas_Delta & delta, bool forward)
+{
+    QGraphicsItem * item = delta.item;
+
+    switch (delta.kind)
+    {
+      case Attach:
+      case Detach:
+	if ((delta.kind == Attach) == forward)
+	    attach(item, forward ? delta.newItem : delta.oldItem);
+	else
+	    detach(item);
+	break;
+
+      case Reparent:
+	item->setParentItem(forward ? delta.newItem : delta.oldItem);
+	break;
+
+      case Move:
+	item->setPos(forward ? delta.newPos : delta.oldPos);
+	break;
+
+      case Rotate:
+	item->setRotation(forward ? delta.newPos.x() : delta.oldPos.x());
+	break;
+
+      case SourceEnd:
+      case DestEnd:
+      {
+	Edge * edge = qgraphicsitem_cast<Edge *>(item);
+	Node * from = qgraphicsitem_cast<Node *>(forward ? delta.oldItem
+						 : delta.newItem);
+	Node * to = qgraphicsitem_cast<Node *>(forward ? delta.newItem
+					       : delta.oldItem);
+	from->removeEdge(edge);
+	if (delta.kind == SourceEnd)
+	    edge->setSourceNode(to);
+	else
+	    edge->setDestNode(to);
+	to->addEdge(edge);
+	break;
+      }
+
+      case Restyle:
+	set_style(item, delta.style,
+		  values.at(delta.index + (forward ? 1 : 0)));
+	break;
+
+      case ForgetNode:
+      {
+	ImplicitEdges * implicit = static_cast<ImplicitEdges *>(item);
+	Node * node = qgraphicsitem_cast<Node *>(delta.oldItem);
+	if (forward)
+	    nodeSlots[delta.index] = implicit->removeNode(node);
+	else
+	    implicit->restoreNode(node, nodeSlots.at(delta.index));
+	break;
+      }
+
+      case ForgetPair:
+      {
+	ImplicitEdges * implicit = static_cast<ImplicitEdges *>(item);
+	Node * source = qgraphicsitem_cast<Node *>(delta.oldItem);
+	Node * dest = qgraphicsitem_cast<Node *>(delta.newItem);
+	if (forward)
+	    implicit->removePair(source, dest);
+	else
+	    implicit->restorePair(source, dest);
+	break;
+      }
+    }
+}
+
+
+/*
+ * Name:        attach
+ * Purpose:     Puts an item back on the canvas.
+ * Arguments:   the item, and its parent (nullptr for none)
+ * Output:      none
+ * Modifies:    the item, its parent, and the nodes it links to
+ * Returns:     none
+ * Assumptions: The item is detached.
+ * Bugs:        none
+ * Notes:       An edge goes back in its nodes' lists, and an
+ *              ImplicitEdges in those of its nodes.
+ */
+
+void
+CanvasEdit::attach(QGraphicsItem * item, QGraphicsItem * parent)
+{
+    if (parent != nullptr)
+	item->setParentItem(parent);
+    else
+	scene->addItem(item);
+
+    if (item->type() == Edge::Type)
+    {
+	Edge * edge = qgraphicsitem_cast<Edge *>(item);
+	edge->sourceNode()->addEdge(edge);
+	edge->destNode()->addEdge(edge);
+    }
+    else if (item->type() == ImplicitEdges::Type)
+	static_cast<ImplicitEdges *>(item)->attach();
+}
+
+
+/*
+ * Name:        detach
+ * Purpose:     Takes an item off the canvas, without deleting it.
+ * Arguments:   the item
+ * Output:      none
+ * Modifies:    the item, its parent, and the nodes it links to
+ * Returns:     none
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       The inverse of attach().
+ */
+
+void
+CanvasEdit::detach(QGraphicsItem * item)
+{
+    if (item->type() == Edge::Type)
+    {
+	Edge * edge = qgraphicsitem_cast<Edge *>(item);
+	edge->sourceNode()->removeEdge(edge);
+	edge->destNode()->removeEdge(edge);
+    }
+    else if (item->type() == ImplicitEdges::Type)
+	static_cast<ImplicitEdges *>(item)->detach();
+
+    item->setParentItem(nullptr);
+    if (item->scene() != nullptr)
+	item->scene()->removeItem(item);
+}
+
+
+/*
+ * Name:        cost
+ * Purpose:     Estimates the memory the edit uses.
+ * Arguments:   none
+ * Output:      none
+ * Modifies:    nothing
+ * Returns:     the estimate, in bytes
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       An item added or taken off is counted with everything
+ *              under it (see item_cost()).  The estimate is made once,
+ *              when the edit goes into the history, and kept: the
+ *              history subtracts what it added, even if a graph put
+ *              back by an undo has changed since.  Merging only
+ *              overwrites values, so doesn't change it.
+ */
+
+qint64
+CanvasEdit::cost() const
+{
+    if (bytes >= 0)
+	return bytes;
+
+    bytes = sizeof(CanvasEdit)
+	+ deltas.capacity() * sizeof(Canvas_Delta)
+	+ values.count() * sizeof(QVariant);
+    foreach (const ImplicitEdges::Node_Slot & slot, nodeSlots)
+	bytes += sizeof(slot) + slot.pairs.count() * sizeof(quint64);
+    foreach (const Canvas_Delta & delta, deltas)
+	if (delta.kind == Attach || delta.kind == Detach)
+	    bytes += item_cost(delta.item);
+    return bytes;
+}
+
+
+/*
+ * Name:        mergeWith
+ * Purpose:     Folds the next edit into this one, if they go together.
+ * Arguments:   the next edit
+ * Output:      none
+ * Modifies:    deltas, values, stamp
+ * Returns:     true if it was merged
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       Two edits go together if both only move (or only
+ *              restyle) the very same items, less than
+ *              EDIT_MERGE_INTERVAL ms apart: a node dragged a bit at a
+ *              time, or a spin box stepped up several times.  The
+ *              merged edit goes from where this one started to where
+ *              the next one ended.
+ */
+
+bool
+CanvasEdit::mergeWith(const UndoCommand * later)
+{
+    const CanvasEdit * next = dynamic_cast<const CanvasEdit *>(later);
+
+    if (next == nullptr || !done || next->stamp - stamp > EDIT_MERGE_INTERVAL
+	|| next->deltas.count() != deltas.count())
+	return false;
+
+    for (int d = 0; d < deltas.count(); d++)
+    {
+	const Canvas_Delta & mine = deltas.at(d);
+	const Canvas_Delta & theirs = next->deltas.at(d);
+	if ((mine.kind != Move && mine.kind != Restyle)
+	    || theirs.kind != mine.kind || theirs.item != mine.item
+	    || theirs.style != mine.style)
+	    return false;
+    }
+
+    for (int d = 0; d < deltas.count(); d++)
+    {
+	const Canvas_Delta & theirs = next->deltas.at(d);
+	if (theirs.kind == Move)
+	    deltas[d].newPos = theirs.newPos;
+	else
+	    values[deltas.at(d).index + 1] = next->values.at(theirs.index + 1);
+    }
+    stamp = next->stamp;
+    return true;
+}
+
+
+/*
+ * Name:        setStyle
+ * Purpose:     Changes one style of a node or edge, so that it can be
+ *              undone.
+ * Arguments:   the item, the style and its new value
+ * Output:      none
+ * Modifies:    the item, and the undo history of its scene
+ * Returns:     none
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       Used by the controllers of the Edit Graph tab.  An item
+ *              that isn't on the canvas is just changed.
+ */
+
+void
+CanvasEdit::setStyle(QGraphicsItem * item, int style, const QVariant & value)
+{
+    CanvasScene * canvas = qobject_cast<CanvasScene *>(item->scene());
+
+    if (canvas == nullptr)
+    {
+	set_style(item, style, value);
+	return;
+    }
+
+    CanvasEdit * edit = new CanvasEdit(canvas);
+    edit->restyle(item, style, value);
+    canvas->record(edit);
+}
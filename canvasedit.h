@@ -0,0 +1,90 @@
+/*
+ * File:	canvasedit.h
+ * Date:	2026/10/18
+ * Version:	1.0
+ *
+ * Purpose:	Declares the record of one edit of the canvas, which
+ *		the undo history keeps.
+ */
+
+#ifndef CANVASEDIT_H
+#define CANVASEDIT_H
+
+#include "undostack.h"
+#include "implicitedges.h"
+
+#include <QPointF>
+#include <QVariant>
+#include <QVector>
+
+class QGraphicsItem;
+class QGraphicsScene;
+class Node;
+class Edge;
+
+class CanvasEdit : public UndoCommand
+{
+public:
+    // The styles the Edit Graph tab can change.
+    enum Style {NodeDiameter, NodeFill, NodeLine, NodeLabel, NodeLabelSize,
+		EdgeWidth, EdgeColour, EdgeWeight, EdgeWeightSize};
+
+    CanvasEdit(QGraphicsScene * aScene);
+    ~CanvasEdit();
+    bool isEmpty() const;
+
+    // These make a change and record it.
+    void remove(QGraphicsItem * item);
+    void removeNode(Node * node);
+    void removePair(ImplicitEdges * implicit, Node * source, Node * dest);
+    void reparent(QGraphicsItem * item, QGraphicsItem * parent);
+    void move(QGraphicsItem * item, QPointF pos);
+    void rotate(QGraphicsItem * item, qreal rotation);
+    void setEnd(Edge * edge, Node * from, Node * to);
+    void restyle(QGraphicsItem * item, int style, const QVariant & value);
+    void materializeAll(QGraphicsItem * root);
+
+    // These record a change the caller has already made.
+    void added(QGraphicsItem * item);
+    void moved(QGraphicsItem * item, QPointF from);
+
+    void undo();
+    void redo();
+    qint64 cost() const;
+    bool mergeWith(const UndoCommand * later);
+
+    static void setStyle(QGraphicsItem * item, int style,
+			 const QVariant & value);
+
+private:
+    enum Kind {Attach, Detach, Reparent, Move, Rotate, SourceEnd, DestEnd,
+	       Restyle, ForgetNode, ForgetPair};
+
+    typedef struct
+    {
+	int kind;
+	int style;		// For Restyle.
+	QGraphicsItem * item;
+	QGraphicsItem * oldItem;	// The parent (or edge end, or
+	QGraphicsItem * newItem;	// removed pair) before and after.
+	QPointF oldPos;			// The position (or rotation, in x)
+	QPointF newPos;			// before and after.
+	int index;		// Into values (old, then new) or nodeSlots.
+    } Canvas_Delta;
+
+    Canvas_Delta & record(int kind, QGraphicsItem * item);
+    void applyAll(bool forward);
+    void apply(const Canvas_Delta & delta, bool forward);
+    void attach(QGraphicsItem * item, QGraphicsItem * parent);
+    void detach(QGraphicsItem * item);
+
+    QGraphicsScene * scene;
+    QVector<Canvas_Delta> deltas;	// In the order they were made.
+    QVector<QVariant> values;		// Styles before and after.
+    QVector<ImplicitEdges::Node_Slot> nodeSlots;
+    bool done;
+    qint64 stamp;			// When the edit was last made.
+    mutable qint64 bytes;		// cost(), or -1 until it is asked.
+};
+
+#endif // CANVASEDIT_H
@@ -12,8 +12,11 @@
 #include "node.h"
 #include "edge.h"
 #include "graph.h"
+#include "implicitedges.h"
 #include "graphmimedata.h"
 #include "canvasview.h"
+#include "canvasedit.h"
+#include "coordinatekernels.h"
 
 #include <QtDebug>
 #include <QGraphicsSceneMouseEvent>
@@ -25,9 +28,100 @@
 #include <QPainter>
 #include <QtCore>
 #include <QtGui>
+#include <algorithm>
 
 static const bool verbose = false;
 
+// Minimum time (in ms) between two position updates of a dragged item.
+#define DRAG_FRAME_INTERVAL 16
+
+
+/*
+ * Name:        collect_nodes
+ * Purpose:     Lists the nodes in an item.
+ * Arguments:   the item, the list, and the nodes listed so far
+ * Output:      none
+ * Modifies:    nodes, seen
+ * Returns:     none
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       A node is itself; a graph holds the nodes of its
+ *              children, which may be graphs too.  Other items hold
+ *              no nodes.
+ */
+
+static void
+collect_nodes(QGraphicsItem * item, QList<Node *> & nodes, QSet<Node *> & seen)
+{
+    if (item->type() == Node::Type)
+    {
+        Node * node = qgraphicsitem_cast<Node *>(item);
+        if (!seen.contains(node))
+        {
+            seen.insert(node);
+            nodes.append(node);
+        }
+    }
+    else if (item->type() == Graph::Type)
+        foreach (QGraphicsItem * child, item->childItems())
+            collect_nodes(child, nodes, seen);
+}
+
+
+/*
+ * Name:        nearest_free_point
+ * Purpose:     Finds the free grid point nearest a position.
+ * Arguments:   the position, its nearest grid point (in cells), the
+ *              cell size, the grid points already taken, and the first
+ *              ring around that point that may have a free point
+ * Output:      none
+ * Modifies:    *firstRing
+ * Returns:     the grid point, in cells
+ * Assumptions: The nearest grid point is taken.
+ * Bugs:        none
+ * Notes:       The rings of grid points around the nearest one are
+ *              searched outwards.  Every point of ring r is at least
+ *              (r - 1/2) cells from the position, so the search can
+ *              stop once that is further than the best point found.
+ *              Points are never freed, so the rings inside the first
+ *              one with a free point needn't be searched again; that
+ *              keeps a pile of nodes at one spot from taking
+ *              quadratic time.
+ */
+
+static QPoint
+nearest_free_point(QPointF pos, QPoint centre, QSize cell,
+                   const QSet<qint64> & taken, int * firstRing)
+{
+    const qreal near = qMin(cell.width(), cell.height());
+    QPoint best;
+    qreal bestDistance = -1;
+
+    for (int r = *firstRing;
+         bestDistance < 0 || (r - 0.5) * near <= bestDistance; r++)
+    {
+        if (bestDistance < 0)
+            *firstRing = r;
+        for (int dy = -r; dy <= r; dy++)
+            for (int dx = -r; dx <= r; dx += (dy == -r || dy == r) ? 1 : 2 * r)
+            {
+                QPoint point = centre + QPoint(dx, dy);
+                if (taken.contains(grid_key(point.x(), point.y())))
+                    continue;
+                qreal distance = QLineF(pos, QPointF(point.x() * cell.width(),
+                                                     point.y() * cell.height()))
+                    .length();
+                if (bestDistance < 0 || distance < bestDistance)
+                {
+                    best = point;
+                    bestDistance = distance;
+                }
+            }
+    }
+    return best;
+}
+
+
 CanvasScene::CanvasScene()
     :  mCellSize(25, 25)
 {
@@ -43,7 +137,14 @@ CanvasScene::CanvasScene()
     modeType = CanvasView::none;
     mDragged = nullptr;
     snapToGrid = true;
-    undoPositions = QList<undo_Node_Pos*>();
+
+    dragPending = false;
+    elasticDrag = false;
+    mElastic = nullptr;
+    groupDrag = false;
+    dragTimer.setSingleShot(true);
+    dragTimer.setInterval(DRAG_FRAME_INTERVAL);
+    connect(&dragTimer, SIGNAL(timeout()), this, SLOT(applyPendingDrag()));
 }
 
 void CanvasScene::dragMoveEvent(QGraphicsSceneDragDropEvent *event)
@@ -65,6 +166,11 @@ void CanvasScene::dropEvent(QGraphicsSceneDragDropEvent *event)
                           - graphItem->boundingRect().y());
         addItem(graphItem);
         graphItem->isMoved();
+        graphItem->setCached(getMode() == CanvasView::none);
+
+        CanvasEdit * edit = new CanvasEdit(this);
+        edit->added(graphItem);
+        record(edit);
         clearSelection();
     }
 }
@@ -185,49 +291,12 @@ void CanvasScene::mousePressEvent(QGraphicsSceneMouseEvent *event)
                             qDebug() << "Delete Node";
                         }
 
-                        Node * node = qgraphicsitem_cast<Node *>(item);
-
-                        // removes node from undolist if deleted
-                        // safety precaution to avoid null pointers
-                        for(int i = 0; i < undoPositions.length(); i++)
-                        {
-                            if (undoPositions.at(i)->node == node)
-                                undoPositions.removeAt(i);
-                        }
-
-                        // delete all edges incident to node that will be deleted
-                        foreach(Edge * edge, node->edgeList)
-                        {
-                            if (edge != nullptr || edge != 0)
-                            {
-                                edge->destNode()->removeEdge(edge);
-                                edge->sourceNode()->removeEdge(edge);
-
-                                edge->setParentItem(nullptr);
-                                removeItem(edge);
-                                delete edge;
-                                edge = nullptr;
-                            }
-                        }
-
-                        Graph * parent =
-                                qgraphicsitem_cast<Graph*>(node->parentItem());
-
-                        if (parent != nullptr || parent != 0)
-                        {
-                            if (parent->childItems().length() == 0)
-                            {
-                                parent->setParentItem(nullptr);
-                                removeItem(parent);
-                                delete parent;
-                                parent = nullptr;
-                            }
-                        }
-                        // delete the node
-                        node->setParentItem(nullptr);
-                        removeItem(node);
-                        delete node;
-                        node = nullptr;
+                        // Take the node and its edges off the canvas;
+                        // they are only deleted once the deletion can't
+                        // be undone any more.
+                        CanvasEdit * edit = new CanvasEdit(this);
+                        edit->removeNode(qgraphicsitem_cast<Node *>(item));
+                        record(edit);
                         break;
                     }
                     else if (item->type() == Edge::Type)
@@ -236,24 +305,38 @@ void CanvasScene::mousePressEvent(QGraphicsSceneMouseEvent *event)
                         {
                             qDebug() << "Delete Edge";
                         }
-                        Edge * edge = qgraphicsitem_cast<Edge *>(item);
-                        edge->destNode()->removeEdge(edge);
-                        edge->sourceNode()->removeEdge(edge);
-
-                        edge->setParentItem(nullptr);
-                        removeItem(edge);
-                        delete edge;
-                        edge = nullptr;
+                        CanvasEdit * edit = new CanvasEdit(this);
+                        edit->remove(item);
+                        record(edit);
                         break;
                     }
+                    else if (item->type() == ImplicitEdges::Type)
+                    {
+                        if (verbose) // debug statement
+                        {
+                            qDebug() << "Delete Implicit Edge";
+                        }
+                        // contains() only tests the bounding box; find
+                        // the edge itself, or look further down.
+                        ImplicitEdges * implicit
+                                = static_cast<ImplicitEdges *>(item);
+                        Node * source, * dest;
+                        if (implicit->pairAt(implicit->mapFromScene(
+                                                 event->scenePos()),
+                                             &source, &dest))
+                        {
+                            CanvasEdit * edit = new CanvasEdit(this);
+                            edit->removePair(implicit, source, dest);
+                            record(edit);
+                            break;
+                        }
+                    }
                 }
             }
             break;
         }
         case CanvasView::edit:
         {
-            undo_Node_Pos *  undoPos = new undo_Node_Pos();
-
             foreach(QGraphicsItem * item, itemList)
             {
                 if (item->type() == Node::Type)
@@ -261,9 +344,29 @@ void CanvasScene::mousePressEvent(QGraphicsSceneMouseEvent *event)
                     if (event->button() == Qt::LeftButton)
                     {
                         mDragged = qgraphicsitem_cast<Node*>(item);
-                        undoPos->node = qgraphicsitem_cast<Node *>(mDragged);
-                        undoPos->pos = mDragged->pos();
-                        undoPositions.append(undoPos);
+                        dragItems.clear();
+                        dragItems.append(mDragged);
+                        groupDrag = false;
+                        if (mDragged->isSelected())
+                        {
+                            // Drag the rest of the selection along.
+                            foreach (QGraphicsItem * chosen, selectedItems())
+                                if (chosen->type() == Node::Type
+                                    && chosen != mDragged)
+                                    dragItems.append(chosen);
+                            groupDrag = dragItems.count() > 1;
+                        }
+                        if (elasticDrag && !groupDrag)
+                        {
+                            delete mElastic;
+                            mElastic = new ElasticDrag(
+                                        qgraphicsitem_cast<Node *>(mDragged));
+                            foreach (Node * node, mElastic->movedNodes())
+                                dragItems.append(node);
+                        }
+                        dragStart.resize(dragItems.count());
+                        for (int i = 0; i < dragItems.count(); i++)
+                            dragStart[i] = dragItems.at(i)->pos();
                         if (snapToGrid)
                         {
                             if (verbose)
@@ -272,6 +375,27 @@ void CanvasScene::mousePressEvent(QGraphicsSceneMouseEvent *event)
                         }
                     }
                 }
+                else if (item->type() == ImplicitEdges::Type
+                         && event->button() == Qt::LeftButton
+                         && mDragged == nullptr)
+                {
+                    // Give the edge clicked on (if no node was) its
+                    // own Edge, so that it can be edited like any other.
+                    // contains() only tests the bounding box, so there
+                    // may be no edge here.
+                    ImplicitEdges * implicit
+                            = static_cast<ImplicitEdges *>(item);
+                    Node * source, * dest;
+                    if (implicit->pairAt(implicit->mapFromScene(
+                                             event->scenePos()),
+                                         &source, &dest))
+                    {
+                        Edge * edge = implicit->materializePair(source, dest);
+                        if (edge != nullptr)
+                            edge->editWeight(true);
+                        break;
+                    }
+                }
 
             }
             if (mDragged != nullptr)
@@ -291,6 +415,9 @@ void CanvasScene::mousePressEvent(QGraphicsSceneMouseEvent *event)
                             mDragged = mDragged->parentItem();
 
                         mDragOffset = event->scenePos() - mDragged->pos();
+                        dragItems.clear();
+                        dragItems.append(mDragged);
+                        dragStart.fill(mDragged->pos(), 1);
 
                         QGraphicsScene::mousePressEvent(event);
                         break;
@@ -318,17 +445,59 @@ void CanvasScene::mouseMoveEvent(QGraphicsSceneMouseEvent *event)
         if (mDragged->type() == Graph::Type)
         {
             // Ensure that the item's offset from the mouse cursor stays the same.
-            mDragged->setPos(event->scenePos() - mDragOffset);
+            mPendingPos = event->scenePos() - mDragOffset;
         }
         else if (mDragged->type() == Node::Type)
         {
-            mDragged->setPos(mDragged->mapToParent(mDragged->mapFromScene(event->scenePos())));
+            mPendingPos = mDragged->mapToParent(mDragged->mapFromScene(event->scenePos()));
         }
+        else
+            return;
+
+        // Move the item at most once per frame; moves that arrive in
+        // between only update the position that will be applied.
+        dragPending = true;
+        if (!dragTimer.isActive())
+            applyPendingDrag();
     }
 }
 
+/*
+ * Name:        applyPendingDrag()
+ * Purpose:     Moves the dragged item to the last position requested by
+ *              mouseMoveEvent().
+ * Arguments:   none
+ * Output:      none
+ * Modifies:    the position of mDragged, dragPending, dragTimer
+ * Returns:     none
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       Restarts dragTimer after each move, so a stream of mouse
+ *              moves results in at most one setPos() per
+ *              DRAG_FRAME_INTERVAL ms.  In an elastic drag the
+ *              dragged node's neighbourhood is relaxed on each move.
+ */
+void CanvasScene::applyPendingDrag()
+{
+    if (!dragPending || mDragged == nullptr)
+        return;
+
+    dragPending = false;
+    if (groupDrag)
+        moveGroup(mPendingPos);
+    else
+        mDragged->setPos(mPendingPos);
+    if (mElastic != nullptr)
+        mElastic->relax();
+    dragTimer.start();
+}
+
 void CanvasScene::mouseReleaseEvent(QGraphicsSceneMouseEvent *event)
 {
+    // Don't lose the last move of the drag.
+    dragTimer.stop();
+    applyPendingDrag();
+
     if (mDragged && snapToGrid && (getMode() == CanvasView::none || getMode() == CanvasView::edit))
     {
         int x = 0;
@@ -347,12 +516,47 @@ void CanvasScene::mouseReleaseEvent(QGraphicsSceneMouseEvent *event)
 
             x = round(mDragged->pos().x() / mCellSize.width()) * mCellSize.width();
             y = round(mDragged->pos().y() / mCellSize.height()) * mCellSize.height();
-            mDragged->setPos(x , y);
-            clearSelection();
+            if (groupDrag)
+                moveGroup(QPointF(x, y));
+            else
+                mDragged->setPos(x , y);
+            if (mElastic != nullptr)
+                mElastic->relax();
+            if (!groupDrag)
+                clearSelection();
         }
     }
+    if (mDragged && mDragged->type() == Node::Type)
+    {
+        // The nodes moved without their graphs being told; do that
+        // once now.  (dragItems holds every node the drag can move.)
+        QSet<Graph *> graphs;
+        foreach (QGraphicsItem * node, dragItems)
+        {
+            Graph * graph = qgraphicsitem_cast<Graph *>(node->parentItem());
+            if (graph != nullptr)
+                graphs.insert(graph);
+        }
+        foreach (Graph * graph, graphs)
+            graph->updateBounds();
+    }
+    if (mDragged)
+    {
+        // The whole drag is undone in one step.
+        CanvasEdit * edit = new CanvasEdit(this);
+        for (int i = 0; i < dragItems.count(); i++)
+            edit->moved(dragItems.at(i), dragStart.at(i));
+        record(edit);
+    }
+    dragItems.clear();
+    delete mElastic;
+    mElastic = nullptr;
     mDragged = nullptr;
-    clearSelection();
+    dragPending = false;
+    // A dragged selection stays selected, so it can be dragged again.
+    if (!groupDrag)
+        clearSelection();
+    groupDrag = false;
     QGraphicsScene::mouseReleaseEvent(event);
 
 
@@ -380,8 +584,9 @@ void CanvasScene::mouseDoubleClickEvent(QGraphicsSceneMouseEvent *event)
                       && graph->parentItem()->type() == Graph::Type)
                     graph = qgraphicsitem_cast<Graph*>(graph->parentItem());
 
-                removeItem(graph);
-                delete graph;
+                CanvasEdit * edit = new CanvasEdit(this);
+                edit->remove(graph);
+                record(edit);
                 graph = nullptr;
             }
         }
@@ -404,6 +609,7 @@ void CanvasScene::keyReleaseEvent(QKeyEvent *event)
 
         Graph * item = new Graph();
         item->isMoved();
+        CanvasEdit * edit = new CanvasEdit(this);
         Graph * root1 = nullptr;
         Graph * root2 = nullptr;
         if (connectNode1a != nullptr && connectNode2a != nullptr
@@ -448,7 +654,7 @@ void CanvasScene::keyReleaseEvent(QKeyEvent *event)
                     root2 = qgraphicsitem_cast<Graph*>(connectNode2a->parentItem());
                     while (root2->parentItem() != nullptr)
                         root2 =  qgraphicsitem_cast<Graph*>(root2->parentItem());
-                    root2->setRotation(qRadiansToDegrees(-angle));
+                    edit->rotate(root2, qRadiansToDegrees(-angle));
                 }
 
                 if (connectNode1a->parentItem() != nullptr)
@@ -464,27 +670,19 @@ void CanvasScene::keyReleaseEvent(QKeyEvent *event)
                         - connectNode2a->scenePos().ry();
 
                 if (root2)
-                    root2->moveBy(deltaX, deltaY);
+                    edit->move(root2, root2->pos() + QPointF(deltaX, deltaY));
+
+                // Edges are about to be moved from node to node, which
+                // implicit edge sets can't do.
+                edit->materializeAll(root2);
 
                 //set connectNode2a edges to connectNode1a edges
                 foreach(Edge * edge, connectNode2a->edges())
-                {
-                    if (edge->sourceNode() == connectNode2a)
-                        edge->setSourceNode(connectNode1a);
-                    else
-                        edge->setDestNode(connectNode1a);
-                    connectNode1a->addEdge(edge);
-                }
+                    edit->setEnd(edge, connectNode2a, connectNode1a);
 
                 //set connectNode2b edges to connectNode1b edges
                 foreach(Edge * edge, connectNode2b->edges())
-                {
-                    if (edge->sourceNode() == connectNode2b)
-                        edge->setSourceNode(connectNode1b);
-                    else
-                        edge->setDestNode(connectNode1b);
-                    connectNode1b->addEdge(edge);
-                }
+                    edit->setEnd(edge, connectNode2b, connectNode1b);
 
                 bool check;
                 connectNode1a->getLabel().toInt(&check);
@@ -495,8 +693,8 @@ void CanvasScene::keyReleaseEvent(QKeyEvent *event)
                     {
                         if (i->type() == Node::Type)
                         {
-                            Node * node = qgraphicsitem_cast<Node*>(i);
-                            node->setNodeLabel(count);
+                            edit->restyle(i, CanvasEdit::NodeLabel,
+                                          (qreal)count);
                             count++;
                         }
                     }
@@ -504,26 +702,21 @@ void CanvasScene::keyReleaseEvent(QKeyEvent *event)
                     {
                         if (i->type() == Node::Type && i != connectNode2a && i != connectNode2b)
                         {
-                            Node * node = qgraphicsitem_cast<Node*>(i);
-                           // node->setRotation(qRadiansToDegrees(angle));
-                            node->setNodeLabel(count);
+                            edit->restyle(i, CanvasEdit::NodeLabel,
+                                          (qreal)count);
                             count++;
                         }
                     }
                 }
 
-                root2->setParentItem(item);
-                root1->setParentItem(item);
                 addItem(item);
+                edit->added(item);
+                edit->reparent(root2, item);
+                edit->reparent(root1, item);
 
                 //dispose of unneeded nodes
-                connectNode2a->setParentItem(nullptr);
-                removeItem(connectNode2a);
-                delete connectNode2a;
-
-                connectNode2b->setParentItem(nullptr);
-                removeItem(connectNode2b);
-                delete connectNode2b;
+                edit->removeNode(connectNode2a);
+                edit->removeNode(connectNode2b);
 
                 connectNode1a->chosen(0);
                 connectNode1b->chosen(0);
@@ -547,7 +740,7 @@ void CanvasScene::keyReleaseEvent(QKeyEvent *event)
                 root2 = qgraphicsitem_cast<Graph*>(connectNode2a->parentItem());
                 while (root2->parentItem() != nullptr)
                     root2 = qgraphicsitem_cast<Graph*>(root2->parentItem());
-                root2->moveBy(deltaX, deltaY);
+                edit->move(root2, root2->pos() + QPointF(deltaX, deltaY));
 
             }
 
@@ -558,13 +751,13 @@ void CanvasScene::keyReleaseEvent(QKeyEvent *event)
                     root1 =  qgraphicsitem_cast<Graph*>(root1->parentItem());
             }
 
+            // Edges are about to be moved from node to node, which
+            // implicit edge sets can't do.
+            edit->materializeAll(root2);
+
             foreach(Edge * edge, connectNode2a->edges())
             {
-                if (edge->sourceNode() == connectNode2a)
-                    edge->setSourceNode(connectNode1a);
-                else
-                    edge->setDestNode(connectNode1a);
-                connectNode1a->addEdge(edge);
+                edit->setEnd(edge, connectNode2a, connectNode1a);
                 edge->setZValue(0);
                 connectNode1a->setZValue(3);
             }
@@ -579,9 +772,7 @@ void CanvasScene::keyReleaseEvent(QKeyEvent *event)
                 {
                     if (i->type() == Node::Type)
                     {
-                        Node * node = qgraphicsitem_cast<Node*>(i);
-
-                        node->setNodeLabel(count);
+                        edit->restyle(i, CanvasEdit::NodeLabel, (qreal)count);
                         count++;
                     }
                 }
@@ -589,54 +780,40 @@ void CanvasScene::keyReleaseEvent(QKeyEvent *event)
                 {
                     if (i->type() == Node::Type && i != connectNode2a )
                     {
-                        Node * node = qgraphicsitem_cast<Node*>(i);
-                        node->setNodeLabel(count);
+                        edit->restyle(i, CanvasEdit::NodeLabel, (qreal)count);
                         count++;
                     }
                 }
             }
-            root2->setParentItem(item);
-            root1->setParentItem(item);
             addItem(item);
+            edit->added(item);
+            edit->reparent(root2, item);
+            edit->reparent(root1, item);
             //properly dispose of unneeded node
 
-            removeItem(connectNode2a);
-            delete connectNode2a;
+            edit->removeNode(connectNode2a);
             connectNode2a = nullptr;
             connectNode1a->chosen(0);
 
         }
-        if (connectNode1a)
-        {
-            connectNode1a->chosen(0);
-            connectNode1a = nullptr;
-        }
-        if (connectNode2a)
-        {
-            connectNode2a->chosen(0);
-            connectNode2a = nullptr;
-        }
-        if (connectNode1b)
-        {
-            connectNode1b->chosen(0);
-            connectNode1b = nullptr;
-        }
-        if (connectNode2b)
-        {
-            connectNode2b->chosen(0);
-            connectNode2b = nullptr;
-        }
+        // The join is undone in one step.  If nothing was joined, the
+        // new graph isn't needed.
+        if (edit->isEmpty())
+            delete item;
+        record(edit);
+        forgetJoinNodes();
         clearSelection();
     }
         break;
     case Qt::Key_Escape:
-    {
-        if (undoPositions.length() > 0)
-        {
-            undoPositions.last()->node->setPos(undoPositions.last()->pos);
-            undoPositions.removeLast();
-        }
-    }
+        undo();
+        break;
+    case Qt::Key_Delete:
+    case Qt::Key_Backspace:
+        // Unless it was meant for a label being edited.
+        if (focusItem() == nullptr || focusItem()->type() != Label::Type)
+            deleteSelection();
+        break;
     default:
         break;
     }
@@ -648,30 +825,17 @@ void CanvasScene::setCanvasMode(int mode)
 {
     modeType = mode;
 
-    if (connectNode1a)
-    {
-        connectNode1a->chosen(0);
-        connectNode1a = nullptr;
-    }
-    if (connectNode2a)
-    {
-        connectNode2a->chosen(0);
-        connectNode2a = nullptr;
-    }
-    if (connectNode1b)
-    {
-        connectNode1b->chosen(0);
-        connectNode1b = nullptr;
-    }
-    if (connectNode2b)
-    {
-        connectNode2b->chosen(0);
-        connectNode2b = nullptr;
-    }
-    undoPositions.clear();
+    forgetJoinNodes();
+    clearSelection();
     foreach (QGraphicsItem * item, items())
     {
-        if (item->type() == Node::Type)
+        if (item->type() == Graph::Type && item->parentItem() == nullptr)
+        {
+            // Only graphs that are just being looked at are cached.
+            Graph * graph = qgraphicsitem_cast<Graph *>(item);
+            graph->setCached(modeType == CanvasView::none);
+        }
+        else if (item->type() == Node::Type)
         {
             Node * node = qgraphicsitem_cast<Node *>(item);
             if (modeType == CanvasView::edit)
@@ -708,7 +872,409 @@ void CanvasScene::isSnappedToGrid(bool snap)
     snapToGrid = snap;
 }
 
+void CanvasScene::setElasticDrag(bool elastic)
+{
+    elasticDrag = elastic;
+}
+
+
+/*
+ * Name:        snapNodesToGrid
+ * Purpose:     Moves every selected node (or every node of a selected
+ *              graph) to the grid.
+ * Arguments:   none
+ * Output:      none
+ * Modifies:    the nodes, their edges and their graphs
+ * Returns:     none
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       With nothing selected, every node on the canvas is
+ *              snapped.  Each node goes to the grid point nearest it
+ *              (in scene coordinates), the nodes nearest their points
+ *              first; a node whose point is already taken goes to the
+ *              nearest free one instead, so no two nodes end up on top
+ *              of each other.
+ *              The nodes are moved without sending geometry changes,
+ *              and then each affected edge is adjusted once, and each
+ *              graph's bounds are refreshed once, instead of once per
+ *              node moved.  The scene repaints once, afterwards.
+ *              The whole snap is undone in one step.
+ */
+
+void CanvasScene::snapNodesToGrid()
+{
+    QList<QGraphicsItem *> chosen = selectedItems();
+    QList<Node *> nodes;
+    QSet<Node *> seen;
+
+    if (chosen.isEmpty())
+        chosen = items();
+    foreach (QGraphicsItem * item, chosen)
+        collect_nodes(item, nodes, seen);
+
+    const int n = nodes.count();
+    const qreal w = mCellSize.width(), h = mCellSize.height();
+    QVector<QPointF> from(n);
+    QVector<QPoint> to(n);
+    QVector<QPair<qreal, int> > order(n);
+    for (int i = 0; i < n; i++)
+    {
+        from[i] = nodes.at(i)->scenePos();
+        to[i] = QPoint(qRound(from.at(i).x() / w), qRound(from.at(i).y() / h));
+        order[i] = qMakePair(QLineF(from.at(i), QPointF(to.at(i).x() * w,
+                                                        to.at(i).y() * h))
+                             .length(), i);
+    }
+    std::sort(order.begin(), order.end());
+
+    QSet<qint64> taken;
+    QHash<qint64, int> firstRings;
+    taken.reserve(n);
+    for (int k = 0; k < n; k++)
+    {
+        int i = order.at(k).second;
+        qint64 key = grid_key(to.at(i).x(), to.at(i).y());
+        if (taken.contains(key))
+        {
+            int firstRing = firstRings.value(key, 1);
+            to[i] = nearest_free_point(from.at(i), to.at(i), mCellSize, taken,
+                                       &firstRing);
+            firstRings.insert(key, firstRing);
+            key = grid_key(to.at(i).x(), to.at(i).y());
+        }
+        taken.insert(key);
+    }
+
+    Node_Moves moves;
+    CanvasEdit * edit = new CanvasEdit(this);
+    for (int i = 0; i < n; i++)
+    {
+        Node * node = nodes.at(i);
+        QPointF target(to.at(i).x() * w, to.at(i).y() * h);
+        if (target == from.at(i))
+            continue;
+
+        QGraphicsItem * parent = node->parentItem();
+        QPointF oldPos = node->pos();
+        node->moveQuietly(parent != nullptr ? parent->mapFromScene(target)
+                          : target, moves);
+        edit->moved(node, oldPos);
+    }
+    Node::finishMoves(moves);
+    record(edit);
+}
+
 int CanvasScene::getMode() const
 {
     return modeType;
 }
+
+
+/*
+ * Name:        undoStack
+ * Purpose:     Gives the history of edits of the canvas.
+ * Arguments:   none
+ * Output:      none
+ * Modifies:    none
+ * Returns:     the history
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       The Edit menu follows its canUndoChanged() and
+ *              canRedoChanged() signals.
+ */
+
+UndoStack * CanvasScene::undoStack()
+{
+    return &history;
+}
+
+
+/*
+ * Name:        record
+ * Purpose:     Adds an edit that has just been made to the history.
+ * Arguments:   the edit
+ * Output:      none
+ * Modifies:    history
+ * Returns:     none
+ * Assumptions: The edit was allocated with new.
+ * Bugs:        none
+ * Notes:       An edit that changed nothing is just deleted.
+ */
+
+void CanvasScene::record(CanvasEdit * edit)
+{
+    if (edit->isEmpty())
+        delete edit;
+    else
+        history.push(edit);
+}
+
+
+/*
+ * Name:        undo
+ * Purpose:     Undoes the last edit of the canvas.
+ * Arguments:   none
+ * Output:      none
+ * Modifies:    the canvas, history
+ * Returns:     none
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       The nodes chosen for a join, and any drag under way, are
+ *              forgotten first, since the edit may take them off the
+ *              canvas.
+ */
+
+void CanvasScene::undo()
+{
+    forgetJoinNodes();
+    delete mElastic;
+    mElastic = nullptr;
+    mDragged = nullptr;
+    dragPending = false;
+    dragItems.clear();
+    groupDrag = false;
+    history.undo();
+}
+
+
+/*
+ * Name:        redo
+ * Purpose:     Redoes the last edit of the canvas undone.
+ * Arguments:   none
+ * Output:      none
+ * Modifies:    the canvas, history
+ * Returns:     none
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       As for undo().
+ */
+
+void CanvasScene::redo()
+{
+    forgetJoinNodes();
+    delete mElastic;
+    mElastic = nullptr;
+    mDragged = nullptr;
+    dragPending = false;
+    dragItems.clear();
+    groupDrag = false;
+    history.redo();
+}
+
+
+/*
+ * Name:        forgetJoinNodes
+ * Purpose:     Unchooses the nodes chosen for a join.
+ * Arguments:   none
+ * Output:      none
+ * Modifies:    connectNode1a, connectNode2a, connectNode1b, connectNode2b
+ * Returns:     none
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       none
+ */
+
+void CanvasScene::forgetJoinNodes()
+{
+    if (connectNode1a)
+    {
+        connectNode1a->chosen(0);
+        connectNode1a = nullptr;
+    }
+    if (connectNode2a)
+    {
+        connectNode2a->chosen(0);
+        connectNode2a = nullptr;
+    }
+    if (connectNode1b)
+    {
+        connectNode1b->chosen(0);
+        connectNode1b = nullptr;
+    }
+    if (connectNode2b)
+    {
+        connectNode2b->chosen(0);
+        connectNode2b = nullptr;
+    }
+}
+
+
+/*
+ * Name:        moveGroup
+ * Purpose:     Moves the selected nodes being dragged.
+ * Arguments:   the new position of mDragged (in its parent's
+ *              coordinates)
+ * Output:      none
+ * Modifies:    the nodes in dragItems and their edges
+ * Returns:     none
+ * Assumptions: groupDrag is set.
+ * Bugs:        none
+ * Notes:       Each node moves as far (in scene coordinates) from where
+ *              it was when the drag started as mDragged does, whatever
+ *              graph it is in.  The nodes are moved as one batch (see
+ *              Node::moveQuietly()); the graphs' bounds are refreshed
+ *              when the drag is over.
+ */
+
+void CanvasScene::moveGroup(QPointF pos)
+{
+    QGraphicsItem * parent = mDragged->parentItem();
+    QPointF delta = parent != nullptr
+        ? parent->mapToScene(pos) - parent->mapToScene(dragStart.at(0))
+        : pos - dragStart.at(0);
+    Node_Moves moves;
+
+    for (int i = 0; i < dragItems.count(); i++)
+    {
+        Node * node = qgraphicsitem_cast<Node *>(dragItems.at(i));
+        QPointF target = dragStart.at(i);
+        parent = node->parentItem();
+        if (parent != nullptr)
+            target = parent->mapFromScene(parent->mapToScene(target) + delta);
+        else
+            target += delta;
+
+        node->moveQuietly(target, moves);
+    }
+    Node::finishMoves(moves, false);
+}
+
+
+/*
+ * Name:        selectArea
+ * Purpose:     Selects the nodes and edges inside an area.
+ * Arguments:   the area, in scene coordinates
+ * Output:      none
+ * Modifies:    the selection
+ * Returns:     none
+ * Assumptions: none
+ * Bugs:        Single edges of an ImplicitEdges can't be selected.
+ * Notes:       Used for the rubber band and lasso of CanvasView.  An
+ *              item must lie wholly inside the area; what was selected
+ *              already stays selected.
+ */
+
+void CanvasScene::selectArea(const QPainterPath & area)
+{
+    foreach (QGraphicsItem * item, items(area, Qt::ContainsItemShape))
+        if (item->type() == Node::Type || item->type() == Edge::Type)
+            item->setSelected(true);
+}
+
+
+void CanvasScene::selectAll()
+{
+    foreach (QGraphicsItem * item, items())
+        if (item->type() == Node::Type || item->type() == Edge::Type)
+            item->setSelected(true);
+}
+
+
+/*
+ * Name:        deleteSelection
+ * Purpose:     Deletes the selected nodes and edges.
+ * Arguments:   none
+ * Output:      none
+ * Modifies:    the canvas, history
+ * Returns:     none
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       A selected graph stands for all of its nodes.  The
+ *              selection is cleared first, so that the scene doesn't
+ *              announce a change of selection for every item taken
+ *              off.  Then everything is taken off in one CanvasEdit,
+ *              so it is undone in one step; the edges of the nodes
+ *              go with them, and each graph's bounds are invalidated
+ *              only once (see Graph::updateBounds()).
+ */
+
+void CanvasScene::deleteSelection()
+{
+    QList<Node *> nodes;
+    QSet<Node *> seen;
+    QList<Edge *> edges;
+
+    foreach (QGraphicsItem * item, selectedItems())
+    {
+        collect_nodes(item, nodes, seen);
+        if (item->type() == Edge::Type)
+            edges.append(qgraphicsitem_cast<Edge *>(item));
+    }
+    if (nodes.isEmpty() && edges.isEmpty())
+        return;
+
+    clearSelection();
+    forgetJoinNodes();
+    CanvasEdit * edit = new CanvasEdit(this);
+    foreach (Edge * edge, edges)
+        if (!seen.contains(edge->sourceNode())
+            && !seen.contains(edge->destNode()))
+            edit->remove(edge);
+    foreach (Node * node, nodes)
+        edit->removeNode(node);
+    record(edit);
+}
+
+
+/*
+ * Name:        recolourSelection
+ * Purpose:     Gives the selected nodes and edges a new colour.
+ * Arguments:   the colour
+ * Output:      none
+ * Modifies:    the selected items, history
+ * Returns:     none
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       Nodes get it as their fill colour, edges as their line
+ *              colour.  Undone in one step.
+ */
+
+void CanvasScene::recolourSelection(QColor colour)
+{
+    CanvasEdit * edit = new CanvasEdit(this);
+
+    foreach (QGraphicsItem * item, selectedItems())
+    {
+        if (item->type() == Node::Type)
+            edit->restyle(item, CanvasEdit::NodeFill, colour);
+        else if (item->type() == Edge::Type)
+            edit->restyle(item, CanvasEdit::EdgeColour, colour);
+    }
+    record(edit);
+}
+
+
+/*
+ * Name:        resizeSelection
+ * Purpose:     Scales the selected nodes and edges.
+ * Arguments:   the scale (1 leaves them as they are)
+ * Output:      none
+ * Modifies:    the selected items, history
+ * Returns:     none
+ * Assumptions: scale > 0
+ * Bugs:        none
+ * Notes:       Nodes have their diameters scaled, edges their widths.
+ *              Undone in one step.
+ */
+
+void CanvasScene::resizeSelection(qreal scale)
+{
+    CanvasEdit * edit = new CanvasEdit(this);
+
+    foreach (QGraphicsItem * item, selectedItems())
+    {
+        if (item->type() == Node::Type)
+        {
+            Node * node = qgraphicsitem_cast<Node *>(item);
+            edit->restyle(item, CanvasEdit::NodeDiameter,
+                          node->getDiameter() * scale);
+        }
+        else if (item->type() == Edge::Type)
+        {
+            Edge * edge = qgraphicsitem_cast<Edge *>(item);
+            edit->restyle(item, CanvasEdit::EdgeWidth,
+                          edge->getPenWidth() * scale);
+        }
+    }
+    record(edit);
+}
@@ -16,24 +16,38 @@
 
 #include "node.h"
 #include "mainwindow.h"
+#include "elasticdrag.h"
+#include "undostack.h"
 
 #include <QGraphicsScene>
+#include <QPainterPath>
+#include <QTimer>
+
+class CanvasEdit;
 
 class CanvasScene : public QGraphicsScene
 {
-public:
-
-    typedef struct undoPositions
-    {
-        QPointF pos;
-        Node * node;
-    } undo_Node_Pos;
+    Q_OBJECT
 
+public:
     CanvasScene();
     void isSnappedToGrid(bool snap);
+    void setElasticDrag(bool elastic);
+    void snapNodesToGrid();
     void getConnectionNodes();
     int getMode() const;
     void setCanvasMode(int mode);
+    UndoStack * undoStack();
+    void record(CanvasEdit * edit);
+    void selectArea(const QPainterPath & area);
+    void selectAll();
+    void deleteSelection();
+    void recolourSelection(QColor colour);
+    void resizeSelection(qreal scale);
+
+public slots:
+    void undo();
+    void redo();
 
 protected:
     void dragMoveEvent (QGraphicsSceneDragDropEvent * event);
@@ -45,7 +59,13 @@ protected:
     void mouseDoubleClickEvent(QGraphicsSceneMouseEvent * event);
     void keyReleaseEvent(QKeyEvent *event);
 
+private slots:
+    void applyPendingDrag();
+
 private:
+    void forgetJoinNodes();
+    void moveGroup(QPointF pos);
+
     int numOfNodes, modeType;
     bool snapToGrid;
     const QSize mCellSize;		// The size of the cells in the grid.
@@ -53,8 +73,16 @@ private:
     Node * connectNode1a, * connectNode1b; // The first Nodes to be joined.
     Node * connectNode2a, * connectNode2b; // The second Nodes to be joined.
     QPointF mDragOffset;
-    QList<undo_Node_Pos *> undoPositions;
     // The distance from the top left of the item to the mouse position.
+    QTimer dragTimer;			// Limits drag updates to the frame rate.
+    QPointF mPendingPos;		// Where mDragged goes on the next frame.
+    bool dragPending;
+    bool elasticDrag;			// Drag a node's neighbours along?
+    ElasticDrag * mElastic;		// The springs of the current drag.
+    QList<QGraphicsItem *> dragItems;	// The items the drag may move,
+    QVector<QPointF> dragStart;		// and where they were.
+    bool groupDrag;			// Is the selection being dragged?
+    UndoStack history;			// The edits that can be undone.
 };
 
 #endif // CANVASSCENE_H
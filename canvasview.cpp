@@ -17,15 +17,51 @@
 #include "edge.h"
 #include "node.h"
 #include "graph.h"
+#include "canvasedit.h"
+#include "implicitedges.h"
 
 #include <math.h>
 #include <QKeyEvent>
 #include <QDebug>
 #include <QGraphicsSceneMouseEvent>
 #include <QPointF>
+#include <QPixmapCache>
+#include <QPainter>
+#include <QElapsedTimer>
+#include <QStyleOptionGraphicsItem>
+#include <QtConcurrent/QtConcurrentMap>
 
 static const bool verbose = true;
 
+// Size (in KB) of the pixmap cache that holds the images of idle graphs.
+#define GRAPH_CACHE_LIMIT   (64 * 1024)
+
+// Width and height (in pixels) of the tiles used by tiled rendering.
+#define RENDER_TILE_SIZE    256
+
+// Number of frames between two reports of the average frame times.
+#define FRAME_REPORT_PERIOD 100
+
+// If this environment variable is set (to anything), the average frame
+// times of the direct and the tiled renderer are reported.
+#define FRAME_REPORT_VARIABLE "GRAPHIC_FRAME_TIMES"
+
+// An item to be painted by the tiled renderer.
+typedef struct tItem
+{
+    QGraphicsItem * item;
+    QTransform transform;	// Item to viewport coordinates.
+    int option;			// Index into the style options.
+} Tile_Item;
+
+// One tile of the viewport and the items that touch it.
+typedef struct rTile
+{
+    QRect rect;			// In viewport coordinates.
+    QVector<int> items;		// Indices into the Tile_Item list.
+    QImage image;
+} Render_Tile;
+
 static const QString JOIN_DESCRIPTION =
     "Join mode: Select one or two nodes from each graph and press 'J'.  "
     "The first selected node from graph 1 is joined to the first selected "
@@ -34,10 +70,14 @@ static const QString JOIN_DESCRIPTION =
 
 static const QString DELETE_DESCRIPTION =
     "Delete mode: Click on any node or edge to be deleted.  "
-    "Double Click on a graph to delete it entirely.";
+    "Double Click on a graph to delete it entirely.  "
+    "Drag out a box (or, with Shift, a lasso) to select nodes and edges, "
+    "and press Delete to delete them all.";
 
 static const QString EDIT_DESCRIPTION =
-    "Edit mode: Move individual nodes around within a graph.";
+    "Edit mode: Move individual nodes around within a graph.  "
+    "Drag out a box (or, with Shift, a lasso) to select nodes and edges; "
+    "dragging a selected node moves them all.";
 
 static const QString FREESTYLE_DESCRIPTION =
     "You can add nodes by double clicking and edges by left "
@@ -65,6 +105,8 @@ CanvasView::CanvasView(QWidget * parent)
     setRenderHints(QPainter::Antialiasing | QPainter::SmoothPixmapTransform);
     setAcceptDrops(true);
     setScene(aScene);
+    if (QPixmapCache::cacheLimit() < GRAPH_CACHE_LIMIT)
+        QPixmapCache::setCacheLimit(GRAPH_CACHE_LIMIT);
 
     nodeParams = new Node_Params;
     edgeParams = new Edge_Params;
@@ -72,6 +114,13 @@ CanvasView::CanvasView(QWidget * parent)
     setMode(mode::none);
     node1 = nullptr;
     node2 = nullptr;
+
+    tiledRendering = false;
+    reportFrameTimes = qEnvironmentVariableIsSet(FRAME_REPORT_VARIABLE);
+    frameTime[0] = frameTime[1] = 0;
+    frameCount[0] = frameCount[1] = 0;
+    selecting = false;
+    lasso = false;
 }
 
 
@@ -98,6 +147,10 @@ Node * CanvasView::createNode(QPointF pos)
     node->setLineColour(nodeParams->outlineColour);
     node->setPos(pos.rx(), pos.ry());
     node->setParentItem(freestyleGraph);
+
+    CanvasEdit * edit = new CanvasEdit(aScene);
+    edit->added(node);
+    aScene->record(edit);
     return node;
 }
 
@@ -200,6 +253,9 @@ void CanvasView::mousePressEvent(QMouseEvent * event)
     switch(getMode())
     {
       case(mode::freestyle):
+	// A node taken off the canvas (by an undo, say) can't get edges.
+	if (node1 != nullptr && node1->scene() == nullptr)
+	    node1 = nullptr;
 	if (event->button() == Qt::LeftButton)
 	{
 	    foreach(QGraphicsItem * item, itemList)
@@ -228,6 +284,42 @@ void CanvasView::mousePressEvent(QMouseEvent * event)
 	}
 	break;
 
+      case mode::del:
+      case mode::edit:
+	if (event->button() == Qt::LeftButton)
+	{
+	    bool onItem = false;
+	    QList<ImplicitEdges *> implicits;
+	    foreach (QGraphicsItem * item, itemList)
+		if (item->type() == Node::Type || item->type() == Edge::Type
+		    || item->type() == Label::Type)
+		    onItem = true;
+		else if (item->type() == ImplicitEdges::Type)
+		    implicits.append(static_cast<ImplicitEdges *>(item));
+	    // ImplicitEdges::contains() only tests the bounding box, so
+	    // look for the edge itself, and only if nothing else was hit.
+	    for (int i = 0; i < implicits.count() && !onItem; i++)
+	    {
+		Node * source, * dest;
+		onItem = implicits.at(i)->pairAt(
+		    implicits.at(i)->mapFromScene(mapToScene(event->pos())),
+		    &source, &dest);
+	    }
+	    if (!onItem)
+	    {
+		// Start a rubber band (or, with Shift, a lasso).  Ctrl
+		// adds to the selection.
+		selecting = true;
+		lasso = event->modifiers() & Qt::ShiftModifier;
+		selectionStart = mapToScene(event->pos());
+		selectionPath = QPainterPath(selectionStart);
+		if (!(event->modifiers() & Qt::ControlModifier))
+		    aScene->clearSelection();
+		break;
+	    }
+	}
+	// Fall through.
+
       default:
 	node1 = nullptr;
 	node2 = nullptr;
@@ -236,6 +328,99 @@ void CanvasView::mousePressEvent(QMouseEvent * event)
 }
 
 
+/*
+ * Name:        mouseMoveEvent
+ * Purpose:     Grows the rubber band or lasso being drawn.
+ * Arguments:   QMouseEvent
+ * Output:      none
+ * Modifies:    selectionPath
+ * Returns:     none
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       Only the part of the viewport the area covered or
+ *              covers now is repainted.
+ */
+
+void CanvasView::mouseMoveEvent(QMouseEvent * event)
+{
+    if (!selecting)
+    {
+	QGraphicsView::mouseMoveEvent(event);
+	return;
+    }
+
+    QRectF old = selectionPath.boundingRect();
+    QPointF pt = mapToScene(event->pos());
+    if (lasso)
+	selectionPath.lineTo(pt);
+    else
+    {
+	selectionPath = QPainterPath();
+	selectionPath.addRect(QRectF(selectionStart, pt).normalized());
+    }
+    viewport()->update(mapFromScene(old | selectionPath.boundingRect())
+		       .boundingRect().adjusted(-2, -2, 2, 2));
+}
+
+
+/*
+ * Name:        mouseReleaseEvent
+ * Purpose:     Selects what the rubber band or lasso encloses.
+ * Arguments:   QMouseEvent
+ * Output:      none
+ * Modifies:    the selection, selecting, selectionPath
+ * Returns:     none
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       See CanvasScene::selectArea().
+ */
+
+void CanvasView::mouseReleaseEvent(QMouseEvent * event)
+{
+    if (!selecting)
+    {
+	QGraphicsView::mouseReleaseEvent(event);
+	return;
+    }
+
+    selecting = false;
+    if (lasso)
+	selectionPath.closeSubpath();
+    aScene->selectArea(selectionPath);
+    viewport()->update(mapFromScene(selectionPath.boundingRect())
+		       .boundingRect().adjusted(-2, -2, 2, 2));
+    selectionPath = QPainterPath();
+}
+
+
+/*
+ * Name:        drawForeground
+ * Purpose:     Draws the rubber band or lasso being drawn, if any.
+ * Arguments:   the painter and the area to draw
+ * Output:      none
+ * Modifies:    none
+ * Returns:     none
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       The outline is one pixel wide at any zoom.
+ */
+
+void CanvasView::drawForeground(QPainter * painter, const QRectF & rect)
+{
+    Q_UNUSED(rect);
+
+    if (!selecting)
+	return;
+
+    QPen pen(palette().highlight().color(), 0, Qt::DashLine);
+    QColor fill = palette().highlight().color();
+    fill.setAlpha(40);
+    painter->setPen(pen);
+    painter->setBrush(fill);
+    painter->drawPath(selectionPath);
+}
+
+
 void CanvasView::snapToGrid(bool snap)
 {
     aScene->isSnappedToGrid(snap);
@@ -243,6 +428,313 @@ void CanvasView::snapToGrid(bool snap)
 }
 
 
+/*
+ * Name:        setElasticDrag
+ * Purpose:     Turns elastic dragging (in edit mode) on or off.
+ * Arguments:   bool
+ * Output:      none
+ * Modifies:    the scene's elastic drag setting
+ * Returns:     none
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       When it is on, dragging a node pulls the nodes near it
+ *              along, as if the edges were springs.
+ */
+
+void CanvasView::setElasticDrag(bool elastic)
+{
+    aScene->setElasticDrag(elastic);
+}
+
+
+/*
+ * Name:        snapNodesToGrid
+ * Purpose:     Moves the selected nodes (or all of them, if nothing is
+ *              selected) to the grid.
+ * Arguments:   none
+ * Output:      none
+ * Modifies:    the nodes
+ * Returns:     none
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       See CanvasScene::snapNodesToGrid().
+ */
+
+void CanvasView::snapNodesToGrid()
+{
+    aScene->snapNodesToGrid();
+}
+
+
+/*
+ * Name:        undo
+ * Purpose:     Undoes the last edit of the canvas.
+ * Arguments:   none
+ * Output:      none
+ * Modifies:    the canvas
+ * Returns:     none
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       The nodes chosen for a new edge are forgotten, since the
+ *              edit may take them off the canvas.
+ */
+
+void CanvasView::undo()
+{
+    node1 = nullptr;
+    node2 = nullptr;
+    aScene->undo();
+}
+
+
+/*
+ * Name:        redo
+ * Purpose:     Redoes the last edit of the canvas undone.
+ * Arguments:   none
+ * Output:      none
+ * Modifies:    the canvas
+ * Returns:     none
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       As for undo().
+ */
+
+void CanvasView::redo()
+{
+    node1 = nullptr;
+    node2 = nullptr;
+    aScene->redo();
+}
+
+
+UndoStack * CanvasView::undoStack()
+{
+    return aScene->undoStack();
+}
+
+
+void CanvasView::selectAll()
+{
+    aScene->selectAll();
+}
+
+
+/*
+ * Name:        deleteSelection
+ * Purpose:     Deletes the selected nodes and edges.
+ * Arguments:   none
+ * Output:      none
+ * Modifies:    the canvas
+ * Returns:     none
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       See CanvasScene::deleteSelection().
+ */
+
+void CanvasView::deleteSelection()
+{
+    node1 = nullptr;
+    node2 = nullptr;
+    aScene->deleteSelection();
+}
+
+
+void CanvasView::recolourSelection(QColor colour)
+{
+    aScene->recolourSelection(colour);
+}
+
+
+void CanvasView::resizeSelection(qreal scale)
+{
+    aScene->resizeSelection(scale);
+}
+
+
+/*
+ * Name:        setTiledRendering
+ * Purpose:     Turns the multi-threaded tiled renderer on or off.
+ * Arguments:   bool
+ * Output:      none
+ * Modifies:    tiledRendering, the IndirectPainting optimization flag
+ * Returns:     none
+ * Assumptions: none
+ * Bugs:        IndirectPainting and drawItems() are obsolete in Qt 5
+ *              and may be removed from a later Qt, which would leave
+ *              only the direct renderer.
+ * Notes:       IndirectPainting makes QGraphicsView hand the items
+ *              to be painted to drawItems(), which is where the
+ *              tiles are rendered.
+ */
+
+void CanvasView::setTiledRendering(bool tiled)
+{
+    tiledRendering = tiled;
+    setOptimizationFlag(IndirectPainting, tiled);
+    frameTime[0] = frameTime[1] = 0;
+    frameCount[0] = frameCount[1] = 0;
+    viewport()->update();
+}
+
+
+/*
+ * Name:        paintEvent
+ * Purpose:     Paints the view, keeping track of how long it takes.
+ * Arguments:   QPaintEvent *
+ * Output:      If FRAME_REPORT_VARIABLE is set in the environment and
+ *              tiled rendering is on, the average frame time of the direct and the tiled
+ *              renderer every FRAME_REPORT_PERIOD frames.
+ * Modifies:    frameTime, frameCount
+ * Returns:     none
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       The times of both renderers are kept since the last
+ *              call of setTiledRendering(), so turning it off and on
+ *              again compares the two on the same canvas.
+ */
+
+void CanvasView::paintEvent(QPaintEvent * event)
+{
+    QElapsedTimer timer;
+    int renderer = tiledRendering ? 1 : 0;
+
+    timer.start();
+    QGraphicsView::paintEvent(event);
+    frameTime[renderer] += timer.nsecsElapsed();
+    frameCount[renderer]++;
+
+    if (reportFrameTimes && tiledRendering
+        && frameCount[1] % FRAME_REPORT_PERIOD == 0)
+        qDebug() << "Average frame time: direct"
+                 << (frameCount[0] > 0
+                     ? frameTime[0] / frameCount[0] / 1e6 : 0.)
+                 << "ms (" << frameCount[0] << "frames ), tiled"
+                 << frameTime[1] / frameCount[1] / 1e6
+                 << "ms (" << frameCount[1] << "frames )";
+}
+
+
+/*
+ * Name:        drawItems
+ * Purpose:     Paints the exposed items, splitting the nodes and edges
+ *              over tiles that are rendered on the global thread pool.
+ * Arguments:   QPainter *, number of items, the items (bottom to top),
+ *              and their style options
+ * Output:      The items.
+ * Modifies:    nothing
+ * Returns:     none
+ * Assumptions: Node::paint() and Edge::paint() only read their item.
+ * Bugs:        Labels are painted after (so on top of) all of the
+ *              tiles.  Graphs are not drawn from their cached image
+ *              (see graphcache.cpp) in this mode.
+ * Notes:       Only called when tiledRendering is set (see
+ *              setTiledRendering()).  Labels use a QTextDocument,
+ *              which can't be painted from two threads at once, so
+ *              they, and any other kind of item, are painted here in
+ *              the GUI thread once the tiles have been composited.
+ */
+
+void CanvasView::drawItems(QPainter * painter, int numItems,
+                           QGraphicsItem * items[],
+                           const QStyleOptionGraphicsItem options[])
+{
+    if (!tiledRendering)
+    {
+        QGraphicsView::drawItems(painter, numItems, items, options);
+        return;
+    }
+
+    const QTransform viewTransform = painter->worldTransform();
+    const QPainter::RenderHints hints = painter->renderHints();
+    const QRect area = viewport()->rect();
+    QVector<Tile_Item> tileItems;
+    QVector<int> otherItems;
+
+    int columns = (area.width() + RENDER_TILE_SIZE - 1) / RENDER_TILE_SIZE;
+    int rows = (area.height() + RENDER_TILE_SIZE - 1) / RENDER_TILE_SIZE;
+    QVector<Render_Tile> tiles(columns * rows);
+    for (int i = 0; i < tiles.count(); i++)
+        tiles[i].rect = QRect((i % columns) * RENDER_TILE_SIZE,
+                              (i / columns) * RENDER_TILE_SIZE,
+                              RENDER_TILE_SIZE, RENDER_TILE_SIZE) & area;
+
+    // Sort the items into the tiles they touch.
+    for (int i = 0; i < numItems; i++)
+    {
+        QGraphicsItem * item = items[i];
+        if (item->type() == Graph::Type)
+            continue;		// Graphs don't draw anything themselves.
+        if (item->type() != Node::Type && item->type() != Edge::Type)
+        {
+            otherItems.append(i);
+            continue;
+        }
+
+        Tile_Item tileItem;
+        tileItem.item = item;
+        tileItem.transform = item->deviceTransform(viewTransform);
+        tileItem.option = i;
+
+        QRect rect = tileItem.transform.mapRect(item->boundingRect())
+            .toAlignedRect().adjusted(-1, -1, 1, 1) & area;
+        if (rect.isEmpty())
+            continue;
+
+        for (int row = rect.top() / RENDER_TILE_SIZE;
+             row <= rect.bottom() / RENDER_TILE_SIZE; row++)
+            for (int col = rect.left() / RENDER_TILE_SIZE;
+                 col <= rect.right() / RENDER_TILE_SIZE; col++)
+                tiles[row * columns + col].items.append(tileItems.count());
+        tileItems.append(tileItem);
+    }
+
+    QtConcurrent::blockingMap(tiles, [&](Render_Tile & tile)
+    {
+        if (tile.items.isEmpty())
+            return;
+
+        tile.image = QImage(tile.rect.size(),
+                            QImage::Format_ARGB32_Premultiplied);
+        tile.image.fill(Qt::transparent);
+
+        QPainter tilePainter(&tile.image);
+        QTransform toTile = QTransform::fromTranslate(-tile.rect.x(),
+                                                      -tile.rect.y());
+        tilePainter.setRenderHints(hints);
+        foreach (int index, tile.items)
+        {
+            const Tile_Item & tileItem = tileItems.at(index);
+            tilePainter.setWorldTransform(tileItem.transform * toTile);
+            tileItem.item->paint(&tilePainter, &options[tileItem.option],
+                                 nullptr);
+        }
+        tilePainter.end();
+    });
+
+    painter->save();
+    painter->setWorldTransform(QTransform());
+    foreach (const Render_Tile & tile, tiles)
+        if (!tile.image.isNull())
+            painter->drawImage(tile.rect.topLeft(), tile.image);
+    painter->restore();
+
+    foreach (int i, otherItems)
+    {
+        QGraphicsItem * item = items[i];
+        QGraphicsItem * parent = item->parentItem();
+
+        painter->save();
+        painter->setWorldTransform(item->deviceTransform(viewTransform));
+        if (parent != nullptr
+            && (parent->flags() & QGraphicsItem::ItemClipsChildrenToShape))
+            painter->setClipPath(item->mapFromParent(parent->shape()),
+                                 Qt::IntersectClip);
+        item->paint(painter, &options[i], viewport());
+        painter->restore();
+    }
+}
+
+
 void CanvasView::dragEnterEvent(QDragEnterEvent * event)
 {
     emit resetNoMode();
@@ -252,11 +744,13 @@ void CanvasView::dragEnterEvent(QDragEnterEvent * event)
 Edge * CanvasView::addEdgeToScene(Node * source, Node * destination)
 {
     Edge * edge = createEdge(source, destination);
+    CanvasEdit * edit = new CanvasEdit(aScene);
     if (node1->parentItem() == node2->parentItem())
     {
 	// Both nodes are from the same parent item
         Graph * parent = qgraphicsitem_cast<Graph*>(node1->parentItem());
         edge->setParentItem(parent);
+        edit->added(edge);
     }
     else
     {
@@ -288,15 +782,17 @@ Edge * CanvasView::addEdgeToScene(Node * source, Node * destination)
 	    && (parent1 != nullptr || parent1 != 0))
         {
             edge->setZValue(0);
-            edge->setParentItem(root);
-            parent1->setParentItem(root);
-            parent2->setParentItem(root);
             root->setHandlesChildEvents(false);
             aScene->addItem(root);
-            aScene->addItem(edge);
+            edit->added(root);
+            edit->reparent(parent1, root);
+            edit->reparent(parent2, root);
+            edge->setParentItem(root);
+            edit->added(edge);
             edge->adjust();
         }
     }
+    aScene->record(edit);
     return edge;
 }
 
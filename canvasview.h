@@ -51,9 +51,19 @@ public:
     Edge * addEdgeToScene(Node * source, Node * destination);
     int getMode() const;
     void setMode(int m);
+    UndoStack * undoStack();
 
 public slots:
     void snapToGrid(bool snap);
+    void setTiledRendering(bool tiled);
+    void setElasticDrag(bool elastic);
+    void snapNodesToGrid();
+    void undo();
+    void redo();
+    void selectAll();
+    void deleteSelection();
+    void recolourSelection(QColor colour);
+    void resizeSelection(qreal scale);
 
 signals:
     void setKeyStatusLabelText(QString text);
@@ -63,7 +73,13 @@ protected:
     void dragEnterEvent(QDragEnterEvent * event);
     void mouseDoubleClickEvent(QMouseEvent *event);
     void mousePressEvent(QMouseEvent *event);
+    void mouseMoveEvent(QMouseEvent * event);
+    void mouseReleaseEvent(QMouseEvent * event);
     void keyPressEvent(QKeyEvent *event);
+    void paintEvent(QPaintEvent * event);
+    void drawForeground(QPainter * painter, const QRectF & rect);
+    void drawItems(QPainter * painter, int numItems, QGraphicsItem * items[],
+                   const QStyleOptionGraphicsItem options[]);
 
 private:
     int modeType;
@@ -73,6 +89,14 @@ private:
     Node_Params * nodeParams;
     Edge_Params * edgeParams;
     Node * node1, *node2;
+    bool tiledRendering;
+    bool reportFrameTimes;	// Print the frame times of both renderers?
+    qint64 frameTime[2];	// Total paint time (ns), [0] direct, [1] tiled.
+    int frameCount[2];		// Number of frames in frameTime[].
+    bool selecting;		// Is a rubber band or lasso being drawn?
+    bool lasso;			// A lasso, rather than a rubber band.
+    QPointF selectionStart;	// Where it started, in the scene.
+    QPainterPath selectionPath;	// The area, in the scene.
 };
 
 #endif // CANVASVIEW_H
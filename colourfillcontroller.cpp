@@ -1,4 +1,5 @@
 #include "colourfillcontroller.h"
+#include "canvasedit.h"
 #include <QColorDialog>
 
 #define BUTTON_STYLE "border-style: outset; border-width: 2px; border-radius: 5px; border-color: beige; padding: 3px;"
@@ -43,7 +44,7 @@ void ColorFillController::setNodeFillColor()
     button->setStyleSheet(s);
     if (node != 0 || node != nullptr)
     {
-        node->setFillColour(color);
+        CanvasEdit::setStyle(node, CanvasEdit::NodeFill, color);
     }
 }
 
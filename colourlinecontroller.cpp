@@ -1,4 +1,5 @@
 #include "colourlinecontroller.h"
+#include "canvasedit.h"
 
 #include <QColorDialog>
 #include <QtCore>
@@ -70,7 +71,7 @@ void ColorLineController::setEdgeLineColor()
     button->setStyleSheet(s);
     if (edge != 0 || edge != nullptr)
     {
-        edge->setColour(color);
+        CanvasEdit::setStyle(edge, CanvasEdit::EdgeColour, color);
     }
 }
 
@@ -88,7 +89,7 @@ void ColorLineController::setNodeOutlineColor()
     button->setStyleSheet(s);
     if (node != 0 || node != nullptr)
     {
-        node->setLineColour(color);
+        CanvasEdit::setStyle(node, CanvasEdit::NodeLine, color);
     }
 }
 
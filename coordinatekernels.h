@@ -0,0 +1,32 @@
+/*
+ * File:	coordinatekernels.h
+ * Date:	2026/10/18
+ * Version:	1.0
+ *
+ * Purpose:	Declares the functions that compute the node positions
+ *		of rings, lattices and rows in bulk, and the key of a
+ *		grid cell.
+ */
+
+#ifndef COORDINATEKERNELS_H
+#define COORDINATEKERNELS_H
+
+#include <QPointF>
+
+void ring_positions(QPointF * out, int numOfNodes,
+		    qreal width, qreal height, qreal radians = 0);
+void lattice_positions(QPointF * out, int columns, int rows,
+		       qreal width, qreal height);
+void row_positions(QPointF * out, int numOfNodes,
+		   qreal x, qreal spacing, qreal y);
+
+// The key of cell (column, row) of a grid, for hashing the cells.
+// The column is shifted as unsigned, since shifting a negative value
+// left is undefined.
+inline qint64
+grid_key(qint64 column, qint64 row)
+{
+    return (qint64)(((quint64)column << 32) ^ ((quint64)row & 0xffffffffULL));
+}
+
+#endif // COORDINATEKERNELS_H
@@ -53,6 +53,7 @@ Edge::Edge(Node * sourceNode, Node * destNode)
     setFlag(ItemIsSelectable);
     setFlag(ItemIsFocusable);
     setFlag(ItemSendsGeometryChanges);
+    label = nullptr;
     source = sourceNode;
     setZValue(0);
     dest = destNode;
@@ -66,10 +67,7 @@ Edge::Edge(Node * sourceNode, Node * destNode)
     sourceRadius = 1;
     setHandlesChildEvents(true);
     label = new Label(this);
-    label->setPos((edgeLine.p2().rx() + edgeLine.p1().rx()) / 2.
-		  - label->boundingRect().width() / 2.,
-		  (edgeLine.p2().ry() + edgeLine.p1().ry()) / 2.
-		  - label->boundingRect().height() / 2.);
+    label->centerOn((edgeLine.p1() + edgeLine.p2()) / 2.);
 }
 
 
@@ -191,8 +189,9 @@ QGraphicsItem * Edge::getRootParent()
 
 void Edge::setWeight(QString aWeight)
 {
-
+    weight = aWeight;
     label->setLabel(aWeight);
+    label->centerOn((sourcePoint + destPoint) / 2.);
     //    QRegExp re("\\d*");  // A digit (\d), zero or more times (*)
 
 //    weight = aWeight;
@@ -246,7 +245,7 @@ QString Edge::getWeight()
  *              the node when the node is dragged.
  * Arguments:   none
  * Output:      none
- * Modifies:    Edge
+ * Modifies:    Edge, the cached bounds of the parent graph
  * Returns:     none
  * Assumptions: none
  * Bugs:        none
@@ -261,6 +260,11 @@ void Edge::adjust()
     QLineF line(mapFromItem(source, 0, 0), mapFromItem(dest, 0, 0));
     qreal length = line.length();
 
+    Graph * graph = qgraphicsitem_cast<Graph *>(parentItem());
+    QRectF oldRect;
+    if (graph != nullptr)
+        oldRect = Graph::childRect(this);
+
     prepareGeometryChange();
 
     if (length > destRadius * 2)
@@ -276,6 +280,11 @@ void Edge::adjust()
         sourcePoint = destPoint = line.p1();
     edgeLine = line;
     createSelectionPolygon();
+    if (label != nullptr)
+        label->centerOn((sourcePoint + destPoint) / 2.);
+
+    if (graph != nullptr)
+        graph->childGeometryChanged(oldRect, Graph::childRect(this));
 }
 
 
@@ -410,6 +419,7 @@ qreal Edge::getSourceRadius()
 void Edge::setPenWidth(qreal aPenWidth)
 {
     penSize = aPenWidth;
+    update();
 }
 
 
@@ -485,6 +495,7 @@ qreal Edge::getRotation()
 void Edge::setColour(QColor colour)
 {
     edgeColour = colour;
+    update();
 }
 
 
@@ -522,6 +533,7 @@ void Edge::setWeightLabelSize(qreal edgeWeightLabelSize)
     QFont font = label->font();
     font.setPointSize(edgeWeightLabelSize);
     label->setFont(font);
+    label->centerOn((sourcePoint + destPoint) / 2.);
     eSize = edgeWeightLabelSize;
 }
 
@@ -613,6 +625,9 @@ QPainterPath Edge::shape() const
  * Bugs:        none
  * Notes:       QWidget * and QStyleOptionGraphicsItem are not used in my
  *              implementation of this function.
+ *              This must not change the edge or its label: the canvas
+ *              may call it from several threads at once (see
+ *              CanvasView::drawItems()).  adjust() places the label.
  */
 
 void Edge::paint(QPainter *painter, const QStyleOptionGraphicsItem * option,
@@ -637,23 +652,13 @@ void Edge::paint(QPainter *painter, const QStyleOptionGraphicsItem * option,
     pen.setWidthF(penSize);
     pen.setCapStyle(Qt::RoundCap);
     pen.setJoinStyle(Qt::RoundJoin);
-    pen.setStyle(Qt::SolidLine);
+    pen.setStyle(isSelected() ? Qt::DashLine : Qt::SolidLine);
     painter->setPen(pen);
     painter->drawLine(line);
-    edgeLine = line;
 
     // Debug statement to view the edge's bounding shape.
     if (verbose)
         painter->drawPolygon(selectionPolygon);
-
-    if (weight.length() > 0)
-    {
-	label->setPos((line.p2().rx() + line.p1().rx()) / 2.
-                      - label->boundingRect().width() / 2.,
-		      (line.p2().ry() + line.p1().ry()) / 2.
-                      - label->boundingRect().height() / 2.);
-    }
-
 }
 
 
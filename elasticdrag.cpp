@@ -0,0 +1,209 @@
+/*
+ * File:    elasticdrag.cpp
+ * Date:    2026/10/18
+ * Version: 1.0
+ *
+ * Purpose: Elastic dragging: while a node is dragged in edit mode,
+ *          the nodes within ELASTIC_HOPS edges of it follow as if the
+ *          edges were springs, each with its length when the drag
+ *          began as its rest length.  Nodes beyond that stay put and
+ *          hold the neighbourhood in place.
+ *
+ * Notes:   The neighbourhood and its springs are found once, when the
+ *          drag starts, and at most ELASTIC_MAX_NODES nodes are
+ *          involved, so the work done per frame depends only on the
+ *          size of the neighbourhood and never on the size of the
+ *          graph.
+ */
+
+#include "elasticdrag.h"
+#include "node.h"
+#include "edge.h"
+
+#include <QHash>
+#include <QLineF>
+#include <QtMath>
+
+// How many edges away from the dragged node a node may be and still
+// move with it.
+#define ELASTIC_HOPS		2
+
+// The most nodes (moving or not) an elastic drag involves.
+#define ELASTIC_MAX_NODES	1000
+
+// The number of relaxation sweeps per frame.
+#define ELASTIC_ITERATIONS	10
+
+
+/*
+ * Name:        other_end
+ * Purpose:     Finds the node at the other end of an edge.
+ * Arguments:   the edge and one of its nodes
+ * Output:      none
+ * Modifies:    nothing
+ * Returns:     the other node
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       none
+ */
+
+static inline Node *
+other_end(Edge * edge, Node * node)
+{
+    return edge->sourceNode() == node ? edge->destNode() : edge->sourceNode();
+}
+
+
+/*
+ * Name:        ElasticDrag
+ * Purpose:     Finds the neighbourhood of a node and its springs.
+ * Arguments:   the node about to be dragged
+ * Output:      none
+ * Modifies:    none
+ * Returns:     none
+ * Assumptions: none
+ * Bugs:        Edges drawn by an ImplicitEdges item aren't springs,
+ *              since in a dense graph the neighbourhood would be the
+ *              whole graph.
+ * Notes:       The neighbourhood is found breadth first.  A node
+ *              fewer than ELASTIC_HOPS + 1 edges away is free to move
+ *              if all of its neighbours fit under ELASTIC_MAX_NODES;
+ *              otherwise (and beyond that distance) it is fixed, but
+ *              still anchors the springs to it.
+ */
+
+ElasticDrag::ElasticDrag(Node * dragged)
+{
+    QHash<Node *, int> index;
+    QVector<int> hops;
+
+    nodes.append(dragged);
+    hops.append(0);
+    index.insert(dragged, 0);
+
+    for (int q = 0; q < nodes.count(); q++)
+    {
+	Node * node = nodes.at(q);
+	if (hops.at(q) > ELASTIC_HOPS)
+	    continue;
+
+	int unseen = 0;
+	foreach (Edge * edge, node->edgeList)
+	    if (!index.contains(other_end(edge, node)))
+		unseen++;
+	if (nodes.count() + unseen > ELASTIC_MAX_NODES)
+	    continue;
+
+	foreach (Edge * edge, node->edgeList)
+	{
+	    Node * next = other_end(edge, node);
+	    if (!index.contains(next))
+	    {
+		index.insert(next, nodes.count());
+		nodes.append(next);
+		hops.append(hops.at(q) + 1);
+	    }
+	}
+	if (q > 0)
+	    movable.append(q);
+    }
+
+    positions.resize(nodes.count());
+    for (int i = 0; i < nodes.count(); i++)
+	positions[i] = nodes.at(i)->scenePos();
+
+    offsets.append(0);
+    for (int f = 0; f < movable.count(); f++)
+    {
+	Node * node = nodes.at(movable.at(f));
+	foreach (Edge * edge, node->edgeList)
+	{
+	    Node * next = other_end(edge, node);
+	    if (next == node)
+		continue;
+	    int j = index.value(next);
+	    targets.append(j);
+	    lengths.append(QLineF(positions.at(movable.at(f)),
+				  positions.at(j)).length());
+	}
+	offsets.append(targets.count());
+    }
+}
+
+
+/*
+ * Name:        relax
+ * Purpose:     Moves the neighbourhood to follow the dragged node.
+ * Arguments:   none
+ * Output:      none
+ * Modifies:    the positions of the free nodes
+ * Returns:     none
+ * Assumptions: The dragged node has been moved already.
+ * Bugs:        none
+ * Notes:       Each sweep puts every free node at the average of the
+ *              places its springs would each like it to be (a local
+ *              stress-majorization step, done Gauss-Seidel style), so
+ *              the neighbourhood keeps its shape as far as it can.
+ */
+
+void
+ElasticDrag::relax()
+{
+    if (movable.isEmpty())
+	return;
+
+    positions[0] = nodes.at(0)->scenePos();
+    for (int iteration = 0; iteration < ELASTIC_ITERATIONS; iteration++)
+	for (int f = 0; f < movable.count(); f++)
+	{
+	    int i = movable.at(f);
+	    int count = offsets.at(f + 1) - offsets.at(f);
+	    QPointF sum;
+
+	    for (int s = offsets.at(f); s < offsets.at(f + 1); s++)
+	    {
+		const QPointF & other = positions.at(targets.at(s));
+		QPointF away = positions.at(i) - other;
+		qreal length = qSqrt(away.x() * away.x()
+				     + away.y() * away.y());
+		if (length < 1e-9)
+		    sum += other + QPointF(lengths.at(s), 0);
+		else
+		    sum += other + away * (lengths.at(s) / length);
+	    }
+	    if (count > 0)
+		positions[i] = sum / count;
+	}
+
+    foreach (int i, movable)
+    {
+	Node * node = nodes.at(i);
+	QGraphicsItem * parent = node->parentItem();
+	node->setPos(parent != nullptr
+		     ? parent->mapFromScene(positions.at(i))
+		     : positions.at(i));
+    }
+}
+
+
+/*
+ * Name:        movedNodes
+ * Purpose:     Lists the nodes relax() may have moved.
+ * Arguments:   none
+ * Output:      none
+ * Modifies:    nothing
+ * Returns:     the nodes
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       none
+ */
+
+QList<Node *>
+ElasticDrag::movedNodes() const
+{
+    QList<Node *> moved;
+
+    foreach (int i, movable)
+	moved.append(nodes.at(i));
+    return moved;
+}
@@ -0,0 +1,36 @@
+/*
+ * File:	elasticdrag.h
+ * Date:	2026/10/18
+ * Version:	1.0
+ *
+ * Purpose:	Declares the springs that pull a dragged node's
+ *		neighbourhood along with it in edit mode.
+ */
+
+#ifndef ELASTICDRAG_H
+#define ELASTICDRAG_H
+
+#include <QList>
+#include <QPointF>
+#include <QVector>
+
+class Node;
+
+class ElasticDrag
+{
+public:
+    ElasticDrag(Node * dragged);
+    void relax();
+    QList<Node *> movedNodes() const;
+
+private:
+    QVector<Node *> nodes;	// nodes[0] is the dragged node.
+    QVector<QPointF> positions;	// Scene coordinates.
+    QVector<int> movable;	// The nodes that may move.
+    QVector<int> offsets;	// The springs of nodes[movable[f]] go to
+    QVector<int> targets;	// nodes[targets[s]], for s in
+    QVector<qreal> lengths;	// [offsets[f], offsets[f + 1]), with
+				// rest lengths lengths[s].
+};
+
+#endif // ELASTICDRAG_H
@@ -0,0 +1,73 @@
+/*
+ * File:	fastrandom.h
+ * Date:	2026/10/18
+ * Version:	1.0
+ *
+ * Purpose:	A small, fast, seedable pseudo-random number generator
+ *		for the random graph generators.
+ *
+ * Notes:	xoshiro256** (Blackman and Vigna), with its state filled
+ *		in from the seed by splitmix64.  The same seed always
+ *		gives the same sequence, on every platform, which
+ *		qrand() does not promise.  Not for cryptographic use.
+ */
+
+#ifndef FASTRANDOM_H
+#define FASTRANDOM_H
+
+#include <QtGlobal>
+
+class FastRandom
+{
+  public:
+    explicit FastRandom(quint64 seed)
+    {
+	for (int i = 0; i < 4; i++)
+	{
+	    seed += Q_UINT64_C(0x9e3779b97f4a7c15);
+	    quint64 z = seed;
+	    z = (z ^ (z >> 30)) * Q_UINT64_C(0xbf58476d1ce4e5b9);
+	    z = (z ^ (z >> 27)) * Q_UINT64_C(0x94d049bb133111eb);
+	    state[i] = z ^ (z >> 31);
+	}
+    }
+
+    // The next 64 random bits.
+    quint64 next()
+    {
+	quint64 result = rotate(state[1] * 5, 7) * 9;
+	quint64 t = state[1] << 17;
+
+	state[2] ^= state[0];
+	state[3] ^= state[1];
+	state[1] ^= state[2];
+	state[0] ^= state[3];
+	state[2] ^= t;
+	state[3] = rotate(state[3], 45);
+	return result;
+    }
+
+    // A double in [0, 1).
+    double uniform()
+    {
+	return (next() >> 11) * (1.0 / (Q_UINT64_C(1) << 53));
+    }
+
+    // An integer in [0, n), for n > 0.  (Slightly biased for huge n,
+    // which the generators never use.)
+    qint64 below(qint64 n)
+    {
+	qint64 r = (qint64)(uniform() * n);
+	return r < n ? r : n - 1;
+    }
+
+  private:
+    static quint64 rotate(quint64 x, int k)
+    {
+	return (x << k) | (x >> (64 - k));
+    }
+
+    quint64 state[4];
+};
+
+#endif // FASTRANDOM_H
@@ -0,0 +1,419 @@
+/*
+ * File:    forcelayout.cpp
+ * Date:    2026/10/18
+ * Version: 1.0
+ *
+ * Purpose: A Fruchterman-Reingold (spring-electrical) layout.  Every
+ *          pair of nodes repels with force k^2 / d and every edge
+ *          pulls its ends together with force d^2 / k, where k is the
+ *          ideal edge length; each iteration moves the nodes along
+ *          the total force, by at most the current "temperature",
+ *          which falls geometrically.
+ *
+ * Notes:   The repulsion is found with a Barnes-Hut quadtree: a cell
+ *          that is small compared to its distance from a node acts
+ *          on it as one body at its centre of mass, so an iteration
+ *          takes O(n log n) time instead of O(n^2).  The tree is built
+ *          on one thread, then the forces on the nodes are found in
+ *          chunks on all cores.
+ */
+
+#include "forcelayout.h"
+#include "layoutgraph.h"
+
+#include <QElapsedTimer>
+#include <QPair>
+#include <QVector>
+#include <QtConcurrent/QtConcurrentMap>
+#include <QtMath>
+#include <algorithm>
+
+// The ideal edge length, in node diameters.
+#define FORCE_EDGE_LENGTH	4
+
+// The number of iterations force_layout() runs.
+#define FORCE_ITERATIONS	200
+
+// The temperature in the last iteration, as a fraction of the first.
+#define FORCE_FINAL_TEMPERATURE	0.01
+
+// A cell acts as one body on a node if its width is less than
+// FORCE_THETA times its distance from the node.  Bigger is faster
+// and less accurate.
+#define FORCE_THETA		0.9
+
+// Nodes closer together than this (in quadtree levels) share a cell.
+#define QUAD_MAX_DEPTH		24
+
+// The number of nodes handed to one thread at a time.
+#define FORCE_CHUNK_SIZE	1024
+
+// Time (in ms) between two calls of publish() during a layout.
+#define FORCE_PUBLISH_INTERVAL	50
+
+// One cell of the quadtree.  A leaf has child == -1 and holds one
+// body (body >= 0), none (body == -1) or several bodies that are too
+// close to separate (body == -2).  The four children of a cell are
+// stored together, starting at cells[child].
+typedef struct qCell
+{
+    qreal x, y;			// The centre of the cell.
+    qreal half;			// Half of the cell's width.
+    qreal sumX, sumY;		// Mass-weighted sums of the positions.
+    qreal mass;
+    int child;
+    int body;
+} Quad_Cell;
+
+
+/*
+ * Name:        body_mass
+ * Purpose:     Gets the mass of a node.
+ * Arguments:   the masses (or nullptr), and the node
+ * Output:      none
+ * Modifies:    nothing
+ * Returns:     the mass
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       none
+ */
+
+static inline qreal
+body_mass(const qreal * masses, int i)
+{
+    return masses != nullptr ? masses[i] : 1;
+}
+
+
+/*
+ * Name:        quadrant
+ * Purpose:     Finds which child of a cell a point falls in.
+ * Arguments:   the cell and the point
+ * Output:      none
+ * Modifies:    nothing
+ * Returns:     0 to 3
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       none
+ */
+
+static inline int
+quadrant(const Quad_Cell & cell, const QPointF & p)
+{
+    return (p.x() >= cell.x ? 1 : 0) + (p.y() >= cell.y ? 2 : 0);
+}
+
+
+/*
+ * Name:        split_cell
+ * Purpose:     Gives a leaf four empty children.
+ * Arguments:   the tree and the leaf
+ * Output:      none
+ * Modifies:    cells
+ * Returns:     none
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       cells may be reallocated, so the caller must not hold
+ *              a reference into it.
+ */
+
+static void
+split_cell(QVector<Quad_Cell> & cells, int c)
+{
+    int first = cells.count();
+    qreal half = cells.at(c).half / 2;
+
+    for (int q = 0; q < 4; q++)
+    {
+	Quad_Cell child;
+	child.x = cells.at(c).x + (q & 1 ? half : -half);
+	child.y = cells.at(c).y + (q & 2 ? half : -half);
+	child.half = half;
+	child.sumX = child.sumY = child.mass = 0;
+	child.child = -1;
+	child.body = -1;
+	cells.append(child);
+    }
+    cells[c].child = first;
+}
+
+
+/*
+ * Name:        build_quadtree
+ * Purpose:     Builds the Barnes-Hut quadtree of the nodes.
+ * Arguments:   the positions, their number and masses, and the tree
+ * Output:      none
+ * Modifies:    cells
+ * Returns:     none
+ * Assumptions: numOfNodes > 0
+ * Bugs:        none
+ * Notes:       cells[0] is the root.  Each node is added at the root
+ *              and walked down, adding its mass to every cell on the
+ *              way, until it reaches an empty leaf; an occupied leaf
+ *              is split first, unless it is QUAD_MAX_DEPTH deep.
+ */
+
+static void
+build_quadtree(const QPointF * positions, int numOfNodes,
+	       const qreal * masses, QVector<Quad_Cell> & cells)
+{
+    qreal minX = positions[0].x(), maxX = minX;
+    qreal minY = positions[0].y(), maxY = minY;
+    for (int i = 1; i < numOfNodes; i++)
+    {
+	minX = qMin(minX, positions[i].x());
+	maxX = qMax(maxX, positions[i].x());
+	minY = qMin(minY, positions[i].y());
+	maxY = qMax(maxY, positions[i].y());
+    }
+
+    Quad_Cell root;
+    root.x = (minX + maxX) / 2;
+    root.y = (minY + maxY) / 2;
+    root.half = qMax(qMax(maxX - minX, maxY - minY) / 2, (qreal)1) * 1.0001;
+    root.sumX = root.sumY = root.mass = 0;
+    root.child = -1;
+    root.body = -1;
+    cells.clear();
+    cells.reserve(4 * numOfNodes + 1);
+    cells.append(root);
+
+    for (int i = 0; i < numOfNodes; i++)
+    {
+	const QPointF & p = positions[i];
+	qreal m = body_mass(masses, i);
+	int c = 0;
+
+	for (int depth = 0; ; depth++)
+	{
+	    if (cells.at(c).child < 0 && cells.at(c).body != -1
+		&& depth < QUAD_MAX_DEPTH)
+	    {
+		// Move the body already here down into a new child.
+		int other = cells.at(c).body;
+		split_cell(cells, c);
+		Quad_Cell & moved = cells[cells.at(c).child
+					  + quadrant(cells.at(c),
+						     positions[other])];
+		moved.body = other;
+		moved.mass = cells.at(c).mass;
+		moved.sumX = cells.at(c).sumX;
+		moved.sumY = cells.at(c).sumY;
+		cells[c].body = -1;
+	    }
+
+	    Quad_Cell & cell = cells[c];
+	    cell.mass += m;
+	    cell.sumX += m * p.x();
+	    cell.sumY += m * p.y();
+	    if (cell.child >= 0)
+		c = cell.child + quadrant(cell, p);
+	    else
+	    {
+		cell.body = cell.body == -1 ? i : -2;
+		break;
+	    }
+	}
+    }
+}
+
+
+/*
+ * Name:        repulsion
+ * Purpose:     Finds the repulsive force on one node.
+ * Arguments:   the tree, the node, its position, and k^2
+ * Output:      none
+ * Modifies:    nothing
+ * Returns:     the force
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       A cell pushes in proportion to its mass, whatever the
+ *              mass of the node (as in Walshaw's multilevel layout).
+ *              A node that is at the same place as a cell's centre
+ *              of mass is pushed in a direction that depends only on
+ *              its index, so that coincident nodes come apart the
+ *              same way every time.
+ */
+
+static QPointF
+repulsion(const QVector<Quad_Cell> & cells, int i, const QPointF & p,
+	  qreal k2)
+{
+    int stack[4 * QUAD_MAX_DEPTH + 4];
+    int top = 0;
+    qreal fx = 0, fy = 0;
+
+    stack[top++] = 0;
+    while (top > 0)
+    {
+	const Quad_Cell & cell = cells.at(stack[--top]);
+	if (cell.mass <= 0 || cell.body == i)
+	    continue;
+
+	qreal dx = p.x() - cell.sumX / cell.mass;
+	qreal dy = p.y() - cell.sumY / cell.mass;
+	qreal d2 = dx * dx + dy * dy;
+	qreal width = 2 * cell.half;
+
+	if (cell.child >= 0 && width * width >= FORCE_THETA * FORCE_THETA * d2)
+	{
+	    for (int q = 0; q < 4; q++)
+		stack[top++] = cell.child + q;
+	    continue;
+	}
+
+	qreal mass = cell.mass;
+	if (d2 < 1e-6 * k2)
+	{
+	    // Coincident: push along the golden angle times i.
+	    qreal angle = i * 2.39996322972865332;
+	    fx += mass * qSqrt(k2) * qCos(angle);
+	    fy += mass * qSqrt(k2) * qSin(angle);
+	    continue;
+	}
+	qreal f = mass * k2 / d2;
+	fx += f * dx;
+	fy += f * dy;
+    }
+    return QPointF(fx, fy);
+}
+
+
+/*
+ * Name:        force_directed
+ * Purpose:     Runs the spring-electrical layout.
+ * Arguments:   the positions, the number of nodes, the adjacency
+ *              lists in CSR form, the masses (or nullptr for all 1),
+ *              the parameters, and the LayoutGraph to publish to
+ *              and check for cancellation (or nullptr)
+ * Output:      none
+ * Modifies:    positions
+ * Returns:     none
+ * Assumptions: The neighbours of node i are
+ *              targets[offsets[i] .. offsets[i + 1]).
+ * Bugs:        none
+ * Notes:       Heavier nodes push harder; the multilevel layout uses
+ *              this to give a coarse node the room its fine nodes
+ *              will need.  Positions are published only if they are
+ *              owner's own.
+ */
+
+void
+force_directed(QPointF * positions, int numOfNodes,
+	       const int * offsets, const int * targets,
+	       const qreal * masses, const Force_Params & params,
+	       LayoutGraph * owner)
+{
+    if (numOfNodes < 2 || params.iterations < 1)
+	return;
+
+    const qreal k = params.edgeLength;
+    const qreal k2 = k * k;
+    const qreal cooling = qPow(FORCE_FINAL_TEMPERATURE,
+			       1.0 / params.iterations);
+    const bool publishing = owner != nullptr
+	&& positions == owner->positions.data();
+    QVector<Quad_Cell> cells;
+    QVector<QPointF> moved(numOfNodes);
+    QVector<QPair<int, int> > chunks;
+    QElapsedTimer clock;
+    qreal temperature = params.temperature;
+
+    for (int first = 0; first < numOfNodes; first += FORCE_CHUNK_SIZE)
+	chunks.append(qMakePair(first,
+				qMin(first + FORCE_CHUNK_SIZE, numOfNodes)));
+    clock.start();
+
+    for (int iteration = 0; iteration < params.iterations; iteration++)
+    {
+	if (owner != nullptr && owner->isCancelled())
+	    return;
+
+	build_quadtree(positions, numOfNodes, masses, cells);
+
+	QPointF * out = moved.data();
+	QtConcurrent::blockingMap(chunks, [&](const QPair<int, int> & chunk)
+	{
+	    for (int i = chunk.first; i < chunk.second; i++)
+	    {
+		const QPointF p = positions[i];
+		QPointF force = repulsion(cells, i, p, k2);
+		for (int e = offsets[i]; e < offsets[i + 1]; e++)
+		{
+		    QPointF delta = positions[targets[e]] - p;
+		    qreal d = qSqrt(delta.x() * delta.x()
+				    + delta.y() * delta.y());
+		    force += delta * (d / k);
+		}
+
+		qreal length = qSqrt(force.x() * force.x()
+				     + force.y() * force.y());
+		if (length > temperature)
+		    force *= temperature / length;
+		out[i] = p + force;
+	    }
+	});
+
+	std::copy(moved.constBegin(), moved.constEnd(), positions);
+	temperature *= cooling;
+
+	if (publishing && clock.elapsed() >= FORCE_PUBLISH_INTERVAL)
+	{
+	    owner->publish();
+	    clock.restart();
+	}
+    }
+}
+
+
+/*
+ * Name:        force_layout
+ * Purpose:     Lays out a graph with force_directed().
+ * Arguments:   the graph
+ * Output:      none
+ * Modifies:    graph->positions
+ * Returns:     none
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       The nodes start where they are on the canvas.  If they
+ *              are all piled up (as a freshly imported edge list may
+ *              be), they are first spread over a square grid.  The
+ *              first iteration may move a node a tenth of the way
+ *              across the layout.
+ */
+
+void
+force_layout(LayoutGraph * graph)
+{
+    const int n = graph->nodeCount();
+    if (n < 2)
+	return;
+
+    QPointF * positions = graph->positions.data();
+    Force_Params params;
+    params.edgeLength = FORCE_EDGE_LENGTH * graph->nodeSize;
+    params.iterations = FORCE_ITERATIONS;
+
+    qreal minX = positions[0].x(), maxX = minX;
+    qreal minY = positions[0].y(), maxY = minY;
+    for (int i = 1; i < n; i++)
+    {
+	minX = qMin(minX, positions[i].x());
+	maxX = qMax(maxX, positions[i].x());
+	minY = qMin(minY, positions[i].y());
+	maxY = qMax(maxY, positions[i].y());
+    }
+
+    const qreal side = params.edgeLength * qSqrt(n);
+    if (qMax(maxX - minX, maxY - minY) < params.edgeLength)
+    {
+	int columns = qCeil(qSqrt(n));
+	for (int i = 0; i < n; i++)
+	    positions[i] = QPointF(minX, minY)
+		+ QPointF(i % columns, i / columns) * params.edgeLength;
+    }
+    params.temperature = qMax(side, qMax(maxX - minX, maxY - minY)) / 10;
+
+    force_directed(positions, n, graph->offsets.constData(),
+		   graph->targets.constData(), nullptr, params, graph);
+}
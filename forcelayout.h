@@ -0,0 +1,30 @@
+/*
+ * File:	forcelayout.h
+ * Date:	2026/10/18
+ * Version:	1.0
+ *
+ * Purpose:	Declares the force-directed (spring-electrical) layout.
+ */
+
+#ifndef FORCELAYOUT_H
+#define FORCELAYOUT_H
+
+#include <QPointF>
+
+class LayoutGraph;
+
+// How force_directed() should run.
+typedef struct fParams
+{
+    qreal edgeLength;		// The ideal edge length (FR's k).
+    int iterations;
+    qreal temperature;		// Largest move in the first iteration.
+} Force_Params;
+
+void force_directed(QPointF * positions, int numOfNodes,
+		    const int * offsets, const int * targets,
+		    const qreal * masses, const Force_Params & params,
+		    LayoutGraph * owner);
+void force_layout(LayoutGraph * graph);
+
+#endif // FORCELAYOUT_H
@@ -3,6 +3,7 @@
 #include "node.h"
 #include "edge.h"
 #include "graphmimedata.h"
+#include "graphcache.h"
 
 #include <QMimeData>
 #include <QDrag>
@@ -35,8 +36,8 @@ Graph::Graph()
     setFlag(ItemIsMovable);
     setFlag(ItemIsSelectable);
     setFlag(ItemIsFocusable);
-    setCacheMode(DeviceCoordinateCache);
     moved = 0;
+    boundsValid = false;
     setAcceptHoverEvents(true);
     setZValue(0);
 }
@@ -100,16 +101,138 @@ void Graph::paint(QPainter *painter, const QStyleOptionGraphicsItem *option,
  * Purpose:     returns the bouding rectangle of the graph
  * Arguments:   none
  * Output:      none
- * Modifies:    none
+ * Modifies:    bounds, boundsValid
  * Returns:     boudingRect()
  * Assumptions: none
  * Bugs:        none
  * Notes:       returns the bounding rectangle that surrounds the nodes and edges
- *              of the graph
+ *              of the graph.  The rectangle is cached; it is grown in
+ *              place by childGeometryChanged() and only recomputed from
+ *              all of the children after it has been invalidated.
  */
 QRectF Graph::boundingRect() const
 {
-    return childrenBoundingRect();
+    if (!boundsValid)
+    {
+        bounds = childrenBoundingRect();
+        boundsValid = true;
+    }
+    return bounds;
+}
+
+
+/*
+ * Name:        childRect()
+ * Purpose:     returns the area a child item covers in its parent
+ * Arguments:   QGraphicsItem *
+ * Output:      none
+ * Modifies:    none
+ * Returns:     QRectF in the coordinates of the child's parent
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       This is the child's contribution to childrenBoundingRect().
+ *              Nodes clip their labels, and a graph's own bounding
+ *              rect already covers its children, so only edges
+ *              (whose labels may stick out) need their children added.
+ */
+QRectF Graph::childRect(const QGraphicsItem * child)
+{
+    QRectF rect = child->boundingRect();
+    if (child->type() != Graph::Type
+        && !(child->flags() & QGraphicsItem::ItemClipsChildrenToShape))
+        rect |= child->childrenBoundingRect();
+    return child->mapRectToParent(rect);
+}
+
+
+/*
+ * Name:        childGeometryChanged()
+ * Purpose:     keeps the cached bounding rect in step with a child that
+ *              moved or changed size
+ * Arguments:   the child's old and new rect (see childRect())
+ * Output:      none
+ * Modifies:    bounds, boundsValid, and the same in any parent graph
+ * Returns:     none
+ * Assumptions: the arguments are in the coordinates of this graph
+ * Bugs:        none
+ * Notes:       Growing is done in place.  If the child was on the
+ *              edge of the graph and moved away from it the new bounds
+ *              can't be known without looking at every child, so the
+ *              cache is just marked invalid and rebuilt when next asked.
+ */
+void Graph::childGeometryChanged(const QRectF &oldRect, const QRectF &newRect)
+{
+    if (!boundsValid)
+        return;
+
+    bool shrinks = (oldRect.left() <= bounds.left()
+                    && newRect.left() > oldRect.left())
+        || (oldRect.top() <= bounds.top()
+            && newRect.top() > oldRect.top())
+        || (oldRect.right() >= bounds.right()
+            && newRect.right() < oldRect.right())
+        || (oldRect.bottom() >= bounds.bottom()
+            && newRect.bottom() < oldRect.bottom());
+
+    if (shrinks)
+    {
+        updateBounds();
+        return;
+    }
+
+    if (newRect.left() >= bounds.left() && newRect.top() >= bounds.top()
+        && newRect.right() <= bounds.right()
+        && newRect.bottom() <= bounds.bottom())
+        return;
+
+    QRectF oldBounds = bounds;
+    prepareGeometryChange();
+    bounds = bounds.united(newRect);
+
+    Graph * parent = qgraphicsitem_cast<Graph *>(parentItem());
+    if (parent != nullptr)
+        parent->childGeometryChanged(mapRectToParent(oldBounds),
+                                     mapRectToParent(bounds));
+}
+
+
+/*
+ * Name:        itemChange()
+ * Purpose:     keeps the cached bounding rect up to date when children
+ *              are added or removed
+ * Arguments:   GraphicsItemChange, QVariant value
+ * Output:      none
+ * Modifies:    bounds, boundsValid
+ * Returns:     QVariant
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       A removed child may be half destroyed already, so it
+ *              is not looked at; the bounds are just recomputed later.
+ */
+QVariant Graph::itemChange(GraphicsItemChange change, const QVariant &value)
+{
+    switch (change)
+    {
+      case ItemChildAddedChange:
+      {
+        QGraphicsItem * child = value.value<QGraphicsItem *>();
+        if (child != nullptr && boundsValid)
+        {
+            QRectF rect = childRect(child);
+            childGeometryChanged(rect, rect);
+        }
+        break;
+      }
+
+      case ItemChildRemovedChange:
+        updateBounds();
+        break;
+
+      default:
+        break;
+    };
+
+    return QGraphicsItem::itemChange(change, value);
 }
 
 /*
@@ -117,29 +240,18 @@ QRectF Graph::boundingRect() const
  * Purpose:     sets the Rotation of the graph
  * Arguments:   qreal
  * Output:      none
- * Modifies:    the graph, node and edge of the graph
+ * Modifies:    the graph
  * Returns:     none
  * Assumptions: none
  * Bugs:        none
- * Notes:       the nodes and edge labels need to be rotated in the opposite direction
- *              otherwise the labels of the edges and nodes won't be easily read
+ * Notes:       The node and edge labels used to be rotated in the
+ *              opposite direction here so they could still be read.
+ *              Labels now keep themselves upright when they are
+ *              painted (see Label::paint()), so this is a single
+ *              transform change no matter how big the graph is.
  */
 void Graph::setRotation(qreal aRotation)
 {
-    for (QGraphicsItem * child: this->childItems())
-    {
-        if (child != nullptr || child != 0)
-        {
-            if (child->type() == Node::Type)
-            {
-                child->setRotation(-aRotation);
-            }
-            else if(child->type() == Edge::Type)
-            {
-                child->setRotation(-aRotation);
-            }
-        }
-    }
     QGraphicsItem::setRotation(aRotation);
 }
 
@@ -162,3 +274,60 @@ QGraphicsItem *Graph::getRootParent()
     return parent;
 }
 
+
+/*
+ * Name:        updateBounds()
+ * Purpose:     tells the scene that the bounding rectangle of the graph,
+ *              and of every graph that contains it, may have changed
+ * Arguments:   none
+ * Output:      none
+ * Modifies:    the scene's idea of the geometry of the graph(s),
+ *              boundsValid
+ * Returns:     none
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       Called once when the user lets go of a dragged node,
+ *              rather than on every position change of the node.
+ *              The bounds themselves are recomputed lazily.
+ *              A graph whose bounds are already invalid hasn't been
+ *              asked for them since, and neither have the graphs that
+ *              contain it (asking them asks it), so the scene already
+ *              knows; stopping there keeps removing many children at
+ *              once (see CanvasScene::deleteSelection()) linear.
+ */
+void Graph::updateBounds()
+{
+    Graph * graph = this;
+    while (graph != nullptr && graph->boundsValid)
+    {
+        graph->prepareGeometryChange();
+        graph->boundsValid = false;
+        graph = qgraphicsitem_cast<Graph *>(graph->parentItem());
+    }
+}
+
+
+/*
+ * Name:        setCached()
+ * Purpose:     turns the single-image cache of the graph on or off
+ * Arguments:   bool
+ * Output:      none
+ * Modifies:    the graphics effect of the graph
+ * Returns:     none
+ * Assumptions: the graph is not inside another graph
+ * Bugs:        none
+ * Notes:       While cached, the graph and all of its children are
+ *              drawn as one image (see graphcache.cpp).  That only
+ *              pays off while nothing inside the graph changes, so
+ *              the canvas turns it off in the editing modes.
+ */
+void Graph::setCached(bool cached)
+{
+    if (cached)
+    {
+        if (graphicsEffect() == nullptr)
+            setGraphicsEffect(new GraphCache());
+    }
+    else if (graphicsEffect() != nullptr)
+        setGraphicsEffect(nullptr);	// Deletes the old effect.
+}
@@ -35,13 +35,20 @@ public:
     QRectF boundingRect() const;
     void setRotation(qreal aRotation);
     QGraphicsItem *getRootParent();
+    void updateBounds();
+    void setCached(bool cached);
+    void childGeometryChanged(const QRectF &oldRect, const QRectF &newRect);
+    static QRectF childRect(const QGraphicsItem * child);
 
 protected:
+    QVariant itemChange(GraphicsItemChange change, const QVariant &value);
     void mouseReleaseEvent(QGraphicsSceneMouseEvent *event);
     void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget);
 
 private:
      int moved;
+     mutable QRectF bounds;	// Cached value of boundingRect().
+     mutable bool boundsValid;	// False when bounds must be recomputed.
 };
 
 #endif // GRAPH_H
@@ -0,0 +1,82 @@
+/*
+ * File:    graphcache.cpp
+ * Date:    2026/10/18
+ * Version: 1.0
+ *
+ * Purpose: A graphics effect that composites a graph and everything in
+ *          it into a single image, so an idle graph costs one pixmap
+ *          blit per repaint instead of a paint() call per node and edge.
+ *
+ * Notes:   The image itself is kept by Qt (see QGraphicsEffect::
+ *          sourcePixmap()).  Qt throws it away whenever the graph or
+ *          anything in it is updated, and whenever the view transform
+ *          changes by more than a translation (e.g. on zoom), so the
+ *          next repaint renders it again at the new zoom level.
+ */
+
+#include "graphcache.h"
+
+#include <QPainter>
+#include <QPaintDevice>
+#include <QPixmap>
+
+
+/*
+ * Name:        GraphCache
+ * Purpose:     Constructor for the GraphCache effect.
+ * Arguments:   QObject *
+ * Output:      none
+ * Modifies:    none
+ * Returns:     none
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       none
+ */
+
+GraphCache::GraphCache(QObject * parent)
+    : QGraphicsEffect(parent)
+{
+}
+
+
+/*
+ * Name:        draw()
+ * Purpose:     Draws the cached image of the graph.
+ * Arguments:   QPainter *
+ * Output:      The graph, as one pixmap.
+ * Modifies:    nothing
+ * Returns:     nothing
+ * Assumptions: none
+ * Bugs:        Qt does not keep the image of a graph that is only
+ *              partly inside the view, so such graphs are still
+ *              painted item by item.
+ * Notes:       Anything that is not painting the screen (saving an
+ *              image or an SVG file) gets the items painted directly,
+ *              so exported drawings are not limited to the resolution
+ *              of the screen.
+ */
+
+void
+GraphCache::draw(QPainter * painter)
+{
+    if (painter->device() == nullptr
+        || painter->device()->devType() != QInternal::Widget)
+    {
+        drawSource(painter);
+        return;
+    }
+
+    QPoint offset;
+    QPixmap pixmap = sourcePixmap(Qt::DeviceCoordinates, &offset,
+                                  QGraphicsEffect::NoPad);
+    if (pixmap.isNull())
+    {
+        drawSource(painter);
+        return;
+    }
+
+    painter->save();
+    painter->setWorldTransform(QTransform());
+    painter->drawPixmap(offset, pixmap);
+    painter->restore();
+}
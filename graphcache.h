@@ -0,0 +1,24 @@
+/*
+ * File:	graphcache.h
+ * Date:	2026/10/18
+ * Version:	1.0
+ *
+ * Purpose:	Declares the effect used to cache a whole graph as one image.
+ */
+
+#ifndef GRAPHCACHE_H
+#define GRAPHCACHE_H
+
+#include <QGraphicsEffect>
+
+class GraphCache : public QGraphicsEffect
+{
+    Q_OBJECT
+public:
+    GraphCache(QObject * parent = 0);
+
+protected:
+    void draw(QPainter * painter);
+};
+
+#endif // GRAPHCACHE_H
@@ -0,0 +1,318 @@
+/*
+ * File:    graphdescription.cpp
+ * Date:    2026/10/18
+ * Version: 1.0
+ *
+ * Purpose: A description of a graph that has no QGraphicsItems in it.
+ *          The generators in BasicGraphs write into one of these, so
+ *          they can run on any thread, and the result is turned into
+ *          Nodes and Edges by materialize() on the GUI thread.
+ *
+ * Notes:   Nodes are numbered in the order they are added, which is
+ *          also the order of the Nodes made by materialize(), and so
+ *          the order in which the preview numbers their labels.
+ */
+
+#include "graphdescription.h"
+#include "graph.h"
+#include "node.h"
+#include "edge.h"
+#include "implicitedges.h"
+
+
+/*
+ * Name:        GraphDescription
+ * Purpose:     Constructor for an empty description.
+ * Arguments:   none
+ * Output:      none
+ * Modifies:    none
+ * Returns:     none
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       none
+ */
+
+GraphDescription::GraphDescription()
+{
+}
+
+
+/*
+ * Name:        clear
+ * Purpose:     Removes all of the nodes and edges.
+ * Arguments:   none
+ * Output:      none
+ * Modifies:    positions, roles, groups, edges
+ * Returns:     none
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       none
+ */
+
+void
+GraphDescription::clear()
+{
+    positions.clear();
+    roles.clear();
+    groups.clear();
+    edges.clear();
+    implicitEdges.clear();
+}
+
+
+/*
+ * Name:        reserve
+ * Purpose:     Makes room for a number of nodes and edges.
+ * Arguments:   the number of nodes and of edges
+ * Output:      none
+ * Modifies:    the capacity of positions, roles, groups and edges
+ * Returns:     none
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       Only an optimization; the arrays grow as needed anyway.
+ */
+
+void
+GraphDescription::reserve(int numOfNodes, int numOfEdges)
+{
+    positions.reserve(numOfNodes);
+    roles.reserve(numOfNodes);
+    groups.reserve(numOfNodes);
+    edges.reserve(numOfEdges);
+}
+
+
+/*
+ * Name:        addNode
+ * Purpose:     Adds a node.
+ * Arguments:   its position, its role, and the group (e.g. which of
+ *              the cycles of a double cycle) it belongs to
+ * Output:      none
+ * Modifies:    positions, roles, groups
+ * Returns:     the index of the new node
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       none
+ */
+
+int
+GraphDescription::addNode(qreal x, qreal y, int role, int group)
+{
+    positions.append(QPointF(x, y));
+    roles.append(role);
+    groups.append(group);
+    return positions.count() - 1;
+}
+
+
+/*
+ * Name:        addNodes
+ * Purpose:     Adds a number of nodes at once.
+ * Arguments:   how many, their role and group
+ * Output:      none
+ * Modifies:    positions, roles, groups
+ * Returns:     the index of the first new node; the others follow it
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       The new nodes are all at (0, 0).  They are meant to be
+ *              placed by one of the functions in coordinatekernels.h,
+ *              writing straight into positions.data() + the index.
+ */
+
+int
+GraphDescription::addNodes(int count, int role, int group)
+{
+    int first = positions.count();
+
+    positions.resize(first + count);
+    roles.insert(roles.end(), count, role);
+    groups.insert(groups.end(), count, group);
+    return first;
+}
+
+
+/*
+ * Name:        addEdge
+ * Purpose:     Adds an edge between two nodes.
+ * Arguments:   the indices of the source and destination nodes
+ * Output:      none
+ * Modifies:    edges
+ * Returns:     none
+ * Assumptions: Both nodes have been added.
+ * Bugs:        none
+ * Notes:       none
+ */
+
+void
+GraphDescription::addEdge(int source, int dest)
+{
+    Description_Edge edge;
+    edge.source = source;
+    edge.dest = dest;
+    edges.append(edge);
+}
+
+
+/*
+ * Name:        addImplicitEdges
+ * Purpose:     Adds every edge of a complete or complete bipartite
+ *              set of nodes, without listing them.
+ * Arguments:   AllPairs or Across, and the first index and count of
+ *              the one or two ranges of nodes
+ * Output:      none
+ * Modifies:    implicitEdges
+ * Returns:     none
+ * Assumptions: The nodes have been added.
+ * Bugs:        none
+ * Notes:       Becomes an ImplicitEdges item in materialize().
+ */
+
+void
+GraphDescription::addImplicitEdges(int family, int first, int firstCount,
+				   int second, int secondCount)
+{
+    Description_Implicit implicit;
+    implicit.family = family;
+    implicit.first = first;
+    implicit.firstCount = firstCount;
+    implicit.second = second;
+    implicit.secondCount = secondCount;
+    implicitEdges.append(implicit);
+}
+
+
+/*
+ * Name:        expandImplicitEdges
+ * Purpose:     Lists every implicit edge as an ordinary edge.
+ * Arguments:   none
+ * Output:      none
+ * Modifies:    edges, implicitEdges
+ * Returns:     none
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       For writers that only understand edges (see sweep.cpp).
+ *              Don't use it on a description that will be
+ *              materialized, or the point of implicit edges is lost.
+ */
+
+void
+GraphDescription::expandImplicitEdges()
+{
+    foreach (const Description_Implicit & e, implicitEdges)
+    {
+	if (e.family == AllPairs)
+	{
+	    for (int i = 0; i < e.firstCount; i++)
+		for (int j = i + 1; j < e.firstCount; j++)
+		    addEdge(e.first + i, e.first + j);
+	}
+	else
+	{
+	    for (int i = 0; i < e.firstCount; i++)
+		for (int j = 0; j < e.secondCount; j++)
+		    addEdge(e.first + i, e.second + j);
+	}
+    }
+    implicitEdges.clear();
+}
+
+
+int
+GraphDescription::nodeCount() const
+{
+    return positions.count();
+}
+
+
+int
+GraphDescription::edgeCount() const
+{
+    return edges.count();
+}
+
+
+/*
+ * Name:        materialize
+ * Purpose:     Creates the Nodes and Edges described.
+ * Arguments:   the Graph to put them in
+ * Output:      none
+ * Modifies:    graph, including its Nodes lists
+ * Returns:     none
+ * Assumptions: Called on the GUI thread.  For speed graph should not
+ *              be in a scene yet, so that the scene indexes all of
+ *              the new items at once when graph is added to it.
+ * Bugs:        none
+ * Notes:       The nodes are all made before the edges, so every
+ *              edge is only adjusted once.
+ */
+
+void
+GraphDescription::materialize(Graph * graph) const
+{
+    QVector<Node *> nodes(positions.count());
+
+    for (int i = 0; i < positions.count(); i++)
+    {
+	Node * node = new Node();
+	node->setPos(positions.at(i));
+	node->setParentItem(graph);
+	nodes[i] = node;
+
+	int group = groups.at(i);
+	switch (roles.at(i))
+	{
+	  case Cycle:
+	    graph->nodes.cycle.append(node);
+	    break;
+	  case DoubleCycle:
+	    while (graph->nodes.double_cycle.count() <= group)
+		graph->nodes.double_cycle.append(QList<Node *>());
+	    graph->nodes.double_cycle[group].append(node);
+	    break;
+	  case Blade:
+	    while (graph->nodes.list_of_cycles.count() <= group)
+		graph->nodes.list_of_cycles.append(QList<Node *>());
+	    graph->nodes.list_of_cycles[group].append(node);
+	    break;
+	  case Center:
+	    graph->nodes.center = node;
+	    break;
+	  case BipartiteTop:
+	    graph->nodes.bipartite_top.append(node);
+	    break;
+	  case BipartiteBottom:
+	    graph->nodes.bipartite_bottom.append(node);
+	    break;
+	  case Grid:
+	    graph->nodes.grid.append(node);
+	    break;
+	  case Path:
+	    graph->nodes.path.append(node);
+	    break;
+	  case Heap:
+	    if (graph->nodes.binaryHeap.count() <= group)
+		graph->nodes.binaryHeap.resize(group + 1);
+	    graph->nodes.binaryHeap[group] = node;
+	    break;
+	  default:
+	    break;
+	}
+    }
+
+    foreach (const Description_Edge & e, edges)
+    {
+	Edge * edge = new Edge(nodes.at(e.source), nodes.at(e.dest));
+	edge->setParentItem(graph);
+    }
+
+    foreach (const Description_Implicit & e, implicitEdges)
+    {
+	ImplicitEdges * implicit
+	    = new ImplicitEdges(e.family == AllPairs
+				? ImplicitEdges::AllPairs
+				: ImplicitEdges::Across,
+				nodes.mid(e.first, e.firstCount),
+				nodes.mid(e.second, e.secondCount));
+	implicit->setParentItem(graph);
+    }
+}
@@ -0,0 +1,64 @@
+/*
+ * File:	graphdescription.h
+ * Date:	2026/10/18
+ * Version:	1.0
+ *
+ * Purpose:	Declares a plain description of a graph (node positions,
+ *		node roles and edges) that can be built away from the
+ *		scene and turned into Nodes and Edges in one step.
+ */
+
+#ifndef GRAPHDESCRIPTION_H
+#define GRAPHDESCRIPTION_H
+
+#include <QPointF>
+#include <QVector>
+
+class Graph;
+
+// One edge, as the indices of its two end nodes.
+typedef struct dEdge
+{
+    int source;
+    int dest;
+} Description_Edge;
+
+// A set of edges that are not listed one by one: every pair of nodes
+// in [first, first + firstCount), or every pair with one node there
+// and one in [second, second + secondCount).  See ImplicitEdges.
+typedef struct dImplicit
+{
+    int family;
+    int first, firstCount;
+    int second, secondCount;
+} Description_Implicit;
+
+class GraphDescription
+{
+public:
+    // Which of the lists in Graph::Nodes a node goes in.
+    enum Node_Role {Plain, Cycle, DoubleCycle, Blade, Center,
+		    BipartiteTop, BipartiteBottom, Grid, Path, Heap};
+    enum Implicit_Family {AllPairs, Across};
+
+    GraphDescription();
+    void clear();
+    void reserve(int numOfNodes, int numOfEdges);
+    int addNode(qreal x, qreal y, int role = Plain, int group = 0);
+    int addNodes(int count, int role = Plain, int group = 0);
+    void addEdge(int source, int dest);
+    void addImplicitEdges(int family, int first, int firstCount,
+			  int second = 0, int secondCount = 0);
+    void expandImplicitEdges();
+    int nodeCount() const;
+    int edgeCount() const;
+    void materialize(Graph * graph) const;
+
+    QVector<QPointF> positions;
+    QVector<int> roles;
+    QVector<int> groups;	// Which cycle / heap slot, by role.
+    QVector<Description_Edge> edges;
+    QVector<Description_Implicit> implicitEdges;
+};
+
+#endif // GRAPHDESCRIPTION_H
@@ -0,0 +1,504 @@
+/*
+ * File:    graphmetrics.cpp
+ * Date:    2026/10/18
+ * Version: 1.0
+ *
+ * Purpose: Measures how good a drawing of a graph is: the number of
+ *          edge crossings, the number of overlapping nodes, the
+ *          smallest angle between edges at a node, and the spread of
+ *          the edge lengths.
+ *
+ * Notes:   This works on a LayoutGraph, so it can run on a worker
+ *          thread while the canvas stays responsive.  Crossings are
+ *          counted with the Bentley-Ottmann sweep in
+ *          O((m + k) log m) time for m edges and k crossings, and
+ *          overlaps with a grid of cells one node wide.
+ *          The edges of an ImplicitEdges (a complete graph drawn as
+ *          one item) aren't in the copy the panel measures, since
+ *          there may be millions; the crossings, angles and lengths of
+ *          such a graph are not given.  Nor are the crossings of a
+ *          graph with more than METRICS_MAX_SWEEP_EDGES edges, since
+ *          the sweep keeps a segment and two events for every edge.
+ */
+
+#include "graphmetrics.h"
+#include "layoutgraph.h"
+#include "coordinatekernels.h"
+
+#include <QHash>
+#include <QPointF>
+#include <QVector>
+#include <QtMath>
+#include <algorithm>
+#include <set>
+#include <vector>
+
+// The drawing is rotated by this many radians before the sweep, so
+// that (in practice) no edge is vertical and no two endpoints share an
+// x coordinate.  Rotating doesn't change which edges cross.
+#define METRICS_ROTATION	0.3183098861837907
+
+// Counting stops after this many crossings; the count is then a lower
+// bound.  (A large complete graph has more crossings than can be
+// counted one at a time.)
+#define METRICS_MAX_CROSSINGS	1000000
+
+// Crossings aren't counted in a drawing with more edges than this.
+#define METRICS_MAX_SWEEP_EDGES	200000
+
+// How many events are handled between checks for cancellation.
+#define METRICS_CANCEL_INTERVAL	4096
+
+// The kinds of event, in the order they are handled at one point.
+#define SWEEP_END		0
+#define SWEEP_CROSS		1
+#define SWEEP_START		2
+
+typedef struct
+{
+    int from;			// The nodes at the ends of the edge.
+    int to;
+    QPointF left;		// The rotated end with the smaller x.
+    QPointF right;
+    qreal slope;
+} Sweep_Segment;
+
+typedef struct
+{
+    qreal x;
+    qreal y;
+    int kind;
+    int a;			// The segment; for a crossing, the one
+    int b;			// below, and the one above.
+} Sweep_Event;
+
+
+/*
+ * Name:        event_after
+ * Purpose:     Orders the events of the sweep, for std::push_heap().
+ * Arguments:   two events
+ * Output:      none
+ * Modifies:    nothing
+ * Returns:     true if p is handled after q
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       Events are handled left to right, then bottom to top,
+ *              then by kind.
+ */
+
+static bool
+event_after(const Sweep_Event & p, const Sweep_Event & q)
+{
+    if (p.x != q.x)
+	return p.x > q.x;
+    if (p.y != q.y)
+	return p.y > q.y;
+    return p.kind > q.kind;
+}
+
+
+/*
+ * Name:        orientation
+ * Purpose:     Tells which side of the line through p and q r is on.
+ * Arguments:   three points
+ * Output:      none
+ * Modifies:    nothing
+ * Returns:     positive if p, q, r turn left, negative if they turn
+ *              right, and 0 if they are collinear
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       none
+ */
+
+static inline qreal
+orientation(const QPointF & p, const QPointF & q, const QPointF & r)
+{
+    return (q.x() - p.x()) * (r.y() - p.y())
+	- (q.y() - p.y()) * (r.x() - p.x());
+}
+
+
+/*
+ * Name:        cross_point
+ * Purpose:     Finds where two segments cross.
+ * Arguments:   the node positions, the cosine and sine of the
+ *              rotation, and the segments
+ * Output:      none
+ * Modifies:    *point
+ * Returns:     false if they don't cross
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       Only proper crossings count: segments that touch, or
+ *              that share an end (as edges at the same node do), or
+ *              that overlap along a line don't cross.  The test uses
+ *              the unrotated positions, since rotating would turn a
+ *              node lying exactly on an edge into a near miss or a
+ *              crossing.  The crossing is found as a weighted
+ *              average of the ends, which is exact when the crossing
+ *              is at a representable point (a node on the grid, say),
+ *              and rotated just as the nodes were, so that it sorts
+ *              exactly with a node it passes through.
+ */
+
+static bool
+cross_point(const QVector<QPointF> & positions, qreal c, qreal s,
+	    const Sweep_Segment & first, const Sweep_Segment & second,
+	    QPointF * point)
+{
+    const QPointF & a = positions.at(first.from);
+    const QPointF & b = positions.at(first.to);
+    const QPointF & p = positions.at(second.from);
+    const QPointF & q = positions.at(second.to);
+    qreal o1 = orientation(a, b, p);
+    qreal o2 = orientation(a, b, q);
+    qreal o3 = orientation(p, q, a);
+    qreal o4 = orientation(p, q, b);
+
+    if (!((o1 > 0 && o2 < 0) || (o1 < 0 && o2 > 0))
+	|| !((o3 > 0 && o4 < 0) || (o3 < 0 && o4 > 0)))
+	return false;
+    qreal x = (o3 * b.x() - o4 * a.x()) / (o3 - o4);
+    qreal y = (o3 * b.y() - o4 * a.y()) / (o3 - o4);
+    *point = QPointF(x * c - y * s, x * s + y * c);
+    return true;
+}
+
+
+/*
+ * Name:        count_crossings
+ * Purpose:     Counts the pairs of edges that cross.
+ * Arguments:   the graph, and the metrics to fill in
+ * Output:      none
+ * Modifies:    metrics->crossings, metrics->crossingsCapped,
+ *              metrics->complete
+ * Returns:     none
+ * Assumptions: none
+ * Bugs:        Where several edges meet at a point that can't be
+ *              represented exactly, rounding may put the events there
+ *              out of order, and a crossing may be missed.
+ * Notes:       Bentley-Ottmann.  The status is the edges the sweep
+ *              line meets, from bottom to top, in a std::set of
+ *              "slots"; a crossing swaps the edges in two adjacent
+ *              slots, so the set never needs re-sorting.  An edge is
+ *              only compared with the sweep line when it is inserted.
+ *              A pair of neighbours is scheduled to cross only if the
+ *              lower one is steeper, so no pair is counted twice, and
+ *              stale crossing events (whose edges are no longer
+ *              neighbours, or have ended) are dropped.
+ */
+
+static void
+count_crossings(const LayoutGraph * graph, Graph_Metrics * metrics)
+{
+    const int n = graph->nodeCount();
+    const qreal c = qCos(METRICS_ROTATION), s = qSin(METRICS_ROTATION);
+    QVector<QPointF> rotated(n);
+    QVector<Sweep_Segment> segments;
+    QVector<Sweep_Event> events;
+
+    for (int i = 0; i < n; i++)
+    {
+	const QPointF & p = graph->positions.at(i);
+	rotated[i] = QPointF(p.x() * c - p.y() * s, p.x() * s + p.y() * c);
+    }
+    for (int i = 0; i < n; i++)
+    {
+	const int * next = graph->neighbours(i);
+	for (int e = 0; e < graph->degree(i); e++)
+	{
+	    int j = next[e];
+	    if (j < i || rotated.at(i) == rotated.at(j))
+		continue;
+	    Sweep_Segment segment;
+	    segment.from = i;
+	    segment.to = j;
+	    bool leftFirst = rotated.at(i).x() < rotated.at(j).x()
+		|| (rotated.at(i).x() == rotated.at(j).x()
+		    && rotated.at(i).y() < rotated.at(j).y());
+	    segment.left = leftFirst ? rotated.at(i) : rotated.at(j);
+	    segment.right = leftFirst ? rotated.at(j) : rotated.at(i);
+	    qreal dx = segment.right.x() - segment.left.x();
+	    segment.slope = dx > 0
+		? (segment.right.y() - segment.left.y()) / dx : 1e300;
+	    int id = segments.count();
+	    segments.append(segment);
+	    events.append({segment.left.x(), segment.left.y(),
+			   SWEEP_START, id, -1});
+	    events.append({segment.right.x(), segment.right.y(),
+			   SWEEP_END, id, -1});
+	}
+    }
+    std::make_heap(events.begin(), events.end(), event_after);
+
+    // Slot k holds segment slotSegment[k]; segment i is in slot
+    // slotOf[i].  A segment starts out in its own slot.
+    const int m = segments.count();
+    QVector<int> slotSegment(m), slotOf(m);
+    qreal sweepX = 0;
+    for (int i = 0; i < m; i++)
+	slotSegment[i] = slotOf[i] = i;
+
+    auto y_at = [&](int segment)
+    {
+	const Sweep_Segment & t = segments.at(segment);
+	return sweepX <= t.left.x()
+	    ? t.left.y() : t.left.y() + t.slope * (sweepX - t.left.x());
+    };
+    auto below = [&](int p, int q)
+    {
+	int a = slotSegment.at(p), b = slotSegment.at(q);
+	qreal ya = y_at(a), yb = y_at(b);
+	if (qAbs(ya - yb) > 1e-9 * (qAbs(ya) + qAbs(yb) + 1))
+	    return ya < yb;
+	if (segments.at(a).slope != segments.at(b).slope)
+	    return segments.at(a).slope < segments.at(b).slope;
+	return a < b;
+    };
+    typedef std::set<int, decltype(below)> Status;
+    Status status(below);
+    std::vector<Status::iterator> where(m);
+
+    auto schedule = [&](Status::iterator lower, Status::iterator upper)
+    {
+	int a = slotSegment.at(*lower), b = slotSegment.at(*upper);
+	QPointF point;
+	if (segments.at(a).slope > segments.at(b).slope
+	    && cross_point(graph->positions, c, s, segments.at(a),
+			   segments.at(b), &point))
+	{
+	    events.append({point.x(), point.y(), SWEEP_CROSS, a, b});
+	    std::push_heap(events.begin(), events.end(), event_after);
+	}
+    };
+
+    metrics->crossings = 0;
+    metrics->crossingsCapped = false;
+    for (int handled = 0; !events.isEmpty(); handled++)
+    {
+	if (handled % METRICS_CANCEL_INTERVAL == 0 && graph->isCancelled())
+	{
+	    metrics->complete = false;
+	    return;
+	}
+	std::pop_heap(events.begin(), events.end(), event_after);
+	Sweep_Event event = events.last();
+	events.removeLast();
+	sweepX = event.x;
+
+	if (event.kind == SWEEP_START)
+	{
+	    Status::iterator at = status.insert(event.a).first;
+	    where[event.a] = at;
+	    if (at != status.begin())
+		schedule(std::prev(at), at);
+	    if (std::next(at) != status.end())
+		schedule(at, std::next(at));
+	}
+	else if (event.kind == SWEEP_END)
+	{
+	    Status::iterator at = where.at(slotOf.at(event.a));
+	    Status::iterator after = status.erase(at);
+	    where[slotOf.at(event.a)] = status.end();
+	    if (after != status.begin() && after != status.end())
+		schedule(std::prev(after), after);
+	}
+	else
+	{
+	    int lowerSlot = slotOf.at(event.a), upperSlot = slotOf.at(event.b);
+	    Status::iterator lower = where.at(lowerSlot);
+	    if (lower == status.end() || std::next(lower) == status.end()
+		|| *std::next(lower) != upperSlot)
+		continue;
+	    Status::iterator upper = std::next(lower);
+
+	    if (++metrics->crossings >= METRICS_MAX_CROSSINGS)
+	    {
+		metrics->crossingsCapped = true;
+		return;
+	    }
+	    slotSegment[lowerSlot] = event.b;
+	    slotSegment[upperSlot] = event.a;
+	    slotOf[event.a] = upperSlot;
+	    slotOf[event.b] = lowerSlot;
+	    if (lower != status.begin())
+		schedule(std::prev(lower), lower);
+	    if (std::next(upper) != status.end())
+		schedule(upper, std::next(upper));
+	}
+    }
+}
+
+
+/*
+ * Name:        count_overlaps
+ * Purpose:     Counts the pairs of nodes that overlap.
+ * Arguments:   the graph, and the metrics to fill in
+ * Output:      none
+ * Modifies:    metrics->overlaps, metrics->complete
+ * Returns:     none
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       The nodes are sorted by the grid cell (as wide as the
+ *              largest node) their centre is in, so two nodes can only
+ *              overlap if their cells touch, and each node is compared
+ *              only with the nodes in its own and the 8 surrounding
+ *              cells.
+ */
+
+static void
+count_overlaps(const LayoutGraph * graph, Graph_Metrics * metrics)
+{
+    const int n = graph->nodeCount();
+    const qreal cell = graph->nodeSize;
+    QVector<qint64> keys(n);
+    QVector<int> order(n);
+    QHash<qint64, int> first;
+
+    for (int i = 0; i < n; i++)
+    {
+	const QPointF & p = graph->positions.at(i);
+	keys[i] = grid_key(qFloor(p.x() / cell), qFloor(p.y() / cell));
+	order[i] = i;
+    }
+    std::sort(order.begin(), order.end(), [&](int a, int b)
+	      {
+		  return keys.at(a) < keys.at(b);
+	      });
+    for (int k = n - 1; k >= 0; k--)
+	first.insert(keys.at(order.at(k)), k);
+
+    metrics->overlaps = 0;
+    for (int i = 0; i < n; i++)
+    {
+	if (i % METRICS_CANCEL_INTERVAL == 0 && graph->isCancelled())
+	{
+	    metrics->complete = false;
+	    return;
+	}
+	const QPointF & p = graph->positions.at(i);
+	qint64 cx = qFloor(p.x() / cell), cy = qFloor(p.y() / cell);
+	for (int dx = -1; dx <= 1; dx++)
+	    for (int dy = -1; dy <= 1; dy++)
+	    {
+		qint64 key = grid_key(cx + dx, cy + dy);
+		for (int k = first.value(key, n);
+		     k < n && keys.at(order.at(k)) == key; k++)
+		{
+		    int j = order.at(k);
+		    if (j <= i)
+			continue;
+		    QPointF d = graph->positions.at(j) - p;
+		    qreal reach = (graph->diameters.at(i)
+				   + graph->diameters.at(j)) / 2;
+		    if (d.x() * d.x() + d.y() * d.y() < reach * reach)
+			metrics->overlaps++;
+		}
+	    }
+    }
+}
+
+
+/*
+ * Name:        measure_edges
+ * Purpose:     Finds the edge length statistics and the smallest
+ *              angle between edges.
+ * Arguments:   the graph, and the metrics to fill in
+ * Output:      none
+ * Modifies:    *metrics
+ * Returns:     none
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       Each node's edges are sorted by direction, so the
+ *              smallest angle at the node is between two that are
+ *              next to each other (or the last and the first).
+ */
+
+static void
+measure_edges(const LayoutGraph * graph, Graph_Metrics * metrics)
+{
+    const int n = graph->nodeCount();
+    QVector<qreal> angles;
+    qreal sum = 0, squares = 0;
+
+    metrics->numOfEdges = 0;
+    metrics->minLength = metrics->maxLength = 0;
+    metrics->minAngle = -1;
+    for (int i = 0; i < n; i++)
+    {
+	const QPointF & p = graph->positions.at(i);
+	const int * next = graph->neighbours(i);
+	angles.clear();
+	for (int e = 0; e < graph->degree(i); e++)
+	{
+	    QPointF d = graph->positions.at(next[e]) - p;
+	    if (d.x() != 0 || d.y() != 0)
+		angles.append(qAtan2(d.y(), d.x()));
+	    if (next[e] < i)
+		continue;
+
+	    qreal length = qSqrt(d.x() * d.x() + d.y() * d.y());
+	    if (metrics->numOfEdges == 0 || length < metrics->minLength)
+		metrics->minLength = length;
+	    metrics->maxLength = qMax(metrics->maxLength, length);
+	    sum += length;
+	    squares += length * length;
+	    metrics->numOfEdges++;
+	}
+
+	if (angles.count() < 2)
+	    continue;
+	std::sort(angles.begin(), angles.end());
+	qreal smallest = angles.first() + 2 * M_PI - angles.last();
+	for (int a = 1; a < angles.count(); a++)
+	    smallest = qMin(smallest, angles.at(a) - angles.at(a - 1));
+	smallest = qRadiansToDegrees(smallest);
+	if (metrics->minAngle < 0 || smallest < metrics->minAngle)
+	    metrics->minAngle = smallest;
+    }
+
+    if (metrics->numOfEdges > 0)
+    {
+	metrics->meanLength = sum / metrics->numOfEdges;
+	metrics->lengthDeviation
+	    = qSqrt(qMax((qreal)0, squares / metrics->numOfEdges
+			 - metrics->meanLength * metrics->meanLength));
+    }
+    else
+	metrics->meanLength = metrics->lengthDeviation = 0;
+}
+
+
+/*
+ * Name:        measure_graph
+ * Purpose:     Measures the drawing of a graph.
+ * Arguments:   the graph
+ * Output:      none
+ * Modifies:    nothing
+ * Returns:     the metrics
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       Safe to call on a worker thread.  Stops early (with
+ *              complete false) if the graph is cancelled.  The graph
+ *              may be a quick copy (see LayoutGraph::LayoutGraph()),
+ *              whose implicit edges are only counted.
+ */
+
+Graph_Metrics
+measure_graph(const LayoutGraph * graph)
+{
+    Graph_Metrics metrics;
+
+    metrics.numOfNodes = graph->nodeCount();
+    metrics.complete = true;
+    metrics.crossings = metrics.overlaps = 0;
+    metrics.crossingsCapped = false;
+    measure_edges(graph, &metrics);
+    metrics.edgesKnown = graph->implicitPairs == 0;
+    metrics.crossingsKnown = metrics.edgesKnown
+	&& metrics.numOfEdges <= METRICS_MAX_SWEEP_EDGES;
+    metrics.numOfEdges += graph->implicitPairs;
+    count_overlaps(graph, &metrics);
+    if (metrics.complete && metrics.crossingsKnown)
+	count_crossings(graph, &metrics);
+    return metrics;
+}
@@ -0,0 +1,38 @@
+/*
+ * File:	graphmetrics.h
+ * Date:	2026/10/18
+ * Version:	1.0
+ *
+ * Purpose:	Declares the measures of drawing quality shown in the
+ *		metrics panel.
+ */
+
+#ifndef GRAPHMETRICS_H
+#define GRAPHMETRICS_H
+
+#include <QtGlobal>
+
+class LayoutGraph;
+
+typedef struct
+{
+    int numOfNodes;
+    qint64 numOfEdges;
+    bool crossingsKnown;	// False if the edges weren't swept.
+    qint64 crossings;		// Only a lower bound if crossingsCapped.
+    bool crossingsCapped;
+    bool edgesKnown;		// False if the angles and lengths below
+				// leave out the edges of ImplicitEdges.
+    qint64 overlaps;		// Pairs of nodes that overlap.
+    qreal minAngle;		// Smallest angle between two edges at a
+				// node, in degrees; -1 if no node has two.
+    qreal minLength;		// Edge lengths, in pixels; all 0 if there
+    qreal maxLength;		// are no edges.
+    qreal meanLength;
+    qreal lengthDeviation;	// Standard deviation of the edge lengths.
+    bool complete;		// False if the measuring was cancelled.
+} Graph_Metrics;
+
+Graph_Metrics measure_graph(const LayoutGraph * graph);
+
+#endif // GRAPHMETRICS_H
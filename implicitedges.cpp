@@ -0,0 +1,635 @@
+/*
+ * File:    implicitedges.cpp
+ * Date:    2026/10/18
+ * Version: 1.0
+ *
+ * Purpose: An item that draws every edge of a complete graph, or of a
+ *          complete bipartite graph, from its list of nodes.  K_2000
+ *          has about two million edges; as Edges that is two million
+ *          QGraphicsObjects (and Labels), as an ImplicitEdges it is
+ *          two thousand pointers.
+ *
+ * Notes:   An edge stops being implicit when it is deleted (it is
+ *          added to the removed set) or edited (an Edge is made for it
+ *          by materializePair() and it is added to the removed set).
+ *          When two graphs are joined the whole set is turned into
+ *          Edges (see CanvasEdit::materializeAll()), since joining
+ *          moves edges from one node to another.
+ *          The nodes know which ImplicitEdges they are in (see
+ *          Node::implicitEdges), so that moving a node moves its
+ *          edges, and deleting it removes them.
+ */
+
+#include "implicitedges.h"
+#include "node.h"
+#include "edge.h"
+#include "graph.h"
+
+#include <QPainter>
+#include <QStyleOptionGraphicsItem>
+
+// Number of lines handed to QPainter::drawLines() at once.
+#define LINE_BATCH_SIZE 4096
+
+// How close (in pixels, beyond half the pen width) a click must be
+// to a line to hit it.
+#define HIT_DISTANCE	3
+
+
+/*
+ * Name:        ImplicitEdges
+ * Purpose:     Constructor for ImplicitEdges.
+ * Arguments:   the family and the one or two sets of nodes
+ * Output:      none
+ * Modifies:    the nodes' lists of implicit edges
+ * Returns:     none
+ * Assumptions: The nodes have the same parent, which this item
+ *              should be given too (positions are not mapped).
+ * Bugs:        none
+ * Notes:       none
+ */
+
+ImplicitEdges::ImplicitEdges(Family aFamily, const QVector<Node *> & firstSet,
+			     const QVector<Node *> & secondSet)
+{
+    family = aFamily;
+    first = firstSet;
+    second = secondSet;
+    penWidth = 1;
+    radius = 0;
+    edgeColour = Qt::black;
+    boundsValid = false;
+    setZValue(0);
+    setFlag(ItemUsesExtendedStyleOption);
+
+    foreach (Node * node, first)
+	node->implicitEdges.append(this);
+    foreach (Node * node, second)
+	node->implicitEdges.append(this);
+}
+
+
+/*
+ * Name:        key
+ * Purpose:     Packs the indices of a pair into a key for removed.
+ * Arguments:   index in first, index in first (AllPairs) or second
+ * Output:      none
+ * Modifies:    nothing
+ * Returns:     the key
+ * Assumptions: For AllPairs i < j.
+ * Bugs:        none
+ * Notes:       none
+ */
+
+quint64
+ImplicitEdges::key(int i, int j)
+{
+    return ((quint64)(quint32)i << 32) | (quint32)j;
+}
+
+
+/*
+ * Name:        indicesOf
+ * Purpose:     Finds the indices of the pair a - b.
+ * Arguments:   the two nodes, and where to put their indices
+ * Output:      none
+ * Modifies:    *i, *j
+ * Returns:     true if this item has an edge between the nodes
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       Linear in the number of nodes.
+ */
+
+bool
+ImplicitEdges::indicesOf(Node * source, Node * dest, int * i, int * j) const
+{
+    if (family == AllPairs)
+    {
+	*i = first.indexOf(source);
+	*j = first.indexOf(dest);
+	if (*i > *j)
+	    qSwap(*i, *j);
+    }
+    else
+    {
+	*i = first.indexOf(source);
+	*j = second.indexOf(dest);
+	if (*i < 0 || *j < 0)
+	{
+	    *i = first.indexOf(dest);
+	    *j = second.indexOf(source);
+	}
+    }
+    if (*i < 0 || *j < 0 || (family == AllPairs && *i == *j))
+	return false;
+    return !removed.contains(key(*i, *j));
+}
+
+
+/*
+ * Name:        boundingRect
+ * Purpose:     Returns the area covered by the edges.
+ * Arguments:   none
+ * Output:      none
+ * Modifies:    bounds, boundsValid
+ * Returns:     QRectF
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       The box of all of the nodes' centres, recomputed only
+ *              after a node has moved (see nodeMoved()).
+ */
+
+QRectF
+ImplicitEdges::boundingRect() const
+{
+    if (!boundsValid)
+    {
+	qreal left = 0, right = 0, top = 0, bottom = 0;
+	bool empty = true;
+
+	for (int s = 0; s < 2; s++)
+	    foreach (Node * node, s == 0 ? first : second)
+	    {
+		if (node == nullptr)
+		    continue;
+		QPointF p = node->pos();
+		if (empty)
+		{
+		    left = right = p.x();
+		    top = bottom = p.y();
+		    empty = false;
+		}
+		left = qMin(left, p.x());
+		right = qMax(right, p.x());
+		top = qMin(top, p.y());
+		bottom = qMax(bottom, p.y());
+	    }
+
+	qreal margin = penWidth / 2. + HIT_DISTANCE;
+	bounds = empty ? QRectF()
+	    : QRectF(QPointF(left, top), QPointF(right, bottom))
+	    .adjusted(-margin, -margin, margin, margin);
+	boundsValid = true;
+    }
+    return bounds;
+}
+
+
+/*
+ * Name:        contains
+ * Purpose:     Tells whether a point may be on one of the edges.
+ * Arguments:   QPointF, in item coordinates
+ * Output:      none
+ * Modifies:    nothing
+ * Returns:     bool
+ * Assumptions: none
+ * Bugs:        Points between the edges count as on the item.
+ * Notes:       The scene calls this for every hit test (hovering,
+ *              itemAt(), items()), so it only looks at the bounding
+ *              box.  pairAt() finds the edge itself, and is only used
+ *              where an edge is deleted or edited.
+ */
+
+bool
+ImplicitEdges::contains(const QPointF & point) const
+{
+    return boundingRect().contains(point);
+}
+
+
+/*
+ * Name:        pairAt
+ * Purpose:     Finds the edge under a point.
+ * Arguments:   QPointF in item coordinates, where to put its nodes
+ * Output:      none
+ * Modifies:    *source, *dest
+ * Returns:     true if an edge is under the point
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       Returns the closest edge within reach of the point.
+ *              Takes time proportional to the number of edges.
+ */
+
+bool
+ImplicitEdges::pairAt(const QPointF & point, Node ** source,
+		      Node ** dest) const
+{
+    if (!boundingRect().contains(point))
+	return false;
+
+    qreal reach = penWidth / 2. + HIT_DISTANCE;
+    qreal best = reach * reach;
+    bool found = false;
+
+    forEachPair([&](Node * a, Node * b)
+    {
+	QPointF p = a->pos(), q = b->pos();
+	QPointF d = q - p;
+	qreal length2 = d.x() * d.x() + d.y() * d.y();
+	qreal t = length2 > 0
+	    ? QPointF::dotProduct(point - p, d) / length2 : 0;
+	t = qBound(qreal(0), t, qreal(1));
+	QPointF off = point - (p + t * d);
+	qreal dist2 = off.x() * off.x() + off.y() * off.y();
+	if (dist2 <= best)
+	{
+	    best = dist2;
+	    *source = a;
+	    *dest = b;
+	    found = true;
+	}
+    });
+    return found;
+}
+
+
+/*
+ * Name:        paint
+ * Purpose:     Draws the edges.
+ * Arguments:   QPainter *, QStyleOptionGraphicsItem *, QWidget *
+ * Output:      The edges.
+ * Modifies:    nothing
+ * Returns:     none
+ * Assumptions: none
+ * Bugs:        Lines go centre to centre; the nodes are drawn on top.
+ * Notes:       Lines that don't cross the exposed area are skipped,
+ *              and the rest are drawn in batches.
+ */
+
+void
+ImplicitEdges::paint(QPainter * painter,
+		     const QStyleOptionGraphicsItem * option,
+		     QWidget * widget)
+{
+    Q_UNUSED(widget);
+
+    QRectF exposed = option->exposedRect.adjusted(-penWidth, -penWidth,
+						  penWidth, penWidth);
+    QVector<QLineF> lines;
+    lines.reserve(LINE_BATCH_SIZE);
+
+    QPen pen;
+    pen.setColor(edgeColour);
+    pen.setWidthF(penWidth);
+    pen.setCapStyle(Qt::RoundCap);
+    pen.setStyle(Qt::SolidLine);
+    painter->setPen(pen);
+
+    forEachPair([&](Node * a, Node * b)
+    {
+	QPointF p = a->pos(), q = b->pos();
+	if (qMax(p.x(), q.x()) < exposed.left()
+	    || qMin(p.x(), q.x()) > exposed.right()
+	    || qMax(p.y(), q.y()) < exposed.top()
+	    || qMin(p.y(), q.y()) > exposed.bottom())
+	    return;
+
+	lines.append(QLineF(p, q));
+	if (lines.count() == LINE_BATCH_SIZE)
+	{
+	    painter->drawLines(lines);
+	    lines.clear();
+	}
+    });
+    if (!lines.isEmpty())
+	painter->drawLines(lines);
+}
+
+
+void
+ImplicitEdges::setPenWidth(qreal aPenWidth)
+{
+    prepareGeometryChange();
+    penWidth = aPenWidth;
+    boundsValid = false;
+    update();
+}
+
+
+qreal
+ImplicitEdges::getPenWidth() const
+{
+    return penWidth;
+}
+
+
+void
+ImplicitEdges::setColour(QColor colour)
+{
+    edgeColour = colour;
+    update();
+}
+
+
+QColor
+ImplicitEdges::getColour() const
+{
+    return edgeColour;
+}
+
+
+/*
+ * Name:        setRadius
+ * Purpose:     Sets the node radius recorded for the edges.
+ * Arguments:   qreal, in inches
+ * Output:      none
+ * Modifies:    radius
+ * Returns:     none
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       Only used for the source and destination radii of the
+ *              Edges made from this item, and in exports.
+ */
+
+void
+ImplicitEdges::setRadius(qreal aRadius)
+{
+    radius = aRadius;
+}
+
+
+qreal
+ImplicitEdges::getRadius() const
+{
+    return radius;
+}
+
+
+/*
+ * Name:        pairCount
+ * Purpose:     Returns the number of edges this item stands for.
+ * Arguments:   none
+ * Output:      none
+ * Modifies:    nothing
+ * Returns:     qint64
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       removed only holds pairs of nodes that still exist.
+ */
+
+qint64
+ImplicitEdges::pairCount() const
+{
+    qint64 a = 0, b = 0;
+
+    foreach (Node * node, first)
+	if (node != nullptr)
+	    a++;
+    foreach (Node * node, second)
+	if (node != nullptr)
+	    b++;
+
+    return (family == AllPairs ? a * (a - 1) / 2 : a * b) - removed.count();
+}
+
+
+/*
+ * Name:        bytesUsed
+ * Purpose:     Estimates the memory the item uses.
+ * Arguments:   none
+ * Output:      none
+ * Modifies:    nothing
+ * Returns:     the estimate, in bytes
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       The pairs themselves take no memory; only the node
+ *              lists and the removed pairs do.  Used to charge a
+ *              deleted graph against the undo history.
+ */
+
+qint64
+ImplicitEdges::bytesUsed() const
+{
+    // A QSet entry holds the key and a next pointer and hash.
+    return sizeof(ImplicitEdges)
+	+ (first.capacity() + second.capacity()) * (qint64)sizeof(Node *)
+	+ removed.capacity() * (qint64)(sizeof(quint64) + 2 * sizeof(void *));
+}
+
+
+/*
+ * Name:        removePair
+ * Purpose:     Removes one edge.
+ * Arguments:   its two nodes
+ * Output:      none
+ * Modifies:    removed
+ * Returns:     none
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       none
+ */
+
+void
+ImplicitEdges::removePair(Node * source, Node * dest)
+{
+    int i, j;
+
+    if (indicesOf(source, dest, &i, &j))
+    {
+	removed.insert(key(i, j));
+	update();
+    }
+}
+
+
+/*
+ * Name:        restorePair
+ * Purpose:     Puts back an edge removed by removePair().
+ * Arguments:   its two nodes
+ * Output:      none
+ * Modifies:    removed
+ * Returns:     none
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       Used to undo a deletion.
+ */
+
+void
+ImplicitEdges::restorePair(Node * source, Node * dest)
+{
+    int i, j;
+
+    if (indicesOf(source, dest, &i, &j))
+    {
+	removed.remove(key(i, j));
+	update();
+    }
+}
+
+
+/*
+ * Name:        removeNode
+ * Purpose:     Removes a node, and so all of its edges.
+ * Arguments:   the node
+ * Output:      none
+ * Modifies:    first, second, removed, the node's list of implicit edges
+ * Returns:     where the node was, for restoreNode()
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       Called when a node is deleted.
+ */
+
+ImplicitEdges::Node_Slot
+ImplicitEdges::removeNode(Node * node)
+{
+    Node_Slot slot;
+    int i = first.indexOf(node);
+    int j = second.indexOf(node);
+
+    slot.first = i;
+    slot.second = j;
+    if (i >= 0)
+	first[i] = nullptr;
+    if (j >= 0)
+	second[j] = nullptr;
+
+    QSet<quint64>::iterator it = removed.begin();
+    while (it != removed.end())
+    {
+	int a = (int)(*it >> 32), b = (int)(*it & 0xffffffff);
+	if ((i >= 0 && (a == i || (family == AllPairs && b == i)))
+	    || (j >= 0 && b == j))
+	{
+	    slot.pairs.append(*it);
+	    it = removed.erase(it);
+	}
+	else
+	    ++it;
+    }
+
+    node->implicitEdges.removeAll(this);
+    nodeMoved();
+    return slot;
+}
+
+
+/*
+ * Name:        restoreNode
+ * Purpose:     Puts back a node removed by removeNode().
+ * Arguments:   the node, and where it was
+ * Output:      none
+ * Modifies:    first, second, removed, the node's list of implicit edges
+ * Returns:     none
+ * Assumptions: Nothing else has been put in its place.
+ * Bugs:        none
+ * Notes:       Used to undo a deletion.  The node's edges that had
+ *              been removed before it was stay removed.
+ */
+
+void
+ImplicitEdges::restoreNode(Node * node, const Node_Slot & slot)
+{
+    if (slot.first >= 0)
+	first[slot.first] = node;
+    if (slot.second >= 0)
+	second[slot.second] = node;
+    foreach (quint64 pair, slot.pairs)
+	removed.insert(pair);
+
+    node->implicitEdges.append(this);
+    nodeMoved();
+}
+
+
+/*
+ * Name:        materializePair
+ * Purpose:     Replaces one of the implicit edges by an Edge.
+ * Arguments:   its two nodes
+ * Output:      none
+ * Modifies:    removed, the parent graph
+ * Returns:     the new Edge, or nullptr if this item has no such edge
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       The Edge gets this item's pen, colour and radius.
+ */
+
+Edge *
+ImplicitEdges::materializePair(Node * source, Node * dest)
+{
+    int i, j;
+
+    if (!indicesOf(source, dest, &i, &j))
+	return nullptr;
+
+    removed.insert(key(i, j));
+    update();
+
+    Edge * edge = new Edge(source, dest);
+    edge->setPenWidth(penWidth);
+    edge->setColour(edgeColour);
+    edge->setSourceRadius(radius);
+    edge->setDestRadius(radius);
+    edge->setParentItem(parentItem());
+    return edge;
+}
+
+
+/*
+ * Name:        nodeMoved
+ * Purpose:     Tells this item that one of its nodes has moved.
+ * Arguments:   none
+ * Output:      none
+ * Modifies:    boundsValid
+ * Returns:     none
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       Called from Node::itemChange().
+ */
+
+void
+ImplicitEdges::nodeMoved()
+{
+    prepareGeometryChange();
+    boundsValid = false;
+    update();
+}
+
+
+/*
+ * Name:        attach
+ * Purpose:     Adds this item to its nodes' lists.
+ * Arguments:   none
+ * Output:      none
+ * Modifies:    the nodes' lists of implicit edges
+ * Returns:     none
+ * Assumptions: The item isn't in the lists already.
+ * Bugs:        none
+ * Notes:       Undoes detach().
+ */
+
+void
+ImplicitEdges::attach()
+{
+    foreach (Node * node, first)
+	if (node != nullptr)
+	    node->implicitEdges.append(this);
+    foreach (Node * node, second)
+	if (node != nullptr)
+	    node->implicitEdges.append(this);
+}
+
+
+/*
+ * Name:        detach
+ * Purpose:     Removes this item from its nodes' lists.
+ * Arguments:   none
+ * Output:      none
+ * Modifies:    the nodes' lists of implicit edges
+ * Returns:     none
+ * Assumptions: All of the (non-null) nodes still exist.
+ * Bugs:        none
+ * Notes:       Done when the item is replaced by Edges.  Not done by a
+ *              destructor, since when a whole graph is deleted its
+ *              nodes may be deleted first.
+ */
+
+void
+ImplicitEdges::detach()
+{
+    foreach (Node * node, first)
+	if (node != nullptr)
+	    node->implicitEdges.removeAll(this);
+    foreach (Node * node, second)
+	if (node != nullptr)
+	    node->implicitEdges.removeAll(this);
+}
@@ -0,0 +1,130 @@
+/*
+ * File:	implicitedges.h
+ * Date:	2026/10/18
+ * Version:	1.0
+ *
+ * Purpose:	Declares an item that stands for every edge of a complete
+ *		or complete bipartite set of nodes without an Edge for
+ *		each one.
+ */
+
+#ifndef IMPLICITEDGES_H
+#define IMPLICITEDGES_H
+
+#include <QGraphicsItem>
+#include <QColor>
+#include <QSet>
+#include <QVector>
+
+class Node;
+class Edge;
+
+class ImplicitEdges : public QGraphicsItem
+{
+public:
+    // AllPairs: every pair of nodes in the first set.
+    // Across: every pair with one node in each set.
+    enum Family {AllPairs, Across};
+
+    // Where a removed node was, so that it can be put back.
+    typedef struct
+    {
+	int first;		// Its index in each set, or -1.
+	int second;
+	QVector<quint64> pairs;	// The removed pairs it was in.
+    } Node_Slot;
+
+    ImplicitEdges(Family aFamily, const QVector<Node *> & firstSet,
+		  const QVector<Node *> & secondSet = QVector<Node *>());
+
+    enum {Type = UserType + 5};
+    int type() const {return Type;}
+
+    QRectF boundingRect() const;
+    bool contains(const QPointF & point) const;
+
+    void setPenWidth(qreal aPenWidth);
+    qreal getPenWidth() const;
+    void setColour(QColor colour);
+    QColor getColour() const;
+    void setRadius(qreal aRadius);
+    qreal getRadius() const;
+
+    qint64 pairCount() const;
+    qint64 bytesUsed() const;
+    bool pairAt(const QPointF & point, Node ** source, Node ** dest) const;
+    void removePair(Node * source, Node * dest);
+    void restorePair(Node * source, Node * dest);
+    Node_Slot removeNode(Node * node);
+    void restoreNode(Node * node, const Node_Slot & slot);
+    Edge * materializePair(Node * source, Node * dest);
+    void nodeMoved();
+    void attach();
+    void detach();
+
+    template <typename Visitor> void forEachPair(Visitor visit) const;
+
+protected:
+    void paint(QPainter * painter, const QStyleOptionGraphicsItem * option,
+	       QWidget * widget);
+
+private:
+    static quint64 key(int i, int j);
+    bool indicesOf(Node * source, Node * dest, int * i, int * j) const;
+
+    Family family;
+    QVector<Node *> first, second;	// nullptr once a node is deleted.
+    QSet<quint64> removed;		// Pairs (see key()) not drawn.
+    qreal penWidth;
+    qreal radius;			// Node radius (inches), for export.
+    QColor edgeColour;
+    mutable QRectF bounds;
+    mutable bool boundsValid;
+};
+
+
+/*
+ * Name:        forEachPair
+ * Purpose:     Calls a function for every edge this item stands for.
+ * Arguments:   a function (or lambda) taking two Node *
+ * Output:      none
+ * Modifies:    nothing
+ * Returns:     none
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       Used by paint() and by the exports, so that the pairs
+ *              never have to be stored.
+ */
+
+template <typename Visitor>
+void ImplicitEdges::forEachPair(Visitor visit) const
+{
+    bool check = !removed.isEmpty();
+
+    if (family == AllPairs)
+    {
+	for (int i = 0; i < first.count(); i++)
+	{
+	    if (first.at(i) == nullptr)
+		continue;
+	    for (int j = i + 1; j < first.count(); j++)
+		if (first.at(j) != nullptr
+		    && !(check && removed.contains(key(i, j))))
+		    visit(first.at(i), first.at(j));
+	}
+    }
+    else
+    {
+	for (int i = 0; i < first.count(); i++)
+	{
+	    if (first.at(i) == nullptr)
+		continue;
+	    for (int j = 0; j < second.count(); j++)
+		if (second.at(j) != nullptr
+		    && !(check && removed.contains(key(i, j))))
+		    visit(first.at(i), second.at(j));
+	}
+    }
+}
+
+#endif // IMPLICITEDGES_H
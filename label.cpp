@@ -4,6 +4,8 @@
 #include <QGraphicsSceneMouseEvent>
 #include <QDebug>
 #include <QInputMethodEvent>
+#include <QPainter>
+#include <QtMath>
 
 class QEvent;
 Label::Label(QGraphicsItem * parent)
@@ -24,8 +26,7 @@ Label::Label(QGraphicsItem * parent)
     setTextInteractionFlags(Qt::TextEditorInteraction);
 
     if (parentItem() != nullptr)
-        setPos(parentItem()->boundingRect().center().x() - boundingRect().width() / 2.,
-               parentItem()->boundingRect().center().y() - boundingRect().height() / 2.);
+        centerOn(parentItem()->boundingRect().center());
 }
 
 void Label::setTextInteraction(bool on, bool selectAll)
@@ -74,13 +75,82 @@ void Label::setLabel(QString string)
     }
     this->setHtml(htmlFormat);
     if (parentItem() != nullptr)
-        setPos(parentItem()->boundingRect().center().x() - boundingRect().width() / 2.,
-               parentItem()->boundingRect().center().y() - boundingRect().height() / 2.);
+        centerOn(parentItem()->boundingRect().center());
 }
 
+/*
+ * Name:        centerOn()
+ * Purpose:     Moves the label so that its text is centred on a point.
+ * Arguments:   QPointF, in the coordinates of the label's parent
+ * Output:      none
+ * Modifies:    the position of the label
+ * Returns:     none
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       Uses the size of the text, not boundingRect(), which is
+ *              larger (see below).
+ */
+void Label::centerOn(QPointF point)
+{
+    setPos(point - QGraphicsTextItem::boundingRect().center());
+}
+
+/*
+ * Name:        boundingRect()
+ * Purpose:     Returns the area the label may paint in.
+ * Arguments:   none
+ * Output:      none
+ * Modifies:    none
+ * Returns:     QRectF
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       paint() may turn the text by any angle about its centre,
+ *              so this is the square that holds the text at any angle.
+ */
+QRectF Label::boundingRect() const
+{
+    QRectF text = QGraphicsTextItem::boundingRect();
+    qreal side = qSqrt(text.width() * text.width()
+                       + text.height() * text.height());
+
+    return QRectF(text.center().x() - side / 2.,
+                  text.center().y() - side / 2.,
+                  side, side);
+}
+
+/*
+ * Name:        paint()
+ * Purpose:     Paints the label so that it is always upright on screen.
+ * Arguments:   QPainter *, QStyleOptionGraphicsItem *, QWidget *
+ * Output:      The label.
+ * Modifies:    nothing
+ * Returns:     nothing
+ * Assumptions: none
+ * Bugs:        While a rotated label is being edited the text cursor
+ *              is placed as if the label were not turned.
+ * Notes:       The rotation of the label on screen (from its node or
+ *              edge, their graphs, and the view) is undone here, at
+ *              paint time.  That way rotating a graph is a single
+ *              transform change and the labels never need to be told.
+ */
 void Label::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget)
 {
+    QTransform transform = painter->worldTransform();
+    qreal angle = qRadiansToDegrees(qAtan2(transform.m12(), transform.m11()));
+
+    if (qFuzzyIsNull(angle))
+    {
+        QGraphicsTextItem::paint(painter, option, widget);
+        return;
+    }
+
+    QPointF center = QGraphicsTextItem::boundingRect().center();
+    painter->save();
+    painter->translate(center);
+    painter->rotate(-angle);
+    painter->translate(-center);
     QGraphicsTextItem::paint(painter, option, widget);
+    painter->restore();
 }
 
 
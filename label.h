@@ -12,6 +12,9 @@ public:
     int type() const { return Type; }
 
     void setLabel(QString string);
+    void centerOn(QPointF point);
+
+    QRectF boundingRect() const;
 
 protected:
     void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget);
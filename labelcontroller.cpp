@@ -1,4 +1,5 @@
 #include "labelcontroller.h"
+#include "canvasedit.h"
 
 
 LabelController::LabelController(Edge *anEdge, QLineEdit *anEdit)
@@ -37,14 +38,14 @@ LabelController::LabelController(Node *aNode, QLineEdit *anEdit)
 void LabelController::setEdgeWeight(QString string)
 {
     if (edge != nullptr || edge != 0)
-        edge->setWeight(string);
+        CanvasEdit::setStyle(edge, CanvasEdit::EdgeWeight, string);
 }
 
 
 void LabelController::setNodeLabel(QString string)
 {
     if (edge != nullptr || edge != 0)
-        node->setNodeLabel(string);
+        CanvasEdit::setStyle(node, CanvasEdit::NodeLabel, string);
 }
 
 void LabelController::deletedLineEdit()
@@ -1,4 +1,5 @@
 #include "labelsizecontroller.h"
+#include "canvasedit.h"
 
 
 LabelSizeController::LabelSizeController(Edge *anEdge, QDoubleSpinBox *aBox)
@@ -45,7 +46,7 @@ LabelSizeController::LabelSizeController(Node * aNode, QDoubleSpinBox *aBox)
 void LabelSizeController::setNodeLabelSize(double value)
 {
     if (node != nullptr || node != 0)
-        node->setNodeLabelSize(value);
+        CanvasEdit::setStyle(node, CanvasEdit::NodeLabelSize, value);
 }
 
 void LabelSizeController::deletedSpinBox()
@@ -56,7 +57,7 @@ void LabelSizeController::deletedSpinBox()
 void LabelSizeController::setEdgeWeightSize(double value)
 {
     if (edge != nullptr || edge != 0)
-        edge->setWeightLabelSize(value);
+        CanvasEdit::setStyle(edge, CanvasEdit::EdgeWeightSize, value);
 }
 
 
@@ -0,0 +1,403 @@
+/*
+ * File:    layeredlayout.cpp
+ * Date:    2026/10/18
+ * Version: 1.0
+ *
+ * Purpose: A layered layout, in the style of Sugiyama: each node is
+ *          put in the layer given by its BFS distance from a root,
+ *          the nodes of each layer are reordered to reduce edge
+ *          crossings, and then they are given x coordinates that
+ *          keep them in order, a fixed distance apart, and as close
+ *          as possible to their neighbours.
+ *
+ * Notes:   BFS layers only have edges within a layer or between
+ *          adjacent layers, so no dummy nodes are needed.  Laying out
+ *          a tree this way never crosses an edge: BFS already lists
+ *          the children of each node together, and in the order of
+ *          their parents.
+ */
+
+#include "layeredlayout.h"
+#include "layoutgraph.h"
+
+#include <QVector>
+#include <QtMath>
+#include <algorithm>
+
+// The distance between layers, and the least distance between two
+// nodes in a layer, in node diameters.
+#define LAYERED_LAYER_SPACING	3
+#define LAYERED_NODE_SPACING	2
+
+// The number of down-and-up passes of the barycenter heuristic, and
+// of the coordinate assignment.
+#define LAYERED_ORDER_SWEEPS	4
+#define LAYERED_COORD_SWEEPS	4
+
+
+/*
+ * Name:        breadth_first
+ * Purpose:     Lists a component of the graph in BFS order.
+ * Arguments:   the graph, the node to start from, the distances
+ *              (-1 for nodes not yet reached), and where to put the
+ *              nodes
+ * Output:      none
+ * Modifies:    distances, order
+ * Returns:     the last node reached (one of the farthest)
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       order is cleared first; distances of the nodes found
+ *              are set, others are left alone.
+ */
+
+static int
+breadth_first(const LayoutGraph * graph, int root, QVector<int> & distances,
+	      QVector<int> & order)
+{
+    order.clear();
+    order.append(root);
+    distances[root] = 0;
+    for (int head = 0; head < order.count(); head++)
+    {
+	int u = order.at(head);
+	const int * next = graph->neighbours(u);
+	for (int e = 0; e < graph->degree(u); e++)
+	    if (distances.at(next[e]) < 0)
+	    {
+		distances[next[e]] = distances.at(u) + 1;
+		order.append(next[e]);
+	    }
+    }
+    return order.last();
+}
+
+
+/*
+ * Name:        find_root
+ * Purpose:     Chooses the root of a component.
+ * Arguments:   the graph, any node of the component, and scratch
+ *              space for distances (all -1 on the component)
+ * Output:      none
+ * Modifies:    nothing (distances are restored)
+ * Returns:     the root
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       The root is the middle of a longest shortest path
+ *              found by two BFS's (exactly the centre, for a tree),
+ *              which gives the fewest layers.
+ */
+
+static int
+find_root(const LayoutGraph * graph, int node, QVector<int> & distances)
+{
+    QVector<int> order;
+    QVector<int> parent;
+
+    int far = breadth_first(graph, node, distances, order);
+    foreach (int u, order)
+	distances[u] = -1;
+
+    // BFS again from the far end, remembering the way back.
+    breadth_first(graph, far, distances, order);
+    int end = order.last();
+    int length = distances.at(end);
+    int middle = end;
+    for (int step = 0; step < length / 2; step++)
+    {
+	const int * next = graph->neighbours(middle);
+	for (int e = 0; e < graph->degree(middle); e++)
+	    if (distances.at(next[e]) == distances.at(middle) - 1)
+	    {
+		middle = next[e];
+		break;
+	    }
+    }
+    foreach (int u, order)
+	distances[u] = -1;
+    return middle;
+}
+
+
+/*
+ * Name:        count_crossings
+ * Purpose:     Counts the edge crossings between two adjacent layers.
+ * Arguments:   the graph, the upper layer, the layer of each node,
+ *              the position of each node in its layer
+ * Output:      none
+ * Modifies:    nothing
+ * Returns:     the number of crossings
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       Barth, Juenger and Mutzel: listing the edges in order
+ *              of their upper ends, two edges cross exactly when their
+ *              lower ends are out of order, and the inversions are
+ *              counted with a Fenwick tree.  O(E log V).
+ */
+
+static qint64
+count_crossings(const LayoutGraph * graph, const QVector<int> & upper,
+		int lowerSize, const QVector<int> & layer,
+		const QVector<int> & position)
+{
+    QVector<int> tree(lowerSize + 1, 0);
+    QVector<int> ends;
+    qint64 crossings = 0;
+    int seen = 0;
+
+    foreach (int u, upper)
+    {
+	ends.clear();
+	const int * next = graph->neighbours(u);
+	for (int e = 0; e < graph->degree(u); e++)
+	    if (layer.at(next[e]) == layer.at(u) + 1)
+		ends.append(position.at(next[e]));
+	std::sort(ends.begin(), ends.end());
+
+	// Each edge crosses the earlier edges whose lower end is
+	// further right.
+	foreach (int p, ends)
+	{
+	    int atMost = 0;
+	    for (int i = p + 1; i > 0; i -= i & -i)
+		atMost += tree.at(i);
+	    crossings += seen - atMost;
+	}
+	foreach (int p, ends)
+	{
+	    for (int i = p + 1; i <= lowerSize; i += i & -i)
+		tree[i]++;
+	    seen++;
+	}
+    }
+    return crossings;
+}
+
+
+/*
+ * Name:        sort_layer
+ * Purpose:     Reorders a layer by the barycenters of its neighbours
+ *              in an adjacent layer.
+ * Arguments:   the graph, the layer, the adjacent layer's number,
+ *              the layer of each node, and the positions
+ * Output:      none
+ * Modifies:    nodes, position
+ * Returns:     none
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       A node with no neighbour in the other layer keeps its
+ *              position as its key.  The sort is stable, so ties keep
+ *              their order.
+ */
+
+static void
+sort_layer(const LayoutGraph * graph, QVector<int> & nodes, int other,
+	   const QVector<int> & layer, QVector<int> & position)
+{
+    QVector<QPair<double, int> > keys(nodes.count());
+
+    for (int k = 0; k < nodes.count(); k++)
+    {
+	int u = nodes.at(k);
+	const int * next = graph->neighbours(u);
+	double sum = 0;
+	int count = 0;
+	for (int e = 0; e < graph->degree(u); e++)
+	    if (layer.at(next[e]) == other)
+	    {
+		sum += position.at(next[e]);
+		count++;
+	    }
+	keys[k] = qMakePair(count > 0 ? sum / count : (double)k, u);
+    }
+    std::stable_sort(keys.begin(), keys.end(),
+		     [](const QPair<double, int> & a,
+			const QPair<double, int> & b)
+		     {
+			 return a.first < b.first;
+		     });
+    for (int k = 0; k < nodes.count(); k++)
+    {
+	nodes[k] = keys.at(k).second;
+	position[nodes.at(k)] = k;
+    }
+}
+
+
+/*
+ * Name:        place_layer
+ * Purpose:     Gives the nodes of a layer x coordinates.
+ * Arguments:   the graph, the layer, the adjacent layer's number, the
+ *              layer of each node, the spacing, and the coordinates
+ * Output:      none
+ * Modifies:    x
+ * Returns:     none
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       Each node would like to be at the average x of its
+ *              neighbours in the other layer (or where it is, if it
+ *              has none).  Keeping the nodes in order and at least
+ *              spacing apart, the placement nearest to that (in the
+ *              least-squares sense) is found in linear time by the
+ *              pool-adjacent-violators algorithm, applied to
+ *              want[k] - k * spacing, which must then be
+ *              nondecreasing.
+ */
+
+static void
+place_layer(const LayoutGraph * graph, const QVector<int> & nodes,
+	    int other, const QVector<int> & layer, qreal spacing,
+	    QVector<qreal> & x)
+{
+    const int size = nodes.count();
+    QVector<qreal> blockSum, blockMean;
+    QVector<int> blockCount;
+
+    for (int k = 0; k < size; k++)
+    {
+	int u = nodes.at(k);
+	const int * next = graph->neighbours(u);
+	qreal sum = 0;
+	int count = 0;
+	for (int e = 0; e < graph->degree(u); e++)
+	    if (layer.at(next[e]) == other)
+	    {
+		sum += x.at(next[e]);
+		count++;
+	    }
+	qreal want = (count > 0 ? sum / count : x.at(u)) - k * spacing;
+
+	// Merge blocks until their means are in order.
+	blockSum.append(want);
+	blockCount.append(1);
+	blockMean.append(want);
+	while (blockMean.count() > 1
+	       && blockMean.at(blockMean.count() - 2) > blockMean.last())
+	{
+	    int last = blockMean.count() - 1;
+	    blockSum[last - 1] += blockSum.at(last);
+	    blockCount[last - 1] += blockCount.at(last);
+	    blockMean[last - 1] = blockSum.at(last - 1)
+		/ blockCount.at(last - 1);
+	    blockSum.removeLast();
+	    blockCount.removeLast();
+	    blockMean.removeLast();
+	}
+    }
+
+    int k = 0;
+    for (int b = 0; b < blockMean.count(); b++)
+	for (int j = 0; j < blockCount.at(b); j++, k++)
+	    x[nodes.at(k)] = blockMean.at(b) + k * spacing;
+}
+
+
+/*
+ * Name:        layered_layout
+ * Purpose:     Lays out a graph in layers.
+ * Arguments:   the graph
+ * Output:      none
+ * Modifies:    graph->positions
+ * Returns:     none
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       The root is the selected node, if there is one;
+ *              otherwise each component is rooted at its centre.  The
+ *              components are placed side by side, and the whole
+ *              drawing is centred where the graph was.  Of the
+ *              orders tried by the barycenter sweeps, the one with
+ *              the fewest crossings is kept.
+ */
+
+void
+layered_layout(LayoutGraph * graph)
+{
+    const int n = graph->nodeCount();
+    if (n < 1)
+	return;
+
+    const qreal layerSpacing = LAYERED_LAYER_SPACING * graph->nodeSize;
+    const qreal nodeSpacing = LAYERED_NODE_SPACING * graph->nodeSize;
+    QVector<int> layer(n, -1);
+    QVector<int> position(n);
+    QVector<qreal> x(n);
+    QVector<int> order;
+    const QPointF centre = graph->centre();
+    qreal left = 0;
+
+    for (int start = -1; start < n; start++)
+    {
+	int node = start < 0 ? graph->selected : start;
+	if (node < 0 || layer.at(node) >= 0)
+	    continue;
+	if (graph->isCancelled())
+	    return;
+
+	int root = start < 0 ? node : find_root(graph, node, layer);
+	breadth_first(graph, root, layer, order);
+
+	// Split the component into layers, in BFS order.
+	QVector<QVector<int> > layers(layer.at(order.last()) + 1);
+	foreach (int u, order)
+	{
+	    position[u] = layers.at(layer.at(u)).count();
+	    layers[layer.at(u)].append(u);
+	}
+
+	// Barycenter sweeps, keeping the best order seen.
+	qint64 best = -1;
+	QVector<QVector<int> > bestLayers;
+	for (int sweep = 0; sweep <= LAYERED_ORDER_SWEEPS; sweep++)
+	{
+	    if (sweep > 0)
+	    {
+		for (int l = 1; l < layers.count(); l++)
+		    sort_layer(graph, layers[l], l - 1, layer, position);
+		for (int l = layers.count() - 2; l >= 0; l--)
+		    sort_layer(graph, layers[l], l + 1, layer, position);
+	    }
+
+	    qint64 crossings = 0;
+	    for (int l = 0; l + 1 < layers.count(); l++)
+		crossings += count_crossings(graph, layers.at(l),
+					     layers.at(l + 1).count(),
+					     layer, position);
+	    if (best < 0 || crossings < best)
+	    {
+		best = crossings;
+		bestLayers = layers;
+	    }
+	    if (crossings == 0)
+		break;
+	}
+	layers = bestLayers;
+
+	// Coordinates: start evenly spaced, then pull each layer
+	// towards the one above, and then the one below.
+	for (int l = 0; l < layers.count(); l++)
+	    for (int k = 0; k < layers.at(l).count(); k++)
+		x[layers.at(l).at(k)] = k * nodeSpacing;
+	for (int sweep = 0; sweep < LAYERED_COORD_SWEEPS; sweep++)
+	{
+	    for (int l = 1; l < layers.count(); l++)
+		place_layer(graph, layers.at(l), l - 1, layer,
+			    nodeSpacing, x);
+	    for (int l = layers.count() - 2; l >= 0; l--)
+		place_layer(graph, layers.at(l), l + 1, layer,
+			    nodeSpacing, x);
+	}
+
+	// Put the component to the right of the ones before it.
+	qreal minX = x.at(root), maxX = x.at(root);
+	foreach (int u, order)
+	{
+	    minX = qMin(minX, x.at(u));
+	    maxX = qMax(maxX, x.at(u));
+	}
+	foreach (int u, order)
+	    graph->positions[u] = QPointF(left + x.at(u) - minX,
+					  layer.at(u) * layerSpacing);
+	left += maxX - minX + nodeSpacing;
+    }
+
+    graph->moveCentreTo(centre);
+}
@@ -0,0 +1,17 @@
+/*
+ * File:	layeredlayout.h
+ * Date:	2026/10/18
+ * Version:	1.0
+ *
+ * Purpose:	Declares the layered (hierarchical) layout for trees and
+ *		other graphs.
+ */
+
+#ifndef LAYEREDLAYOUT_H
+#define LAYEREDLAYOUT_H
+
+class LayoutGraph;
+
+void layered_layout(LayoutGraph * graph);
+
+#endif // LAYEREDLAYOUT_H
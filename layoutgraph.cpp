@@ -0,0 +1,458 @@
+/*
+ * File:    layoutgraph.cpp
+ * Date:    2026/10/18
+ * Version: 1.0
+ *
+ * Purpose: A copy of the nodes and edges of a Graph on the canvas, in
+ *          a form the layout algorithms can work on quickly and on
+ *          another thread: an array of positions and the adjacency
+ *          lists in compressed sparse row form.
+ *
+ * Notes:   A layout runs on a worker thread and calls publish() now
+ *          and then; the GUI thread takes the published positions
+ *          with takePublished() and moves the Nodes with apply().
+ *          Nothing on the worker thread touches a QGraphicsItem.
+ */
+
+#include "layoutgraph.h"
+#include "graph.h"
+#include "node.h"
+#include "edge.h"
+#include "implicitedges.h"
+#include "canvasscene.h"
+#include "canvasedit.h"
+
+#include <QGuiApplication>
+#include <QHash>
+#include <QPair>
+#include <QMutexLocker>
+#include <QScreen>
+#include <QtMath>
+#include <algorithm>
+
+
+/*
+ * Name:        collect_items
+ * Purpose:     Finds the nodes and implicit edge sets under an item.
+ * Arguments:   the item, and the lists to add them to
+ * Output:      none
+ * Modifies:    nodes, implicits
+ * Returns:     none
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       Joined graphs can be nested, so this recurses through
+ *              child Graphs.
+ */
+
+static void
+collect_items(QGraphicsItem * item, QVector<Node *> & nodes,
+	      QVector<ImplicitEdges *> & implicits)
+{
+    foreach (QGraphicsItem * child, item->childItems())
+    {
+	if (child->type() == Node::Type)
+	    nodes.append(qgraphicsitem_cast<Node *>(child));
+	else if (child->type() == ImplicitEdges::Type)
+	    implicits.append(static_cast<ImplicitEdges *>(child));
+	else if (child->type() == Graph::Type)
+	    collect_items(child, nodes, implicits);
+    }
+}
+
+
+/*
+ * Name:        LayoutGraph
+ * Purpose:     Copies the nodes and edges of a graph.
+ * Arguments:   the graph, and true to leave out the edges of
+ *              ImplicitEdges and the building of the adjacency lists
+ * Output:      none
+ * Modifies:    none
+ * Returns:     none
+ * Assumptions: Called on the GUI thread.
+ * Bugs:        none
+ * Notes:       Only the node positions and the ends of each edge are
+ *              read here.  The adjacency lists are built by link(),
+ *              which a quick copy leaves to the caller, so that it can
+ *              run on a worker thread.  A quick copy also doesn't list
+ *              the pairs of an ImplicitEdges one by one (K_5000 has
+ *              12.5 million); it only counts them, in implicitPairs.
+ */
+
+LayoutGraph::LayoutGraph(Graph * root, bool quick)
+{
+    QVector<ImplicitEdges *> implicits;
+    qreal dpi = QGuiApplication::primaryScreen()->logicalDotsPerInchX();
+
+    collect_items(root, items, implicits);
+    fresh = false;
+    nodeSize = 1;
+    selected = -1;
+    implicitPairs = 0;
+
+    positions.resize(items.count());
+    diameters.resize(items.count());
+    nodes.resize(items.count());
+    starts.resize(items.count());
+    for (int i = 0; i < items.count(); i++)
+    {
+	Node * node = items.at(i);
+	positions[i] = node->scenePos();
+	nodes[i] = node;
+	starts[i] = node->pos();
+	diameters[i] = node->getDiameter() * dpi;
+	nodeSize = qMax(nodeSize, node->boundingRect().width());
+	if (selected < 0 && node->isSelected())
+	    selected = i;
+    }
+
+    for (int i = 0; i < items.count(); i++)
+	foreach (Edge * edge, items.at(i)->edgeList)
+	    if (edge->sourceNode() == items.at(i))
+		ends.append(qMakePair(items.at(i), edge->destNode()));
+    foreach (ImplicitEdges * implicit, implicits)
+    {
+	if (quick)
+	    implicitPairs += implicit->pairCount();
+	else
+	    implicit->forEachPair([&](Node * a, Node * b)
+	    {
+		ends.append(qMakePair(a, b));
+	    });
+    }
+
+    if (!quick)
+	link();
+}
+
+
+/*
+ * Name:        link
+ * Purpose:     Builds the adjacency lists of the copy.
+ * Arguments:   none
+ * Output:      none
+ * Modifies:    offsets, targets, items, ends
+ * Returns:     none
+ * Assumptions: Called once.
+ * Bugs:        none
+ * Notes:       Safe to call on a worker thread: the Nodes are only
+ *              used as keys, never looked at.  Edges to nodes outside
+ *              the graph, and loops, are left out.  An edge appears in
+ *              the adjacency of both of its nodes.
+ */
+
+void
+LayoutGraph::link()
+{
+    QHash<Node *, int> index;
+    QVector<QPair<int, int> > pairs;
+
+    index.reserve(items.count());
+    for (int i = 0; i < items.count(); i++)
+	index.insert(items.at(i), i);
+    pairs.reserve(ends.count());
+    for (int e = 0; e < ends.count(); e++)
+    {
+	int i = index.value(ends.at(e).first, -1);
+	int j = index.value(ends.at(e).second, -1);
+	if (i >= 0 && j >= 0 && i != j)
+	    pairs.append(qMakePair(i, j));
+    }
+    items.clear();
+    ends.clear();
+
+    // Count the neighbours of each node, then fill in the lists.
+    const int n = positions.count();
+    offsets.fill(0, n + 1);
+    for (int e = 0; e < pairs.count(); e++)
+    {
+	offsets[pairs.at(e).first + 1]++;
+	offsets[pairs.at(e).second + 1]++;
+    }
+    for (int i = 0; i < n; i++)
+	offsets[i + 1] += offsets.at(i);
+
+    QVector<int> fill = offsets;
+    targets.resize(2 * pairs.count());
+    for (int e = 0; e < pairs.count(); e++)
+    {
+	targets[fill[pairs.at(e).first]++] = pairs.at(e).second;
+	targets[fill[pairs.at(e).second]++] = pairs.at(e).first;
+    }
+}
+
+
+int
+LayoutGraph::nodeCount() const
+{
+    return positions.count();
+}
+
+
+int
+LayoutGraph::degree(int node) const
+{
+    return offsets.at(node + 1) - offsets.at(node);
+}
+
+
+const int *
+LayoutGraph::neighbours(int node) const
+{
+    return targets.constData() + offsets.at(node);
+}
+
+
+/*
+ * Name:        centre
+ * Purpose:     Finds the average of the node positions.
+ * Arguments:   none
+ * Output:      none
+ * Modifies:    nothing
+ * Returns:     the centre, or (0, 0) if there are no nodes
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       none
+ */
+
+QPointF
+LayoutGraph::centre() const
+{
+    QPointF sum;
+
+    if (positions.isEmpty())
+	return sum;
+    foreach (QPointF p, positions)
+	sum += p;
+    return sum / positions.count();
+}
+
+
+/*
+ * Name:        moveCentreTo
+ * Purpose:     Moves all the nodes so that their centre is at a point.
+ * Arguments:   the point
+ * Output:      none
+ * Modifies:    positions
+ * Returns:     none
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       Layouts that ignore the starting positions use this to
+ *              put their result where the graph was, before every
+ *              publish() as well as at the end, so the drawing
+ *              doesn't jump about while it is being watched.
+ */
+
+void
+LayoutGraph::moveCentreTo(const QPointF & point)
+{
+    const QPointF shift = point - centre();
+    QPointF * p = positions.data();
+
+    for (int i = 0; i < positions.count(); i++)
+	p[i] += shift;
+}
+
+
+/*
+ * Name:        scaleEdgesTo
+ * Purpose:     Scales the drawing so that the average edge has a
+ *              given length.
+ * Arguments:   the length
+ * Output:      none
+ * Modifies:    positions
+ * Returns:     none
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       The scaling is about the origin, so layouts that work
+ *              in their own units call this before moveCentreTo().
+ *              If there are no edges, or they all have length 0, one
+ *              unit is taken to be an edge.
+ */
+
+void
+LayoutGraph::scaleEdgesTo(qreal length)
+{
+    QPointF * p = positions.data();
+    qreal total = 0;
+    int edges = 0;
+
+    for (int i = 0; i < nodeCount(); i++)
+	for (int e = offsets.at(i); e < offsets.at(i + 1); e++)
+	{
+	    QPointF delta = p[i] - p[targets.at(e)];
+	    total += qSqrt(delta.x() * delta.x() + delta.y() * delta.y());
+	    edges++;
+	}
+
+    qreal scale = total > 0 ? length * edges / total : length;
+    for (int i = 0; i < nodeCount(); i++)
+	p[i] *= scale;
+}
+
+
+/*
+ * Name:        chunks
+ * Purpose:     Splits the nodes into ranges for the worker threads.
+ * Arguments:   the number of nodes, and the most in one range
+ * Output:      none
+ * Modifies:    nothing
+ * Returns:     the ranges, in order
+ * Assumptions: chunkSize > 0
+ * Bugs:        none
+ * Notes:       Range r starts at node r * chunkSize, so a layout can
+ *              keep one partial result per range.
+ */
+
+QVector<Node_Range>
+LayoutGraph::chunks(int numOfNodes, int chunkSize)
+{
+    QVector<Node_Range> ranges;
+
+    for (int first = 0; first < numOfNodes; first += chunkSize)
+	ranges.append(qMakePair(first, qMin(first + chunkSize, numOfNodes)));
+    return ranges;
+}
+
+
+/*
+ * Name:        publish
+ * Purpose:     Makes the current positions available to the GUI thread.
+ * Arguments:   none
+ * Output:      none
+ * Modifies:    published, fresh
+ * Returns:     none
+ * Assumptions: Called by the layout, on its thread.
+ * Bugs:        none
+ * Notes:       The positions are copied rather than shared, since
+ *              layouts write through positions.data().
+ */
+
+void
+LayoutGraph::publish()
+{
+    QMutexLocker locker(&mutex);
+    published.resize(positions.count());
+    std::copy(positions.constBegin(), positions.constEnd(),
+	      published.begin());
+    fresh = true;
+}
+
+
+/*
+ * Name:        takePublished
+ * Purpose:     Gets the positions published since the last call.
+ * Arguments:   where to put them
+ * Output:      none
+ * Modifies:    *out, fresh
+ * Returns:     false if nothing new has been published
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       none
+ */
+
+bool
+LayoutGraph::takePublished(QVector<QPointF> * out)
+{
+    QMutexLocker locker(&mutex);
+    if (!fresh)
+	return false;
+    *out = published;
+    fresh = false;
+    return true;
+}
+
+
+void
+LayoutGraph::cancel()
+{
+    cancelled.storeRelease(1);
+}
+
+
+/*
+ * Name:        isCancelled
+ * Purpose:     Tells a layout whether it should stop.
+ * Arguments:   none
+ * Output:      none
+ * Modifies:    nothing
+ * Returns:     bool
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       Layouts check this once per iteration, and stop
+ *              (leaving positions as they are) if it is true.
+ */
+
+bool
+LayoutGraph::isCancelled() const
+{
+    return cancelled.loadAcquire() != 0;
+}
+
+
+/*
+ * Name:        apply
+ * Purpose:     Moves the Nodes to new positions.
+ * Arguments:   a position (in scene coordinates) for each node
+ * Output:      none
+ * Modifies:    the Nodes
+ * Returns:     the number of nodes that still exist
+ * Assumptions: Called on the GUI thread.
+ * Bugs:        none
+ * Notes:       Nodes that have been deleted (or taken off the canvas
+ *              by an undo) since the copy was made are skipped.  This
+ *              runs for every frame of the animation, so the nodes are
+ *              moved as one batch (see Node::moveQuietly()), and each
+ *              edge is adjusted once rather than once per end.
+ */
+
+int
+LayoutGraph::apply(const QVector<QPointF> & newPositions)
+{
+    Node_Moves moves;
+    int alive = 0;
+
+    for (int i = 0; i < nodes.count() && i < newPositions.count(); i++)
+    {
+	Node * node = nodes.at(i);
+	if (node == nullptr || node->scene() == nullptr)
+	    continue;
+	QGraphicsItem * parent = node->parentItem();
+	node->moveQuietly(parent != nullptr
+			  ? parent->mapFromScene(newPositions.at(i))
+			  : newPositions.at(i), moves);
+	alive++;
+    }
+    Node::finishMoves(moves);
+    return alive;
+}
+
+
+/*
+ * Name:        recordMoves
+ * Purpose:     Adds the moves the layout made to the undo history.
+ * Arguments:   none
+ * Output:      none
+ * Modifies:    the canvas's undo history
+ * Returns:     none
+ * Assumptions: Called on the GUI thread, once the layout has stopped.
+ * Bugs:        none
+ * Notes:       The whole layout is undone in one step, back to where
+ *              the nodes were when the copy was made.
+ */
+
+void
+LayoutGraph::recordMoves()
+{
+    CanvasScene * scene = nullptr;
+    for (int i = 0; i < nodes.count() && scene == nullptr; i++)
+	if (nodes.at(i) != nullptr)
+	    scene = qobject_cast<CanvasScene *>(nodes.at(i)->scene());
+    if (scene == nullptr)
+	return;
+
+    CanvasEdit * edit = new CanvasEdit(scene);
+    for (int i = 0; i < nodes.count(); i++)
+	if (nodes.at(i) != nullptr && nodes.at(i)->scene() == scene)
+	    edit->moved(nodes.at(i), starts.at(i));
+    scene->record(edit);
+}
@@ -0,0 +1,66 @@
+/*
+ * File:	layoutgraph.h
+ * Date:	2026/10/18
+ * Version:	1.0
+ *
+ * Purpose:	Declares the copy of a Graph's nodes and edges that the
+ *		automatic layouts work on.
+ */
+
+#ifndef LAYOUTGRAPH_H
+#define LAYOUTGRAPH_H
+
+#include <QAtomicInt>
+#include <QMutex>
+#include <QPair>
+#include <QPointer>
+#include <QPointF>
+#include <QVector>
+
+class Graph;
+class Node;
+
+// The nodes [first, second) of a graph, as handed to one worker thread.
+typedef QPair<int, int> Node_Range;
+
+class LayoutGraph
+{
+public:
+    LayoutGraph(Graph * root, bool quick = false);
+    void link();
+
+    int nodeCount() const;
+    int degree(int node) const;
+    const int * neighbours(int node) const;
+    QPointF centre() const;
+    void moveCentreTo(const QPointF & point);
+    void scaleEdgesTo(qreal length);
+    static QVector<Node_Range> chunks(int numOfNodes, int chunkSize);
+
+    void publish();
+    bool takePublished(QVector<QPointF> * out);
+    void cancel();
+    bool isCancelled() const;
+    int apply(const QVector<QPointF> & newPositions);
+    void recordMoves();
+
+    QVector<QPointF> positions;	// Scene coordinates, one per node.
+    QVector<int> offsets;	// The neighbours of node i are
+    QVector<int> targets;	// targets[offsets[i] .. offsets[i + 1]).
+    QVector<qreal> diameters;	// Node diameters, in pixels.
+    qreal nodeSize;		// Largest node diameter, in pixels.
+    int selected;		// A selected node, or -1 if none is.
+    qint64 implicitPairs;	// Edges a quick copy left out.
+
+private:
+    QVector<QPointer<Node> > nodes;
+    QVector<QPointF> starts;	// Node positions before the layout.
+    QVector<Node *> items;	// The nodes and the ends of the edges,
+    QVector<QPair<Node *, Node *> > ends;	// until link().
+    QMutex mutex;		// Guards published and fresh.
+    QVector<QPointF> published;
+    bool fresh;			// True if published hasn't been taken.
+    QAtomicInt cancelled;
+};
+
+#endif // LAYOUTGRAPH_H
@@ -0,0 +1,173 @@
+/*
+ * File:    layoutrunner.cpp
+ * Date:    2026/10/18
+ * Version: 1.0
+ *
+ * Purpose: Runs one automatic layout at a time.  The graph is copied
+ *          into a LayoutGraph, the layout runs on a worker thread,
+ *          and every LAYOUT_FRAME_INTERVAL ms the latest positions it
+ *          has published are applied to the Nodes, so the graph
+ *          untangles on the canvas as the layout goes.
+ */
+
+#include "layoutrunner.h"
+#include "layoutgraph.h"
+
+#include <QtConcurrent/QtConcurrentRun>
+
+// Time (in ms) between two updates of the canvas during a layout.
+#define LAYOUT_FRAME_INTERVAL	100
+
+
+/*
+ * Name:        LayoutRunner
+ * Purpose:     Constructor for LayoutRunner.
+ * Arguments:   the parent QObject
+ * Output:      none
+ * Modifies:    none
+ * Returns:     none
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       none
+ */
+
+LayoutRunner::LayoutRunner(QObject * parent)
+    : QObject(parent)
+{
+    layoutGraph = nullptr;
+    frameTimer.setInterval(LAYOUT_FRAME_INTERVAL);
+    connect(&frameTimer, SIGNAL(timeout()), this, SLOT(showProgress()));
+    connect(&watcher, SIGNAL(finished()), this, SLOT(layoutFinished()));
+}
+
+
+/*
+ * Name:        ~LayoutRunner
+ * Purpose:     Stops the running layout, if any.
+ * Arguments:   none
+ * Output:      none
+ * Modifies:    none
+ * Returns:     none
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       Waits for the worker thread, which notices the
+ *              cancellation within one iteration.
+ */
+
+LayoutRunner::~LayoutRunner()
+{
+    if (layoutGraph != nullptr)
+    {
+	layoutGraph->cancel();
+	watcher.waitForFinished();
+	delete layoutGraph;
+    }
+}
+
+
+/*
+ * Name:        start
+ * Purpose:     Starts laying out a graph.
+ * Arguments:   the graph and the layout algorithm
+ * Output:      none
+ * Modifies:    layoutGraph
+ * Returns:     false if a layout is already running
+ * Assumptions: graph is in the canvas.
+ * Bugs:        Nodes and edges added to the graph while the layout
+ *              runs are not laid out.
+ * Notes:       none
+ */
+
+bool
+LayoutRunner::start(Graph * graph, Layout_Function layout)
+{
+    if (layoutGraph != nullptr)
+	return false;
+
+    layoutGraph = new LayoutGraph(graph);
+    LayoutGraph * g = layoutGraph;
+    watcher.setFuture(QtConcurrent::run([=]()
+    {
+	layout(g);
+	g->publish();
+    }));
+    frameTimer.start();
+    return true;
+}
+
+
+bool
+LayoutRunner::isRunning() const
+{
+    return layoutGraph != nullptr;
+}
+
+
+/*
+ * Name:        cancel
+ * Purpose:     Stops the running layout.
+ * Arguments:   none
+ * Output:      none
+ * Modifies:    none
+ * Returns:     none
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       The nodes keep the positions reached so far;
+ *              finished() is emitted once the worker has stopped.
+ */
+
+void
+LayoutRunner::cancel()
+{
+    if (layoutGraph != nullptr)
+	layoutGraph->cancel();
+}
+
+
+/*
+ * Name:        showProgress
+ * Purpose:     Moves the nodes to the latest published positions.
+ * Arguments:   none
+ * Output:      none
+ * Modifies:    the Nodes
+ * Returns:     none
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       If every node has been deleted, the layout is
+ *              cancelled.
+ */
+
+void
+LayoutRunner::showProgress()
+{
+    QVector<QPointF> positions;
+
+    if (layoutGraph == nullptr || !layoutGraph->takePublished(&positions))
+	return;
+    if (layoutGraph->apply(positions) == 0)
+	layoutGraph->cancel();
+}
+
+
+/*
+ * Name:        layoutFinished
+ * Purpose:     Applies the final positions and cleans up.
+ * Arguments:   none
+ * Output:      none
+ * Modifies:    the Nodes, layoutGraph
+ * Returns:     none
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       The layout is undone in one step.
+ */
+
+void
+LayoutRunner::layoutFinished()
+{
+    frameTimer.stop();
+    showProgress();
+    layoutGraph->recordMoves();
+    delete layoutGraph;
+    layoutGraph = nullptr;
+    emit finished();
+}
@@ -0,0 +1,49 @@
+/*
+ * File:	layoutrunner.h
+ * Date:	2026/10/18
+ * Version:	1.0
+ *
+ * Purpose:	Declares the object that runs an automatic layout on a
+ *		worker thread and shows its progress on the canvas.
+ */
+
+#ifndef LAYOUTRUNNER_H
+#define LAYOUTRUNNER_H
+
+#include <QFutureWatcher>
+#include <QObject>
+#include <QTimer>
+
+class Graph;
+class LayoutGraph;
+
+// A layout algorithm: moves graph->positions, calling graph->publish()
+// now and then, and returns early if graph->isCancelled().
+typedef void (*Layout_Function)(LayoutGraph * graph);
+
+class LayoutRunner : public QObject
+{
+    Q_OBJECT
+public:
+    explicit LayoutRunner(QObject * parent = 0);
+    ~LayoutRunner();
+    bool start(Graph * graph, Layout_Function layout);
+    bool isRunning() const;
+
+public slots:
+    void cancel();
+
+signals:
+    void finished();
+
+private slots:
+    void showProgress();
+    void layoutFinished();
+
+private:
+    LayoutGraph * layoutGraph;	// nullptr when no layout is running.
+    QFutureWatcher<void> watcher;
+    QTimer frameTimer;
+};
+
+#endif // LAYOUTRUNNER_H
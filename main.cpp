@@ -8,13 +8,38 @@
  */
 
 #include "mainwindow.h"
+#include "benchmark.h"
+#include "sweep.h"
 #include <QApplication>
+#include <QCoreApplication>
 #include <QFileSystemModel>
 #include <QTreeView>
 
+// Number of nodes used by --benchmark if no number is given.
+#define BENCHMARK_DEFAULT_NODES	1000000
+
 
 int main(int argc, char *argv[])
 {
+    // "Graphic --benchmark [numOfNodes]" runs the generator
+    // benchmarks (see benchmark.cpp) without opening a window.
+    if (argc > 1 && QString(argv[1]) == "--benchmark")
+    {
+	QCoreApplication a(argc, argv);
+	bool ok = false;
+	int numOfNodes = argc > 2 ? QString(argv[2]).toInt(&ok) : 0;
+
+	return run_benchmark(ok ? numOfNodes : BENCHMARK_DEFAULT_NODES);
+    }
+
+    // "Graphic --sweep TYPE COUNTS ..." generates a family of graphs
+    // and exports each one (see sweep.cpp), also without a window.
+    if (argc > 1 && QString(argv[1]) == "--sweep")
+    {
+	QCoreApplication a(argc, argv);
+	return run_sweep(a.arguments().mid(2));
+    }
+
     QApplication a(argc, argv);
 
     MainWindow w;
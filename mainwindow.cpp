@@ -35,18 +35,27 @@
 #include "mainwindow.h"
 #include "ui_mainwindow.h"
 #include "edge.h"
+#include "graph.h"
+#include "implicitedges.h"
 #include "basicgraphs.h"
 #include "colourlinecontroller.h"
 #include "sizecontroller.h"
 #include "labelcontroller.h"
 #include "labelsizecontroller.h"
 #include "colourfillcontroller.h"
+#include "forcelayout.h"
+#include "multilevellayout.h"
+#include "stresslayout.h"
+#include "spectrallayout.h"
+#include "layeredlayout.h"
+#include "overlapremoval.h"
 
 #include <QDesktopWidget>
 #include <QColorDialog>
 #include <QGraphicsItem>
 #include <QMessageBox>
 #include <QFileDialog>
+#include <QInputDialog>
 #include <QShortcut>
 #include <qmath.h>
 #include <QtSvg/QSvgGenerator>
@@ -72,6 +81,11 @@
 #define VP_PREC_TIKZ  4
 #define ET_PREC_TIKZ  4
 
+// The most nodes the node count spin box allows; random graphs and
+// trees, which are meant for stress testing, may be much bigger.
+#define BASIC_GRAPH_MAX_NODES	100
+#define LARGE_GRAPH_MAX_NODES	100000
+
 
 
 /*
@@ -102,34 +116,79 @@ MainWindow::MainWindow(QWidget *parent) :
     connect(ui->actionSave, SIGNAL(triggered()), this, SLOT(save_Graph()));
     connect(ui->actionOpen_File, SIGNAL(triggered()),
 	    this, SLOT(load_Graphic_File()));
+    connect(ui->actionTiled_rendering, SIGNAL(toggled(bool)),
+	    ui->canvas, SLOT(setTiledRendering(bool)));
+    connect(ui->actionElastic_dragging, SIGNAL(toggled(bool)),
+	    ui->canvas, SLOT(setElasticDrag(bool)));
+    connect(ui->actionSnap_to_grid, SIGNAL(triggered()),
+	    ui->canvas, SLOT(snapNodesToGrid()));
+    connect(ui->actionUndo, SIGNAL(triggered()), ui->canvas, SLOT(undo()));
+    connect(ui->actionRedo, SIGNAL(triggered()), ui->canvas, SLOT(redo()));
+    connect(ui->canvas->undoStack(), SIGNAL(canUndoChanged(bool)),
+	    ui->actionUndo, SLOT(setEnabled(bool)));
+    connect(ui->canvas->undoStack(), SIGNAL(canRedoChanged(bool)),
+	    ui->actionRedo, SLOT(setEnabled(bool)));
+    ui->actionUndo->setEnabled(false);
+    ui->actionRedo->setEnabled(false);
+    connect(ui->actionSelectAll, SIGNAL(triggered()),
+	    ui->canvas, SLOT(selectAll()));
+    connect(ui->actionDelete_selection, SIGNAL(triggered()),
+	    ui->canvas, SLOT(deleteSelection()));
+    connect(ui->actionRecolour_selection, SIGNAL(triggered()),
+	    this, SLOT(recolour_Selection()));
+    connect(ui->actionResize_selection, SIGNAL(triggered()),
+	    this, SLOT(resize_Selection()));
+    ui->metricsPanel->setScene(ui->canvas->scene());
     new QShortcut(QKeySequence(Qt::CTRL + Qt::Key_Q), this, SLOT(close()));
 
+    layoutRunner = new LayoutRunner(this);
+    connect(ui->actionForce_directed_layout, SIGNAL(triggered()),
+	    this, SLOT(force_Layout()));
+    connect(ui->actionMultilevel_layout, SIGNAL(triggered()),
+	    this, SLOT(multilevel_Layout()));
+    connect(ui->actionStress_layout, SIGNAL(triggered()),
+	    this, SLOT(stress_Layout()));
+    connect(ui->actionSpectral_layout, SIGNAL(triggered()),
+	    this, SLOT(spectral_Layout()));
+    connect(ui->actionLayered_layout, SIGNAL(triggered()),
+	    this, SLOT(layered_Layout()));
+    connect(ui->actionRemove_overlaps, SIGNAL(triggered()),
+	    this, SLOT(remove_Overlaps()));
+    connect(ui->actionCancel_layout, SIGNAL(triggered()),
+	    layoutRunner, SLOT(cancel()));
+    connect(layoutRunner, SIGNAL(finished()),
+	    this, SLOT(layout_Finished()));
+    ui->actionCancel_layout->setEnabled(false);
+
     // Ctrl-Q quits.
     new QShortcut(QKeySequence(Qt::CTRL + Qt::Key_O),
 		  this, SLOT(load_Graphic_File()));
     // Save dialog pops up via Ctrl-S.
     new QShortcut(QKeySequence(Qt::CTRL + Qt::Key_S), this, SLOT(save_Graph()));
 
+    // These change how the previewed graph looks (or, for the node
+    // size, how far apart its nodes are), not which nodes and edges it
+    // has, so they don't regenerate it.
     QObject::connect(ui->nodeSize, SIGNAL(valueChanged(double)),
-		     this, SLOT(generate_Graph()));
+		     this, SLOT(resize_Graph()));
     QObject::connect(ui->edgeSize, SIGNAL(valueChanged(double)),
-		     this, SLOT(generate_Graph()));
+		     this, SLOT(style_Graph()));
     QObject::connect(ui->NodeLabel1, SIGNAL(textChanged(QString)),
-		     this, SLOT(generate_Graph()));
+		     this, SLOT(style_Graph()));
     QObject::connect(ui->NodeLabel2, SIGNAL(textChanged(QString)),
-		     this, SLOT(generate_Graph()));
+		     this, SLOT(style_Graph()));
     QObject::connect(ui->EdgeLabel, SIGNAL(textChanged(QString)),
-		     this, SLOT(generate_Graph()));
+		     this, SLOT(style_Graph()));
     QObject::connect(ui->NodeLabelSize, SIGNAL(valueChanged(double)),
-		     this, SLOT(generate_Graph()));
+		     this, SLOT(style_Graph()));
     QObject::connect(ui->NumLabelCheckBox, SIGNAL(clicked(bool)),
-		     this, SLOT(generate_Graph()));
+		     this, SLOT(style_Graph()));
     QObject::connect(ui->NodeFillColor, SIGNAL(clicked(bool)),
-		     this, SLOT(generate_Graph()));
+		     this, SLOT(style_Graph()));
     QObject::connect(ui->NodeOutlineColor, SIGNAL(clicked(bool)),
-		     this, SLOT(generate_Graph()));
+		     this, SLOT(style_Graph()));
     QObject::connect(ui->EdgeLineColor, SIGNAL(clicked(bool)),
-		     this, SLOT(generate_Graph()));
+		     this, SLOT(style_Graph()));
 
     QObject::connect(ui->nodeSize, SIGNAL(valueChanged(double)),
 		     this, SLOT(generate_Freestyle_Nodes()));
@@ -153,13 +212,13 @@ MainWindow::MainWindow(QWidget *parent) :
 		     this, SLOT(generate_Freestyle_Edges()));
 
     QObject::connect(ui->graphRotation, SIGNAL(valueChanged(double)),
-		     this, SLOT(generate_Graph()));
+		     this, SLOT(style_Graph()));
     QObject::connect(ui->complete_checkBox, SIGNAL(clicked(bool)),
 		     this, SLOT(generate_Graph()));
     QObject::connect(ui->graphHeight, SIGNAL(valueChanged(double)),
-		     this, SLOT(generate_Graph()));
+		     this, SLOT(resize_Graph()));
     QObject::connect(ui->graphWidth, SIGNAL(valueChanged(double)),
-		     this, SLOT(generate_Graph()));
+		     this, SLOT(resize_Graph()));
     QObject::connect(ui->numOfNodes1, SIGNAL(valueChanged(int)),
 		     this, SLOT(generate_Graph()));
     QObject::connect(ui->numOfNodes2, SIGNAL(valueChanged(int)),
@@ -168,7 +227,7 @@ MainWindow::MainWindow(QWidget *parent) :
 		     this, SLOT(generate_Graph()));
 
     QObject::connect(ui->EdgeLabelSize, SIGNAL(valueChanged(double)),
-		     this, SLOT(generate_Graph()));
+		     this, SLOT(style_Graph()));
 
     QObject::connect(ui->snapToGrid_checkBox, SIGNAL(clicked(bool)),
 		    ui->canvas, SLOT(snapToGrid(bool)));
@@ -176,6 +235,9 @@ MainWindow::MainWindow(QWidget *parent) :
     QObject::connect(ui->canvas, SIGNAL(setKeyStatusLabelText(QString)),
 		     ui->keyPressStatus_label, SLOT(setText(QString)));
 
+    QObject::connect(ui->preview, SIGNAL(graphGenerated()),
+		     this, SLOT(style_Graph()));
+
     QObject::connect(ui->canvas, SIGNAL(resetNoMode()),
 		     ui->noMode_radioButton, SLOT(click()));
 
@@ -385,6 +447,7 @@ bool MainWindow::save_Graph()
     // Common code for text files:
     int numOfNodes = 0;
     QVector<Node *> nodes;
+    QList<ImplicitEdges *> implicitEdges;
     QString edges = "";
 
     QFile outputFile(fileName);
@@ -408,6 +471,8 @@ bool MainWindow::save_Graph()
 	    numOfNodes++;
 	    nodes.append(node);
 	}
+	else if (item->type() == ImplicitEdges::Type)
+	    implicitEdges.append(static_cast<ImplicitEdges *>(item));
     }
 
     if (selectedFilter == GRAPHICS_SAVE_FILE)
@@ -463,7 +528,22 @@ bool MainWindow::save_Graph()
 	    }
 	}
 
+	// Implicit edges are written out one by one, like any other.
 	outStream << nodeStyles + edges ;
+	foreach (ImplicitEdges * implicit, implicitEdges)
+	{
+	    QString style = "," + QString::number(implicit->getRadius())
+		+ "," + QString::number(implicit->getRadius())
+		+ ",0," + QString::number(implicit->getPenWidth())
+		+ "," + QString::number(implicit->getColour().redF())
+		+ "," + QString::number(implicit->getColour().greenF())
+		+ "," + QString::number(implicit->getColour().blueF()) + "\n";
+	    implicit->forEachPair([&](Node * a, Node * b)
+	    {
+		outStream << qMin(a->getID(), b->getID()) << ","
+			  << qMax(a->getID(), b->getID()) << style;
+	    });
+	}
 	outputFile.close();
 	ui->canvas->snapToGrid(saveStatus);
 	ui->canvas->update();
@@ -498,6 +578,12 @@ bool MainWindow::save_Graph()
 	}
 	outStream << nodes.count() << "\n";
 	outStream << edges;
+	foreach (ImplicitEdges * implicit, implicitEdges)
+	    implicit->forEachPair([&](Node * a, Node * b)
+	    {
+		outStream << qMin(a->getID(), b->getID()) << ","
+			  << qMax(a->getID(), b->getID()) << "\n";
+	    });
 	outputFile.close();
 	ui->canvas->snapToGrid(saveStatus);
 	ui->canvas->update();
@@ -619,7 +705,32 @@ bool MainWindow::save_Graph()
 	    }
 	}
 
-	outStream << begin << nodeStyles << edgeStyles << "\\end{tikzpicture}";
+	outStream << begin << nodeStyles << edgeStyles;
+
+	// Implicit edges: one colour for each set.
+	for (int k = 0; k < implicitEdges.count(); k++)
+	{
+	    ImplicitEdges * implicit = implicitEdges.at(k);
+	    QString edgeColour = "implicit" + QString::number(k)
+		+ "edgeColour";
+	    QString style = ") edge[draw=" + edgeColour + ", line width="
+		+ QString::number(implicit->getPenWidth()
+				  / screen->logicalDotsPerInchX(),
+				  'f', ET_PREC_TIKZ)
+		+ "in] (v";
+
+	    outStream << "\\definecolor{" + edgeColour + "}{RGB}{"
+		+ QString::number(implicit->getColour().red())
+		+ "," + QString::number(implicit->getColour().green())
+		+ "," + QString::number(implicit->getColour().blue())
+		+ "}\n";
+	    implicit->forEachPair([&](Node * a, Node * b)
+	    {
+		outStream << "\\path (v" << a->getID() << style
+			  << b->getID() << ");\n";
+	    });
+	}
+	outStream << "\\end{tikzpicture}";
 	outputFile.close();
 	ui->canvas->snapToGrid(saveStatus);
 	ui->canvas->update();
@@ -789,7 +900,7 @@ void MainWindow::select_Custom_Graph(QString graphName)
 	file.close();
 	qDebug() << graph->childItems().length();
 	graph->setRotation(-1 * ui->graphRotation->value());
-	ui->preview->scene()->clear();
+	ui->preview->Clear_Scene();
 	ui->preview->scene()->addItem(graph);
     }
 }
@@ -848,20 +959,12 @@ void MainWindow::style_Graph()
 
 void MainWindow::generate_Graph()
 {
-    QScreen *screen = QGuiApplication::primaryScreen();
-    ui->preview->scene()->clear();
+    ui->preview->Clear_Scene();
     if (ui->graphType_ComboBox->currentIndex() < BasicGraphs::Count)
 	ui->preview->Create_Graph(ui->graphType_ComboBox->currentIndex(),
 				  ui->numOfNodes1->value(),
 				  ui->numOfNodes2->value(),
-				  ui->graphHeight->value()
-				  * screen->logicalDotsPerInchY()
-				  - ui->nodeSize->value()
-				  * screen->logicalDotsPerInchX(),
-				  ui->graphWidth->value()
-				  * screen->logicalDotsPerInchX()
-				  - ui->nodeSize->value()
-				  * screen->logicalDotsPerInchX(),
+				  graph_Height(), graph_Width(),
 				  ui->complete_checkBox->isChecked());
     else
 	select_Custom_Graph(fileDirectory + "/"
@@ -872,6 +975,74 @@ void MainWindow::generate_Graph()
 }
 
 
+/*
+ * Name:        resize_Graph
+ * Purpose:     Applies a new height, width or node size to the graph
+ *              in the preview.
+ * Arguments:   none
+ * Outputs:     none
+ * Modifies:    the preview graph
+ * Returns:     nothing
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       The nodes of a basic graph are moved rather than the
+ *              graph being regenerated, unless the preview can't do
+ *              that (see PreView::Resize_Graph()).  Custom graphs
+ *              don't depend on the height and width.
+ */
+
+void MainWindow::resize_Graph()
+{
+    if (ui->graphType_ComboBox->currentIndex() < BasicGraphs::Count)
+    {
+	foreach (QGraphicsItem * item, ui->preview->scene()->items())
+	{
+	    if (item->type() == Graph::Type && item->parentItem() == nullptr)
+	    {
+		Graph * graphItem = qgraphicsitem_cast<Graph *>(item);
+		if (!ui->preview->Resize_Graph(graphItem,
+					       graph_Height(), graph_Width()))
+		{
+		    generate_Graph();
+		    return;
+		}
+	    }
+	}
+    }
+    this->style_Graph();
+}
+
+
+/*
+ * Name:        graph_Height, graph_Width
+ * Purpose:     Return the height and width (in pixels) that a basic
+ *              graph is generated with.
+ * Arguments:   none
+ * Outputs:     none
+ * Modifies:    nothing
+ * Returns:     qreal
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       The node size is taken off so that the nodes, and not
+ *              just their centres, fit in the chosen height and width.
+ */
+
+qreal MainWindow::graph_Height()
+{
+    QScreen * screen = QGuiApplication::primaryScreen();
+    return ui->graphHeight->value() * screen->logicalDotsPerInchY()
+	- ui->nodeSize->value() * screen->logicalDotsPerInchX();
+}
+
+
+qreal MainWindow::graph_Width()
+{
+    QScreen * screen = QGuiApplication::primaryScreen();
+    return ui->graphWidth->value() * screen->logicalDotsPerInchX()
+	- ui->nodeSize->value() * screen->logicalDotsPerInchX();
+}
+
+
 /*
  * Name:
  * Purpose:
@@ -1084,6 +1255,7 @@ void MainWindow::on_graphType_ComboBox_currentIndexChanged(int index)
     // Here are the default settings.  Over-ride as needed below.
     ui->numOfNodes1->setSingleStep(1);
     ui->numOfNodes1->setMinimum(1);
+    ui->numOfNodes1->setMaximum(BASIC_GRAPH_MAX_NODES);
     ui->numOfNodes1->show();
 
     ui->numOfNodes2->setSingleStep(1);
@@ -1108,8 +1280,20 @@ void MainWindow::on_graphType_ComboBox_currentIndexChanged(int index)
       case BasicGraphs::Complete:
       case BasicGraphs::Star:
       case BasicGraphs::Wheel:
+      {
+	  break;
+      }
       case BasicGraphs::BBTree:
       {
+	  ui->numOfNodes1->setMaximum(LARGE_GRAPH_MAX_NODES);
+	  break;
+      }
+      case BasicGraphs::KTree:
+      {
+	  ui->partitionLabel->setText("Nodes & Children");
+	  ui->numOfNodes1->setMaximum(LARGE_GRAPH_MAX_NODES);
+	  ui->numOfNodes2->setMinimum(2);
+	  ui->numOfNodes2->show();
 	  break;
       }
       case BasicGraphs::Antiprism:
@@ -1164,6 +1348,22 @@ void MainWindow::on_graphType_ComboBox_currentIndexChanged(int index)
 	  ui->widthLabel->hide();
 	  break;
       }
+      case BasicGraphs::RandomBA:
+      {
+	  ui->partitionLabel->setText("Nodes & Links");
+	  ui->numOfNodes1->setMaximum(LARGE_GRAPH_MAX_NODES);
+	  ui->numOfNodes2->show();
+	  break;
+      }
+      case BasicGraphs::RandomER:
+      case BasicGraphs::RandomGeometric:
+      case BasicGraphs::RandomRegular:
+      {
+	  ui->partitionLabel->setText("Nodes & Degree");
+	  ui->numOfNodes1->setMaximum(LARGE_GRAPH_MAX_NODES);
+	  ui->numOfNodes2->show();
+	  break;
+      }
       default:
 	// ToDo: may need to change grphc file format to add
 	qDebug() << "Unknown " << endl;
@@ -1415,3 +1615,194 @@ void MainWindow::on_tabWidget_currentChanged(int index)
 	break;
     }
 }
+
+
+/*
+ * Name:	selected_Graph
+ * Purpose:	Finds the graph an automatic layout should work on.
+ * Arguments:	none
+ * Output:	A message box if there is no such graph.
+ * Modifies:	nothing
+ * Returns:	the top-level graph of the first selected item, or the
+ *		only graph on the canvas; nullptr if there is neither.
+ * Assumptions: none
+ * Bugs:	none
+ * Notes:	none
+ */
+
+Graph * MainWindow::selected_Graph()
+{
+    QGraphicsItem * chosen = nullptr;
+
+    foreach (QGraphicsItem * item, ui->canvas->scene()->selectedItems())
+    {
+	chosen = item;
+	break;
+    }
+
+    if (chosen == nullptr)
+    {
+	foreach (QGraphicsItem * item, ui->canvas->scene()->items())
+	{
+	    if (item->type() != Graph::Type || item->parentItem() != nullptr)
+		continue;
+	    if (chosen != nullptr)
+	    {
+		QMessageBox::information(this, "Layout",
+					 "Select the graph to lay out.");
+		return nullptr;
+	    }
+	    chosen = item;
+	}
+    }
+
+    while (chosen != nullptr && chosen->parentItem() != nullptr)
+	chosen = chosen->parentItem();
+    if (chosen == nullptr || chosen->type() != Graph::Type)
+    {
+	QMessageBox::information(this, "Layout",
+				 "There is no graph on the canvas to lay out.");
+	return nullptr;
+    }
+    return qgraphicsitem_cast<Graph *>(chosen);
+}
+
+
+/*
+ * Name:	start_Layout
+ * Purpose:	Starts an automatic layout of the selected graph.
+ * Arguments:	the layout algorithm
+ * Output:	none
+ * Modifies:	the graph's nodes, as the layout runs
+ * Returns:	none
+ * Assumptions: none
+ * Bugs:	none
+ * Notes:	The layout runs in the background; Layout->Cancel
+ *		stops it.  Only one layout runs at a time.
+ */
+
+void MainWindow::start_Layout(Layout_Function layout)
+{
+    if (layoutRunner->isRunning())
+	return;
+
+    Graph * graph = selected_Graph();
+    if (graph != nullptr && layoutRunner->start(graph, layout))
+	ui->actionCancel_layout->setEnabled(true);
+}
+
+
+void MainWindow::force_Layout()
+{
+    start_Layout(force_layout);
+}
+
+
+void MainWindow::multilevel_Layout()
+{
+    start_Layout(multilevel_layout);
+}
+
+
+void MainWindow::stress_Layout()
+{
+    start_Layout(stress_layout);
+}
+
+
+void MainWindow::spectral_Layout()
+{
+    start_Layout(spectral_layout);
+}
+
+
+void MainWindow::layered_Layout()
+{
+    start_Layout(layered_layout);
+}
+
+
+void MainWindow::remove_Overlaps()
+{
+    start_Layout(remove_overlaps);
+}
+
+
+void MainWindow::layout_Finished()
+{
+    ui->actionCancel_layout->setEnabled(false);
+}
+
+
+/*
+ * Name:	has_Selection
+ * Purpose:	Checks that some nodes or edges are selected.
+ * Arguments:	none
+ * Output:	A message box if none are.
+ * Modifies:	nothing
+ * Returns:	true if something is selected
+ * Assumptions: none
+ * Bugs:	none
+ * Notes:	none
+ */
+
+bool MainWindow::has_Selection()
+{
+    if (!ui->canvas->scene()->selectedItems().isEmpty())
+	return true;
+    QMessageBox::information(this, "Selection",
+			     "Select some nodes or edges first.");
+    return false;
+}
+
+
+/*
+ * Name:	recolour_Selection
+ * Purpose:	Asks for a colour and gives it to the selected nodes and
+ *		edges.
+ * Arguments:	none
+ * Output:	A colour dialog.
+ * Modifies:	the selected items
+ * Returns:	nothing
+ * Assumptions: none
+ * Bugs:	none
+ * Notes:	See CanvasScene::recolourSelection().
+ */
+
+void MainWindow::recolour_Selection()
+{
+    if (!has_Selection())
+	return;
+
+    QColor colour = QColorDialog::getColor(Qt::white, this,
+					   "Recolour selection");
+    if (colour.isValid())
+	ui->canvas->recolourSelection(colour);
+}
+
+
+/*
+ * Name:	resize_Selection
+ * Purpose:	Asks for a scale and scales the selected nodes and edges.
+ * Arguments:	none
+ * Output:	An input dialog.
+ * Modifies:	the selected items
+ * Returns:	nothing
+ * Assumptions: none
+ * Bugs:	none
+ * Notes:	See CanvasScene::resizeSelection().
+ */
+
+void MainWindow::resize_Selection()
+{
+    bool ok;
+
+    if (!has_Selection())
+	return;
+
+    double percent = QInputDialog::getDouble(this, "Resize selection",
+					     "Scale (%):", 100, 1, 1000, 0,
+					     &ok);
+    if (ok)
+	ui->canvas->resizeSelection(percent / 100.);
+}
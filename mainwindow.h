@@ -16,6 +16,9 @@
 #include <QtGui>
 #include <QGridLayout>
 #include <QScrollArea>
+#include "layoutrunner.h"
+
+class Graph;
 
 namespace Ui {
     class MainWindow;
@@ -37,6 +40,7 @@ private slots:
     void select_Custom_Graph(QString graphName);
     void generate_Graph();
     void style_Graph();
+    void resize_Graph();
     void generate_Combobox_Titles();
 
     void set_Label_Font_Sizes();
@@ -63,12 +67,30 @@ private slots:
 
     void on_tabWidget_currentChanged(int index);
 
+    void force_Layout();
+    void multilevel_Layout();
+    void stress_Layout();
+    void spectral_Layout();
+    void layered_Layout();
+    void remove_Overlaps();
+    void layout_Finished();
+
+    void recolour_Selection();
+    void resize_Selection();
+
 private:
+    qreal graph_Height();
+    qreal graph_Width();
+    Graph * selected_Graph();
+    bool has_Selection();
+    void start_Layout(Layout_Function layout);
+
     Ui::MainWindow * ui;
     QDir dir;
     QString fileDirectory;
     QGridLayout * gridLayout;
     QScrollArea * scroll;
+    LayoutRunner * layoutRunner;
 };
 
 #endif // MAINWINDOW_H
@@ -0,0 +1,290 @@
+/*
+ * File:    metricspanel.cpp
+ * Date:    2026/10/18
+ * Version: 1.0
+ *
+ * Purpose: Shows the edge crossings, node overlaps, smallest angle and
+ *          edge lengths of the selected graph (or of the only graph
+ *          on the canvas), and keeps them up to date.
+ *
+ * Notes:   Whenever the scene changes, the panel waits until it has
+ *          been still for METRICS_DELAY ms, then makes a quick copy of
+ *          the graph (see LayoutGraph::LayoutGraph()) and measures it
+ *          on a worker thread, where the copy's adjacency lists are
+ *          built too.  If the scene changes again while that runs,
+ *          the measuring is cancelled and started over, so a layout or
+ *          a drag never waits for it.  Nothing is measured while the
+ *          panel can't be seen.
+ */
+
+#include "metricspanel.h"
+#include "layoutgraph.h"
+#include "graph.h"
+
+#include <QGraphicsScene>
+#include <QShowEvent>
+#include <QtConcurrent/QtConcurrentRun>
+
+// How long (in ms) the scene must be unchanged before it is measured.
+#define METRICS_DELAY	500
+
+
+/*
+ * Name:        shown_graph
+ * Purpose:     Finds the graph whose metrics are shown.
+ * Arguments:   the scene
+ * Output:      none
+ * Modifies:    nothing
+ * Returns:     the top-level graph of the first selected item, or the
+ *              only graph in the scene; nullptr if there is neither.
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       Like MainWindow::selected_Graph(), but quiet.
+ */
+
+static Graph *
+shown_graph(QGraphicsScene * scene)
+{
+    QGraphicsItem * chosen = nullptr;
+
+    foreach (QGraphicsItem * item, scene->selectedItems())
+    {
+	chosen = item;
+	break;
+    }
+
+    if (chosen == nullptr)
+    {
+	foreach (QGraphicsItem * item, scene->items())
+	{
+	    if (item->type() != Graph::Type || item->parentItem() != nullptr)
+		continue;
+	    if (chosen != nullptr)
+		return nullptr;
+	    chosen = item;
+	}
+    }
+
+    while (chosen != nullptr && chosen->parentItem() != nullptr)
+	chosen = chosen->parentItem();
+    if (chosen == nullptr || chosen->type() != Graph::Type)
+	return nullptr;
+    return qgraphicsitem_cast<Graph *>(chosen);
+}
+
+
+/*
+ * Name:        MetricsPanel
+ * Purpose:     Constructor for MetricsPanel.
+ * Arguments:   the parent widget
+ * Output:      none
+ * Modifies:    none
+ * Returns:     none
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       Nothing is measured until setScene() is called.
+ */
+
+MetricsPanel::MetricsPanel(QWidget * parent)
+    : QLabel(parent)
+{
+    measuring = nullptr;
+    pending = false;
+    setWordWrap(true);
+    setTextInteractionFlags(Qt::TextSelectableByMouse);
+    delay.setSingleShot(true);
+    delay.setInterval(METRICS_DELAY);
+    connect(&delay, SIGNAL(timeout()), this, SLOT(measure()));
+    connect(&watcher, SIGNAL(finished()), this, SLOT(measured()));
+}
+
+
+/*
+ * Name:        ~MetricsPanel
+ * Purpose:     Stops the measuring, if any.
+ * Arguments:   none
+ * Output:      none
+ * Modifies:    none
+ * Returns:     none
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       none
+ */
+
+MetricsPanel::~MetricsPanel()
+{
+    if (measuring != nullptr)
+    {
+	measuring->cancel();
+	watcher.waitForFinished();
+	delete measuring;
+    }
+}
+
+
+/*
+ * Name:        setScene
+ * Purpose:     Chooses the scene whose graphs are measured.
+ * Arguments:   the scene
+ * Output:      none
+ * Modifies:    scene
+ * Returns:     none
+ * Assumptions: Called once.
+ * Bugs:        none
+ * Notes:       Any change to the scene, or to what is selected in it,
+ *              schedules a new measurement.
+ */
+
+void
+MetricsPanel::setScene(QGraphicsScene * newScene)
+{
+    scene = newScene;
+    connect(scene, SIGNAL(changed(QList<QRectF>)), this, SLOT(schedule()));
+    connect(scene, SIGNAL(selectionChanged()), this, SLOT(schedule()));
+    schedule();
+}
+
+
+/*
+ * Name:        schedule
+ * Purpose:     Measures the graph once the scene has been still for a
+ *              while.
+ * Arguments:   none
+ * Output:      none
+ * Modifies:    delay
+ * Returns:     none
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       Each call restarts the wait.  While the panel is
+ *              hidden nothing is scheduled; showEvent() catches up.
+ */
+
+void
+MetricsPanel::schedule()
+{
+    if (isVisible())
+	delay.start();
+}
+
+
+/*
+ * Name:        showEvent
+ * Purpose:     Measures the graph when the panel is shown.
+ * Arguments:   the event
+ * Output:      none
+ * Modifies:    delay
+ * Returns:     none
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       The scene may have changed while the panel was hidden.
+ */
+
+void
+MetricsPanel::showEvent(QShowEvent * event)
+{
+    QLabel::showEvent(event);
+    schedule();
+}
+
+
+/*
+ * Name:        measure
+ * Purpose:     Starts measuring the graph on a worker thread.
+ * Arguments:   none
+ * Output:      The panel's text, if there is no graph to measure.
+ * Modifies:    measuring, pending
+ * Returns:     none
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       If a measurement is still running it is cancelled, and
+ *              this is called again when it stops.
+ */
+
+void
+MetricsPanel::measure()
+{
+    if (scene == nullptr || !isVisible())
+	return;
+    if (measuring != nullptr)
+    {
+	pending = true;
+	measuring->cancel();
+	return;
+    }
+
+    Graph * graph = shown_graph(scene);
+    if (graph == nullptr)
+    {
+	setText("Select a graph to see its metrics.");
+	return;
+    }
+
+    measuring = new LayoutGraph(graph, true);
+    LayoutGraph * g = measuring;
+    watcher.setFuture(QtConcurrent::run([=]()
+    {
+	g->link();
+	return measure_graph(g);
+    }));
+}
+
+
+/*
+ * Name:        measured
+ * Purpose:     Shows the metrics just found.
+ * Arguments:   none
+ * Output:      The panel's text.
+ * Modifies:    measuring, pending
+ * Returns:     none
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       Lengths are shown in inches, like node sizes.  A
+ *              cancelled measurement shows nothing.  Figures that
+ *              weren't found (see measure_graph()) are shown as n/a.
+ */
+
+void
+MetricsPanel::measured()
+{
+    Graph_Metrics metrics = watcher.result();
+    qreal dpi = logicalDpiX();
+
+    delete measuring;
+    measuring = nullptr;
+
+    if (metrics.complete)
+    {
+	QString crossings = QString::number(metrics.crossings);
+	if (!metrics.crossingsKnown)
+	    crossings = "n/a";
+	else if (metrics.crossingsCapped)
+	    crossings = "at least " + crossings;
+	QString angle = metrics.minAngle < 0
+	    ? QString("none")
+	    : QString::number(metrics.minAngle, 'f', 1) + QChar(0x00B0);
+	QString lengths = QString("%1 to %2, mean %3, s.d. %4")
+	    .arg(metrics.minLength / dpi, 0, 'f', 2)
+	    .arg(metrics.maxLength / dpi, 0, 'f', 2)
+	    .arg(metrics.meanLength / dpi, 0, 'f', 2)
+	    .arg(metrics.lengthDeviation / dpi, 0, 'f', 2);
+	if (!metrics.edgesKnown)
+	    angle = lengths = "n/a";
+
+	setText(QString("Nodes: %1    Edges: %2\n"
+			"Crossings: %3    Overlapping nodes: %4\n"
+			"Smallest angle: %5\n"
+			"Edge lengths (in): %6")
+		.arg(metrics.numOfNodes)
+		.arg(metrics.numOfEdges)
+		.arg(crossings)
+		.arg(metrics.overlaps)
+		.arg(angle)
+		.arg(lengths));
+    }
+
+    if (pending)
+    {
+	pending = false;
+	measure();
+    }
+}
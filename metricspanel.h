@@ -0,0 +1,50 @@
+/*
+ * File:	metricspanel.h
+ * Date:	2026/10/18
+ * Version:	1.0
+ *
+ * Purpose:	Declares the panel that shows the quality metrics of the
+ *		selected graph.
+ */
+
+#ifndef METRICSPANEL_H
+#define METRICSPANEL_H
+
+#include "graphmetrics.h"
+
+#include <QFutureWatcher>
+#include <QLabel>
+#include <QPointer>
+#include <QTimer>
+
+class QGraphicsScene;
+class QShowEvent;
+class LayoutGraph;
+
+class MetricsPanel : public QLabel
+{
+    Q_OBJECT
+public:
+    explicit MetricsPanel(QWidget * parent = 0);
+    ~MetricsPanel();
+    void setScene(QGraphicsScene * scene);
+
+public slots:
+    void schedule();
+
+protected:
+    void showEvent(QShowEvent * event);
+
+private slots:
+    void measure();
+    void measured();
+
+private:
+    QPointer<QGraphicsScene> scene;
+    LayoutGraph * measuring;	// nullptr when nothing is being measured.
+    bool pending;		// True if the graph changed since then.
+    QFutureWatcher<Graph_Metrics> watcher;
+    QTimer delay;
+};
+
+#endif // METRICSPANEL_H
@@ -0,0 +1,344 @@
+/*
+ * File:    multilevellayout.cpp
+ * Date:    2026/10/18
+ * Version: 1.0
+ *
+ * Purpose: A multilevel force-directed layout (after Walshaw).  The
+ *          graph is coarsened again and again by merging each node
+ *          with a neighbour, until it is small; the coarsest graph is
+ *          laid out from scratch, and then each finer graph starts
+ *          with its nodes where their coarse nodes ended up and is
+ *          only refined.  The coarse levels fix the overall shape, so
+ *          the refinement never has to untangle the graph.
+ *
+ * Notes:   All the levels together take about as much memory as the
+ *          input graph, since each has at most 3/4 of the nodes of
+ *          the one before it (or coarsening stops).
+ */
+
+#include "multilevellayout.h"
+#include "forcelayout.h"
+#include "layoutgraph.h"
+#include "fastrandom.h"
+
+#include <QtMath>
+#include <algorithm>
+
+// Stop coarsening when a level has at most this many nodes...
+#define MULTILEVEL_COARSEST_NODES	50
+
+// ...or when it has more than this fraction of the nodes of the level
+// it came from.
+#define MULTILEVEL_MIN_REDUCTION	0.75
+
+// Ideal edge lengths grow by this factor from one level to the next
+// coarser one (Walshaw's sqrt(7/4)).
+#define MULTILEVEL_EDGE_GROWTH		1.3228756555
+
+// Iterations used on the coarsest level, and on the finest one.  A
+// level in between, with 1/f of the nodes of the finest, gets sqrt(f)
+// times MULTILEVEL_REFINE_ITERATIONS; the small levels are cheap and
+// fix the overall shape, so they get the most work.
+#define MULTILEVEL_COARSEST_ITERATIONS	300
+#define MULTILEVEL_REFINE_ITERATIONS	40
+
+// The largest move in the first refining iteration, in edge lengths.
+#define MULTILEVEL_REFINE_TEMPERATURE	2
+
+// The ideal edge length of the finest level, in node diameters.
+#define MULTILEVEL_EDGE_LENGTH		4
+
+#define MULTILEVEL_SEED			20261018
+
+/*
+ * Name:        coarsen
+ * Purpose:     Makes the next coarser level of the hierarchy.
+ * Arguments:   the level to coarsen, the level to make, and the
+ *              random number generator
+ * Output:      none
+ * Modifies:    fine.parent, coarse
+ * Returns:     none
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       The nodes are visited in random order, and each one
+ *              not yet matched is matched with its lightest unmatched
+ *              neighbour, so the coarse masses stay even.  A node
+ *              left with no unmatched neighbour (the leaves of a
+ *              star, say) joins the lightest of its neighbours'
+ *              coarse nodes instead, so that coarsening doesn't stall.
+ *              A coarse node's neighbours are the coarse nodes of its
+ *              fine nodes' neighbours, without repeats.
+ */
+
+static void
+coarsen(Multilevel_Level & fine, Multilevel_Level & coarse,
+	FastRandom & random)
+{
+    const int n = fine.numOfNodes;
+    QVector<int> order(n);
+    int numOfCoarse = 0;
+
+    for (int i = 0; i < n; i++)
+	order[i] = i;
+    for (int i = n - 1; i > 0; i--)
+	qSwap(order[i], order[random.below(i + 1)]);
+
+    fine.parent.fill(-1, n);
+    coarse.masses.clear();
+    for (int o = 0; o < n; o++)
+    {
+	int u = order.at(o);
+	if (fine.parent.at(u) >= 0)
+	    continue;
+
+	int best = -1;
+	for (int e = fine.offsets.at(u); e < fine.offsets.at(u + 1); e++)
+	{
+	    int v = fine.targets.at(e);
+	    if (v != u && fine.parent.at(v) < 0
+		&& (best < 0 || fine.masses.at(v) < fine.masses.at(best)))
+		best = v;
+	}
+	if (best < 0)
+	    continue;
+	fine.parent[u] = fine.parent[best] = numOfCoarse++;
+	coarse.masses.append(fine.masses.at(u) + fine.masses.at(best));
+    }
+
+    for (int u = 0; u < n; u++)
+    {
+	if (fine.parent.at(u) >= 0)
+	    continue;
+	int best = -1;
+	for (int e = fine.offsets.at(u); e < fine.offsets.at(u + 1); e++)
+	{
+	    int p = fine.parent.at(fine.targets.at(e));
+	    if (p >= 0 && (best < 0 || coarse.masses.at(p)
+			   < coarse.masses.at(best)))
+		best = p;
+	}
+	if (best < 0)
+	{
+	    best = numOfCoarse++;
+	    coarse.masses.append(0);
+	}
+	fine.parent[u] = best;
+	coarse.masses[best] += fine.masses.at(u);
+    }
+    coarse.numOfNodes = numOfCoarse;
+
+    // List the fine nodes of each coarse node, in CSR form.
+    QVector<int> memberOffsets(numOfCoarse + 1, 0);
+    QVector<int> members(n);
+    for (int u = 0; u < n; u++)
+	memberOffsets[fine.parent.at(u) + 1]++;
+    for (int c = 0; c < numOfCoarse; c++)
+	memberOffsets[c + 1] += memberOffsets.at(c);
+    QVector<int> fill = memberOffsets;
+    for (int u = 0; u < n; u++)
+	members[fill[fine.parent.at(u)]++] = u;
+
+    // seen[d] == c once d has been listed as a neighbour of c.
+    QVector<int> seen(numOfCoarse, -1);
+    coarse.offsets.resize(numOfCoarse + 1);
+    coarse.targets.clear();
+    coarse.offsets[0] = 0;
+    for (int c = 0; c < numOfCoarse; c++)
+    {
+	seen[c] = c;
+	for (int m = memberOffsets.at(c); m < memberOffsets.at(c + 1); m++)
+	{
+	    int u = members.at(m);
+	    for (int e = fine.offsets.at(u); e < fine.offsets.at(u + 1); e++)
+	    {
+		int d = fine.parent.at(fine.targets.at(e));
+		if (seen.at(d) != c)
+		{
+		    seen[d] = c;
+		    coarse.targets.append(d);
+		}
+	    }
+	}
+	coarse.offsets[c + 1] = coarse.targets.count();
+    }
+    coarse.targets.squeeze();
+}
+
+
+/*
+ * Name:        build_levels
+ * Purpose:     Builds the hierarchy of coarser and coarser graphs.
+ * Arguments:   the graph, the size at which to stop, the random
+ *              number generator, and where to put the levels
+ * Output:      none
+ * Modifies:    levels
+ * Returns:     false if the layout was cancelled
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       levels[0] is the graph itself, with every mass 1.
+ *              Coarsening stops early if it no longer shrinks the
+ *              graph by much.  The spectral layout uses the same
+ *              hierarchy.
+ */
+
+bool
+build_levels(LayoutGraph * graph, int coarsestNodes, FastRandom & random,
+	     QVector<Multilevel_Level> & levels)
+{
+    const int n = graph->nodeCount();
+
+    levels.resize(1);
+    levels[0].numOfNodes = n;
+    levels[0].offsets = graph->offsets;
+    levels[0].targets = graph->targets;
+    levels[0].masses.fill(1, n);
+
+    while (levels.last().numOfNodes > coarsestNodes)
+    {
+	if (graph->isCancelled())
+	    return false;
+	Multilevel_Level coarse;
+	coarsen(levels.last(), coarse, random);
+	if (coarse.numOfNodes
+	    > MULTILEVEL_MIN_REDUCTION * levels.last().numOfNodes)
+	    break;
+	levels.append(coarse);
+    }
+    return true;
+}
+
+
+/*
+ * Name:        show_level
+ * Purpose:     Publishes the positions of a level as those of the
+ *              original nodes.
+ * Arguments:   the graph, the hierarchy, the level, and where the
+ *              graph was
+ * Output:      none
+ * Modifies:    graph->positions
+ * Returns:     none
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       Each node is shown where its coarse node on the given
+ *              level is, so the layout can be watched as it goes.
+ *              The drawing is centred where the graph was.
+ */
+
+static void
+show_level(LayoutGraph * graph, const QVector<Multilevel_Level> & levels,
+	   int level, const QPointF & centre)
+{
+    QPointF * positions = graph->positions.data();
+
+    for (int i = 0; i < levels.at(0).numOfNodes; i++)
+    {
+	int node = i;
+	for (int l = 0; l < level; l++)
+	    node = levels.at(l).parent.at(node);
+	positions[i] = levels.at(level).positions.at(node);
+    }
+    graph->moveCentreTo(centre);
+    graph->publish();
+}
+
+
+/*
+ * Name:        multilevel_layout
+ * Purpose:     Lays out a graph by coarsening and refining it.
+ * Arguments:   the graph
+ * Output:      none
+ * Modifies:    graph->positions
+ * Returns:     none
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       The starting positions are ignored, except that the
+ *              result (and everything published on the way, or left
+ *              by a cancel) is centred where the graph was.  Each fine
+ *              node starts a random tenth of an edge length from its
+ *              coarse node, so that nodes merged together separate.
+ */
+
+void
+multilevel_layout(LayoutGraph * graph)
+{
+    const int n = graph->nodeCount();
+    if (n < 2)
+	return;
+
+    FastRandom random(MULTILEVEL_SEED);
+    QVector<Multilevel_Level> levels;
+    const QPointF centre = graph->centre();
+
+    if (!build_levels(graph, MULTILEVEL_COARSEST_NODES, random, levels))
+	return;
+
+    // Lay out the coarsest level from random positions around where
+    // the graph was.
+    int top = levels.count() - 1;
+    qreal k = MULTILEVEL_EDGE_LENGTH * graph->nodeSize
+	* qPow(MULTILEVEL_EDGE_GROWTH, top);
+    Force_Params params;
+    Multilevel_Level & coarsest = levels[top];
+    qreal side = k * qSqrt(coarsest.numOfNodes);
+
+    coarsest.positions.resize(coarsest.numOfNodes);
+    for (int i = 0; i < coarsest.numOfNodes; i++)
+	coarsest.positions[i] = centre
+	    + QPointF(random.uniform() - 0.5, random.uniform() - 0.5) * side;
+    params.edgeLength = k;
+    params.iterations = MULTILEVEL_COARSEST_ITERATIONS;
+    params.temperature = side / 10;
+    force_directed(coarsest.positions.data(), coarsest.numOfNodes,
+		   coarsest.offsets.constData(),
+		   coarsest.targets.constData(),
+		   coarsest.masses.constData(), params, graph);
+
+    // Prolong each level onto the next finer one, and refine it.
+    for (int l = top - 1; l >= 0 && !graph->isCancelled(); l--)
+    {
+	show_level(graph, levels, l + 1, centre);
+	levels[l + 1].masses.clear();
+	levels[l + 1].offsets.clear();
+	levels[l + 1].targets.clear();
+
+	Multilevel_Level & fine = levels[l];
+	const QVector<QPointF> & from = levels.at(l + 1).positions;
+	QPointF * to;
+
+	k /= MULTILEVEL_EDGE_GROWTH;
+	if (l == 0)
+	{
+	    // The finest level works on the graph's own positions, so
+	    // force_directed() publishes them as it goes.
+	    to = graph->positions.data();
+	}
+	else
+	{
+	    fine.positions.resize(fine.numOfNodes);
+	    to = fine.positions.data();
+	}
+	for (int i = 0; i < fine.numOfNodes; i++)
+	    to[i] = from.at(fine.parent.at(i))
+		+ QPointF(random.uniform() - 0.5,
+			  random.uniform() - 0.5) * (k / 10);
+	levels[l + 1].positions.clear();
+	if (l == 0)
+	    graph->moveCentreTo(centre);
+
+	params.edgeLength = k;
+	params.iterations = qMin(MULTILEVEL_COARSEST_ITERATIONS,
+				 (int)(MULTILEVEL_REFINE_ITERATIONS
+				       * qSqrt((qreal)n / fine.numOfNodes)));
+	params.temperature = MULTILEVEL_REFINE_TEMPERATURE * k;
+	force_directed(to, fine.numOfNodes, fine.offsets.constData(),
+		       fine.targets.constData(), fine.masses.constData(),
+		       params, graph);
+    }
+    if (top == 0)
+	std::copy(coarsest.positions.constBegin(),
+		  coarsest.positions.constEnd(), graph->positions.begin());
+
+    // Put the result where the graph was; this is also reached if the
+    // layout is cancelled.
+    graph->moveCentreTo(centre);
+}
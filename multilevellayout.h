@@ -0,0 +1,35 @@
+/*
+ * File:	multilevellayout.h
+ * Date:	2026/10/18
+ * Version:	1.0
+ *
+ * Purpose:	Declares the multilevel force-directed layout, for graphs
+ *		too big to untangle from their starting positions.
+ */
+
+#ifndef MULTILEVELLAYOUT_H
+#define MULTILEVELLAYOUT_H
+
+#include <QPointF>
+#include <QVector>
+
+class FastRandom;
+class LayoutGraph;
+
+// One level of the hierarchy.  parent[i] is the node of the next
+// coarser level that node i of this level was merged into.
+typedef struct mLevel
+{
+    int numOfNodes;
+    QVector<int> offsets;
+    QVector<int> targets;
+    QVector<qreal> masses;
+    QVector<int> parent;
+    QVector<QPointF> positions;
+} Multilevel_Level;
+
+bool build_levels(LayoutGraph * graph, int coarsestNodes,
+		  FastRandom & random, QVector<Multilevel_Level> & levels);
+void multilevel_layout(LayoutGraph * graph);
+
+#endif // MULTILEVELLAYOUT_H
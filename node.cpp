@@ -20,6 +20,8 @@
 #include "node.h"
 #include "canvasview.h"
 #include "preview.h"
+#include "implicitedges.h"
+#include "graph.h"
 
 
 #include <QTextDocument>
@@ -99,20 +101,20 @@ void Node::addEdge(Edge * edge)
  * Returns:     True if edge was removed, otherwise false.
  * Assumptions: none
  * Bugs:        none
- * Notes:       none
+ * Notes:       The list is searched from the end, since the edge
+ *              removed is most often the last one added (undoing a new
+ *              edge), or the last one of a node whose edges are all
+ *              being removed (see CanvasEdit::removeNode()).
  */
 
 bool Node::removeEdge(Edge * edge)
 {
-    for (int i = 0; i < edgeList.length(); i++)
-    {
-        if (edgeList.at(i) == edge)
-        {
-            edgeList.removeAt(i);
-            return true;
-        }
-    }
-    return false;
+    int i = edgeList.lastIndexOf(edge);
+
+    if (i < 0)
+        return false;
+    edgeList.removeAt(i);
+    return true;
 }
 
 
@@ -128,11 +130,19 @@ bool Node::removeEdge(Edge * edge)
  * Notes:       The argument diameter is the diameter in inches, therefore
  *              the value must be converted back to pixels in order for the
  *              node to be drawn correctly.
+ *              The size of the node changes, so the parent graph is told.
  */
 
 void Node::setDiameter(qreal diameter)
 {
+    Graph * graph = qgraphicsitem_cast<Graph *>(parentItem());
+    QRectF oldRect = Graph::childRect(this);
+
+    prepareGeometryChange();
     nodeDiameter = diameter * logicalDotsPerInchX;
+    if (graph != nullptr)
+        graph->childGeometryChanged(oldRect, Graph::childRect(this));
+    text->centerOn(boundingRect().center());
     update();
 }
 
@@ -381,6 +391,7 @@ void Node::setNodeLabel(qreal number)
     text->setHtml("<font face=\"cmr10\">"
 		  + QString::number(number) + "</font>");
     label = QString::number(number);
+    text->centerOn(boundingRect().center());
 }
 
 
@@ -402,6 +413,7 @@ void Node::setNodeLabel(QString aLabel, qreal number)
     text->setHtml("<font face=\"cmmi10\">" + label
                   + "</font><sub><font face=\"cmr10\">"
                   + QString::number(number) + "</face></sub>");
+    text->centerOn(boundingRect().center());
 }
 
 
@@ -435,20 +447,19 @@ void Node::setNodeLabel(QString aLabel)
  * Returns:     none
  * Assumptions: none
  * Bugs:        none
- * Notes:       IS THIS CALLED FROM ANYWHERE?
- *		IS IT UP-TO-DATE?
+ * Notes:       Used to put back a label saved with getLabelHtml(),
+ *		when an edit is undone.
  */
 
 void Node::setNodeLabel(QString htmltext, qreal labelSize, QString aLabel)
 {
-    qDebug() << "setNodeLabel(QString, qreal, QString) called!";
-
     label = aLabel;
     text->setHtml(htmltext);
     QFont font = text->font();
     font.setPointSize(labelSize);
     text->setFont(font);
     lSize = labelSize;
+    text->centerOn(boundingRect().center());
     update();
 }
 
@@ -471,6 +482,7 @@ void Node::setNodeLabelSize(qreal labelSize)
     font.setPointSize(labelSize);
     lSize = labelSize;
     text->setFont(font);
+    text->centerOn(boundingRect().center());
 }
 
 
@@ -492,6 +504,24 @@ QString Node::getLabel() const
 }
 
 
+/*
+ * Name:        getLabelHtml()
+ * Purpose:     Returns the label as it is drawn.
+ * Arguments:   none
+ * Output:      QString
+ * Modifies:    none
+ * Returns:     the HTML of the label
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       Unlike getLabel(), this keeps any subscript.
+ */
+
+QString Node::getLabelHtml() const
+{
+    return text->toHtml();
+}
+
+
 /*
  * Name:        getLableSize()
  * Purpose:     Returns the font size of the label.
@@ -625,6 +655,10 @@ Node::nodeDeleted()
  * Assumptions: none
  * Bugs:        none
  * Notes:       Currently only draws nodes as circles.
+ *              This must not change the node or its label: the
+ *              canvas may call it from several threads at once (see
+ *              CanvasView::drawItems()).  The label is centred by
+ *              the functions that change its size instead.
  */
 
 void
@@ -639,16 +673,12 @@ Node::paint(QPainter * painter, const QStyleOptionGraphicsItem * option,
     painter->setBrush(brushColor);
 
     QPen pen;
-    // TODO: is this code not defunct?  It seems to be over-ridden.
-    if (isSelected())
-        pen.setStyle(Qt::DotLine);
-    else
-        pen.setStyle(Qt::SolidLine);
-
     if (choose == 1)
         pen.setStyle(Qt::DotLine);
     else if (choose == 2)
         pen.setStyle(Qt::DashLine);
+    else if (isSelected())
+        pen.setStyle(Qt::DotLine);
     else
         pen.setStyle(Qt::SolidLine);
 
@@ -658,11 +688,6 @@ Node::paint(QPainter * painter, const QStyleOptionGraphicsItem * option,
     painter->drawEllipse(-1 * nodeDiameter / 2,
                          -1 * nodeDiameter / 2,
                          nodeDiameter, nodeDiameter);
-
-    text->setPos(this->boundingRect().center().x()
-		 - text->boundingRect().width() / 2.,
-                 this->boundingRect().center().y()
-                 - text->boundingRect().height() / 2.);
 }
 
 
@@ -676,29 +701,36 @@ Node::paint(QPainter * painter, const QStyleOptionGraphicsItem * option,
  * Returns:     none
  * Assumptions: none
  * Bugs:        none
- * Notes:       none
+ * Notes:       This is called on every mouse move while a node is
+ *              dragged, so it must not touch anything but the node's
+ *              own edges and the cached bounds of its graph.  (It used
+ *              to re-parent the node to force the parent graph to
+ *              recompute its bounds, which made dragging in large
+ *              graphs stutter.)
  */
 
 QVariant Node::itemChange(GraphicsItemChange change, const QVariant &value)
 {
     switch (change)
     {
-      case ItemPositionHasChanged:
-        if (parentItem() != 0)
+      case ItemPositionChange:
+        if (parentItem() != nullptr && parentItem()->type() == Graph::Type)
         {
-            if (parentItem()->type() == Graph::Type)
-            {
-                Graph * graph = qgraphicsitem_cast<Graph*>(parentItem());
-                Graph * tempGraph = graph;
-                graph = qgraphicsitem_cast<Graph*>(graph->getRootParent());
-                this->setParentItem(nullptr);
-                this->setParentItem(tempGraph);
-            }
-            if (verbose)
-                qDebug() << "node does not have a graph item parent";
+            Graph * graph = qgraphicsitem_cast<Graph *>(parentItem());
+            QRectF rect = Graph::childRect(this);
+            graph->childGeometryChanged(rect, rect.translated(
+                                            value.toPointF() - pos()));
         }
+        break;
+
+      case ItemPositionHasChanged:
+        // Only the node and its incident edges change here; the
+        // bounds of the parent graph are refreshed once the drag is
+        // over (see CanvasScene::mouseReleaseEvent()).
         foreach (Edge * edge, edgeList)
             edge->adjust();
+        foreach (ImplicitEdges * implicit, implicitEdges)
+            implicit->nodeMoved();
         break;
 
       case ItemRotationChange:
@@ -714,6 +746,66 @@ QVariant Node::itemChange(GraphicsItemChange change, const QVariant &value)
 }
 
 
+/*
+ * Name:        moveQuietly()
+ * Purpose:     Moves a node as part of a batch of moves.
+ * Arguments:   the new position (in the parent's coordinates), and
+ *              the batch
+ * Output:      none
+ * Modifies:    the node's position, moves
+ * Returns:     none
+ * Assumptions: finishMoves() is called once the batch is done.
+ * Bugs:        none
+ * Notes:       The node is moved without sending geometry changes, so
+ *              itemChange() doesn't adjust its edges or its graph's
+ *              bounds.  Instead they are noted in moves, so that an
+ *              edge between two moved nodes is adjusted once, not
+ *              twice, and each graph's bounds are refreshed once.
+ */
+
+void
+Node::moveQuietly(const QPointF & pos, Node_Moves & moves)
+{
+    setFlag(ItemSendsGeometryChanges, false);
+    setPos(pos);
+    setFlag(ItemSendsGeometryChanges, true);
+
+    foreach (Edge * edge, edgeList)
+        moves.edges.insert(edge);
+    foreach (ImplicitEdges * implicit, implicitEdges)
+        moves.implicits.insert(implicit);
+    Graph * graph = qgraphicsitem_cast<Graph *>(parentItem());
+    if (graph != nullptr)
+        moves.graphs.insert(graph);
+}
+
+
+/*
+ * Name:        finishMoves()
+ * Purpose:     Brings up to date what a batch of moves touched.
+ * Arguments:   the batch, and false to leave the graphs' bounds alone
+ * Output:      none
+ * Modifies:    the edges, implicit edge sets and graphs in moves
+ * Returns:     none
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       A drag leaves the bounds until it is over (see
+ *              CanvasScene::moveGroup()).
+ */
+
+void
+Node::finishMoves(const Node_Moves & moves, bool updateBounds)
+{
+    foreach (Edge * edge, moves.edges)
+        edge->adjust();
+    foreach (ImplicitEdges * implicit, moves.implicits)
+        implicit->nodeMoved();
+    if (updateBounds)
+        foreach (Graph * graph, moves.graphs)
+            graph->updateBounds();
+}
+
+
 /*
  * Name:        mousePressEvent()
  * Purpose:
@@ -4,12 +4,24 @@
 #include "label.h"
 #include <QGraphicsItem>
 #include <QList>
+#include <QSet>
 #include <QGraphicsSceneMouseEvent>
 
 class Edge;
+class ImplicitEdges;
+class Graph;
 class CanvasView;
 class PreView;
 
+// What a batch of node moves made out of date: each is brought up to
+// date once, by Node::finishMoves().
+typedef struct
+{
+    QSet<Edge *> edges;
+    QSet<ImplicitEdges *> implicits;
+    QSet<Graph *> graphs;
+} Node_Moves;
+
 class Node : public QGraphicsObject
 {
 public:
@@ -43,6 +55,7 @@ public:
     void setNodeLabelSize(qreal labelSize);
     
     QString getLabel() const;
+    QString getLabelHtml() const;
     qreal getLabelSize() const;
 
     QRectF boundingRect() const;
@@ -51,11 +64,16 @@ public:
     int type() const { return Type; }
 
     QList<Edge *> edgeList;
+    QList<ImplicitEdges *> implicitEdges;
 
     QList<Edge *> edges() const;
     void chosen(int group1);
 
     void editLabel(bool edit);
+
+    void moveQuietly(const QPointF & pos, Node_Moves & moves);
+    static void finishMoves(const Node_Moves & moves,
+                            bool updateBounds = true);
    // ~Node();
 protected:
     QVariant itemChange(GraphicsItemChange change, const QVariant &value);
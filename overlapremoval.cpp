@@ -0,0 +1,378 @@
+/*
+ * File:    overlapremoval.cpp
+ * Date:    2026/10/18
+ * Version: 1.0
+ *
+ * Purpose: Moves the nodes of a graph apart until no two of them
+ *          overlap, moving each as little as it can.
+ *
+ * Notes:   Each pass puts the nodes in a uniform grid, with cells at
+ *          least as wide as the largest node, so a node can only
+ *          overlap the nodes in its own and the 8 surrounding cells.
+ *          Each overlapping pair found is pushed apart along the line
+ *          between their centres, each node by half the overlap,
+ *          which is the smallest move that separates them.  Each push
+ *          is applied as soon as it is found, so the pairs looked at
+ *          later in the pass see it (Gauss-Seidel style), and a crowd
+ *          spreads out within a pass.  Passes repeat until one finds
+ *          no overlaps.  The grid is built by counting sort, so a
+ *          pass takes time linear in the number of nodes and overlaps.
+ *
+ *          A drawing with no overlaps is left exactly as it is.
+ *          Pushing apart only spreads a crowd a little per pass, so
+ *          the nodes of each crowded cell are first put on a spiral;
+ *          if overlaps remain after OVERLAP_LOCAL_PASSES passes, a
+ *          drawing too small for its nodes is scaled up.
+ */
+
+#include "overlapremoval.h"
+#include "layoutgraph.h"
+#include "fastrandom.h"
+
+#include <QPair>
+#include <QVector>
+#include <QtMath>
+#include <algorithm>
+
+// The gap (in pixels) left between two nodes that were overlapping.
+#define OVERLAP_GAP		2
+
+// The most passes made; a huge pile of nodes can take many passes to
+// spread out.
+#define OVERLAP_MAX_PASSES	2000
+
+// Passes between publishing the positions, so the canvas shows the
+// progress.
+#define OVERLAP_PUBLISH		10
+
+// The grid has at most this many cells per node; in a sparse drawing
+// the cells are made bigger instead.
+#define OVERLAP_CELLS_PER_NODE	4
+
+// The drawing is scaled up if its nodes would cover more than this
+// fraction of it.
+#define OVERLAP_MAX_DENSITY	0.6
+
+// A grid cell with more than this many nodes per node-sized area is
+// spread out on a spiral whose points are this many node widths apart.
+#define OVERLAP_CROWD		4
+#define OVERLAP_SPIRAL_SPACING	0.6
+
+// Passes of pushing apart made before a drawing that still has
+// overlaps is scaled up.
+#define OVERLAP_LOCAL_PASSES	50
+
+#define OVERLAP_SEED		20261018
+
+typedef struct
+{
+    qreal left;			// The top left corner of the grid.
+    qreal top;
+    qreal cell;			// The width of a cell.
+    int columns;
+    int rows;
+    QVector<int> start;		// The nodes in cell c are
+    QVector<int> members;	// members[start[c] .. start[c + 1]).
+} Overlap_Grid;
+
+
+/*
+ * Name:        bin_nodes
+ * Purpose:     Puts the nodes in a uniform grid.
+ * Arguments:   the graph, the smallest cell size, and the grid
+ * Output:      none
+ * Modifies:    grid
+ * Returns:     none
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       The nodes are listed cell by cell, in compressed sparse
+ *              row form, by counting sort.  In a sparse drawing the
+ *              cells are made bigger, so that there are never more
+ *              than OVERLAP_CELLS_PER_NODE of them per node.
+ */
+
+static void
+bin_nodes(const LayoutGraph * graph, qreal minCell, Overlap_Grid & grid)
+{
+    const int n = graph->nodeCount();
+    const QPointF * positions = graph->positions.constData();
+
+    qreal right = positions[0].x(), bottom = positions[0].y();
+    grid.left = right;
+    grid.top = bottom;
+    for (int i = 1; i < n; i++)
+    {
+	grid.left = qMin(grid.left, positions[i].x());
+	right = qMax(right, positions[i].x());
+	grid.top = qMin(grid.top, positions[i].y());
+	bottom = qMax(bottom, positions[i].y());
+    }
+
+    grid.cell = minCell;
+    qreal area = (right - grid.left + minCell) * (bottom - grid.top + minCell);
+    if (area / (minCell * minCell) > (qreal)OVERLAP_CELLS_PER_NODE * n)
+	grid.cell = qSqrt(area / ((qreal)OVERLAP_CELLS_PER_NODE * n));
+    grid.columns = (int)((right - grid.left) / grid.cell) + 1;
+    grid.rows = (int)((bottom - grid.top) / grid.cell) + 1;
+
+    const int cells = grid.columns * grid.rows;
+    QVector<int> cellOf(n);
+    grid.start.fill(0, cells + 1);
+    grid.members.resize(n);
+    for (int i = 0; i < n; i++)
+    {
+	int column = qMin(grid.columns - 1,
+			  (int)((positions[i].x() - grid.left) / grid.cell));
+	int row = qMin(grid.rows - 1,
+		       (int)((positions[i].y() - grid.top) / grid.cell));
+	cellOf[i] = row * grid.columns + column;
+	grid.start[cellOf.at(i) + 1]++;
+    }
+    for (int c = 0; c < cells; c++)
+	grid.start[c + 1] += grid.start.at(c);
+    QVector<int> fill = grid.start;
+    for (int i = 0; i < n; i++)
+	grid.members[fill[cellOf.at(i)]++] = i;
+}
+
+
+/*
+ * Name:        expand
+ * Purpose:     Spreads out a drawing too small for its nodes.
+ * Arguments:   the graph
+ * Output:      none
+ * Modifies:    graph->positions
+ * Returns:     none
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       If the nodes (with their gaps) would cover more than
+ *              OVERLAP_MAX_DENSITY of the bounding box, the drawing is
+ *              scaled up about its centre until they wouldn't.  A
+ *              graph that has been scaled down too far thus gets its
+ *              size back in one step, instead of being pushed apart a
+ *              little at a time.  Only used once pushing apart has
+ *              failed, since it moves every node.
+ */
+
+static void
+expand(LayoutGraph * graph)
+{
+    const int n = graph->nodeCount();
+    QPointF * positions = graph->positions.data();
+    qreal left = positions[0].x(), right = left;
+    qreal top = positions[0].y(), bottom = top;
+    qreal needed = 0, largest = 0;
+    QPointF centre;
+
+    for (int i = 0; i < n; i++)
+    {
+	left = qMin(left, positions[i].x());
+	right = qMax(right, positions[i].x());
+	top = qMin(top, positions[i].y());
+	bottom = qMax(bottom, positions[i].y());
+	centre += positions[i];
+	qreal d = graph->diameters.at(i) + OVERLAP_GAP;
+	needed += M_PI / 4 * d * d;
+	largest = qMax(largest, d);
+    }
+    centre /= n;
+    needed /= OVERLAP_MAX_DENSITY;
+
+    qreal area = (right - left + largest) * (bottom - top + largest);
+    if (area >= needed)
+	return;
+    qreal scale = qSqrt(needed / area);
+    for (int i = 0; i < n; i++)
+	positions[i] = centre + (positions[i] - centre) * scale;
+}
+
+
+/*
+ * Name:        spread_crowds
+ * Purpose:     Spreads out the nodes of crowded grid cells.
+ * Arguments:   the graph, the largest diameter and the grid
+ * Output:      none
+ * Modifies:    graph->positions
+ * Returns:     none
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       A cell holding more than OVERLAP_CROWD nodes for each
+ *              node that fits in it (a pile of nodes at one spot,
+ *              say) would take many passes to
+ *              empty, so its nodes are laid out on a sunflower spiral
+ *              around their centre instead, the nearest to the centre
+ *              innermost.  Successive points of the spiral are about
+ *              a node apart.
+ */
+
+static void
+spread_crowds(LayoutGraph * graph, qreal largest, const Overlap_Grid & grid)
+{
+    QPointF * positions = graph->positions.data();
+    const qreal spacing = OVERLAP_SPIRAL_SPACING * (largest + OVERLAP_GAP);
+    const qreal golden = M_PI * (3 - qSqrt(5));
+    const qreal fits = (grid.cell / (largest + OVERLAP_GAP))
+	* (grid.cell / (largest + OVERLAP_GAP));
+    QVector<QPair<qreal, int> > crowd;
+
+    for (int c = 0; c < grid.columns * grid.rows; c++)
+    {
+	int count = grid.start.at(c + 1) - grid.start.at(c);
+	if (count <= OVERLAP_CROWD * fits)
+	    continue;
+
+	QPointF centre;
+	for (int m = grid.start.at(c); m < grid.start.at(c + 1); m++)
+	    centre += positions[grid.members.at(m)];
+	centre /= count;
+
+	crowd.clear();
+	for (int m = grid.start.at(c); m < grid.start.at(c + 1); m++)
+	{
+	    int i = grid.members.at(m);
+	    QPointF away = positions[i] - centre;
+	    crowd.append(qMakePair(away.x() * away.x() + away.y() * away.y(),
+				   i));
+	}
+	std::sort(crowd.begin(), crowd.end());
+	for (int k = 0; k < count; k++)
+	{
+	    qreal radius = spacing * qSqrt(k + 0.5);
+	    qreal angle = golden * k;
+	    positions[crowd.at(k).second]
+		= centre + QPointF(qCos(angle), qSin(angle)) * radius;
+	}
+    }
+}
+
+
+/*
+ * Name:        separate_pass
+ * Purpose:     Pushes apart every overlapping pair of nodes.
+ * Arguments:   the graph, the grid, the random number generator, and
+ *              false to only look for an overlap
+ * Output:      none
+ * Modifies:    graph->positions, if move is true
+ * Returns:     the number of overlapping pairs found (at most 1 if
+ *              move is false)
+ * Assumptions: The grid's cells are at least as wide as the largest
+ *              node.
+ * Bugs:        none
+ * Notes:       The nodes move within the grid as the pass goes on; a
+ *              pair that this misses is found by the next pass.  Nodes
+ *              at the very same spot are pushed apart in a random
+ *              direction.
+ */
+
+static int
+separate_pass(LayoutGraph * graph, const Overlap_Grid & grid,
+	      FastRandom & random, bool move = true)
+{
+    QPointF * positions = graph->positions.data();
+    const qreal * diameters = graph->diameters.constData();
+    const int columns = grid.columns, rows = grid.rows;
+
+    // Compare each node with the later nodes of its own cell and with
+    // the nodes of the 4 cells after it, so each pair is seen once.
+    static const int around[5][2] = {{0, 0}, {1, 0}, {-1, 1}, {0, 1}, {1, 1}};
+    int overlaps = 0;
+    for (int c = 0; c < columns * rows; c++)
+    {
+	int column = c % columns, row = c / columns;
+	for (int m = grid.start.at(c); m < grid.start.at(c + 1); m++)
+	{
+	    int i = grid.members.at(m);
+	    for (int a = 0; a < 5; a++)
+	    {
+		int otherColumn = column + around[a][0];
+		int otherRow = row + around[a][1];
+		if (otherColumn < 0 || otherColumn >= columns
+		    || otherRow >= rows)
+		    continue;
+		int d = otherRow * columns + otherColumn;
+		for (int k = (a == 0 ? m + 1 : grid.start.at(d));
+		     k < grid.start.at(d + 1); k++)
+		{
+		    int j = grid.members.at(k);
+		    qreal reach = (diameters[i] + diameters[j]) / 2;
+		    QPointF away = positions[j] - positions[i];
+		    qreal distance2 = away.x() * away.x() + away.y() * away.y();
+		    if (distance2 >= reach * reach)
+			continue;
+
+		    overlaps++;
+		    if (!move)
+			return overlaps;
+		    qreal distance = qSqrt(distance2);
+		    if (distance < 1e-9)
+		    {
+			qreal angle = 2 * M_PI * random.uniform();
+			away = QPointF(qCos(angle), qSin(angle));
+			distance = 1;
+		    }
+		    QPointF push = away
+			* ((reach + OVERLAP_GAP - distance) / (2 * distance));
+		    positions[i] -= push;
+		    positions[j] += push;
+		}
+	    }
+	}
+    }
+    return overlaps;
+}
+
+
+/*
+ * Name:        remove_overlaps
+ * Purpose:     Moves the nodes of a graph apart until none overlap.
+ * Arguments:   the graph
+ * Output:      none
+ * Modifies:    graph->positions
+ * Returns:     none
+ * Assumptions: none
+ * Bugs:        Stops after OVERLAP_MAX_PASSES passes even if some
+ *              nodes still overlap.
+ * Notes:       A drawing with no overlaps isn't changed at all.
+ *              Otherwise nodes that don't overlap anything aren't
+ *              moved, unless they are in the way of nodes that do, or
+ *              the drawing has to be scaled up.
+ */
+
+void
+remove_overlaps(LayoutGraph * graph)
+{
+    const int n = graph->nodeCount();
+    if (n < 2)
+	return;
+
+    FastRandom random(OVERLAP_SEED);
+    Overlap_Grid grid;
+    qreal largest = 0;
+    for (int i = 0; i < n; i++)
+	largest = qMax(largest, graph->diameters.at(i));
+
+    bin_nodes(graph, largest + OVERLAP_GAP, grid);
+    if (separate_pass(graph, grid, random, false) == 0)
+	return;
+    spread_crowds(graph, largest, grid);
+    graph->publish();
+
+    for (int pass = 1; pass <= OVERLAP_MAX_PASSES; pass++)
+    {
+	if (graph->isCancelled())
+	    return;
+	if (pass == OVERLAP_LOCAL_PASSES + 1)
+	{
+	    // Pushing apart hasn't done it; the drawing may just be too
+	    // small for its nodes.
+	    expand(graph);
+	    bin_nodes(graph, largest + OVERLAP_GAP, grid);
+	    spread_crowds(graph, largest, grid);
+	}
+	bin_nodes(graph, largest + OVERLAP_GAP, grid);
+	if (separate_pass(graph, grid, random) == 0)
+	    return;
+	if (pass % OVERLAP_PUBLISH == 0)
+	    graph->publish();
+    }
+}
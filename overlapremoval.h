@@ -0,0 +1,16 @@
+/*
+ * File:	overlapremoval.h
+ * Date:	2026/10/18
+ * Version:	1.0
+ *
+ * Purpose:	Declares the operation that moves overlapping nodes apart.
+ */
+
+#ifndef OVERLAPREMOVAL_H
+#define OVERLAPREMOVAL_H
+
+class LayoutGraph;
+
+void remove_overlaps(LayoutGraph * graph);
+
+#endif // OVERLAPREMOVAL_H
@@ -13,6 +13,7 @@
 #include "node.h"
 #include "graph.h"
 #include "graphmimedata.h"
+#include "implicitedges.h"
 #include <math.h>
 #include <QKeyEvent>
 #include <QDrag>
@@ -22,10 +23,23 @@
 #include <QMessageBox>
 #include <QFileDialog>
 #include <QShortcut>
+#include <QtConcurrent/QtConcurrentRun>
 #include <qmath.h>
 
 #define SCALE_FACTOR    1.2
 
+// Graphs with more nodes and edges than this (roughly, see
+// BasicGraphs::estimate_size()) are generated on another thread.
+#define ASYNC_GENERATE_SIZE	50000
+
+// Largest width or height (in pixels) of the image shown while a
+// graph is dragged to the canvas.
+#define DRAG_PIXMAP_MAX_SIZE	256
+
+// Total size (nodes plus edges) of the recently generated graphs kept
+// so that they don't have to be generated again.
+#define GENERATED_CACHE_SIZE	2000000
+
 /*
  * Name:        PreView
  * Purpose:     Contructor for PreView class
@@ -48,6 +62,14 @@ PreView::PreView(QWidget *parent)
     setRenderHint(QPainter::Antialiasing);
     setTransformationAnchor(AnchorUnderMouse);
     setScene(aScene);
+    dragGraph = nullptr;
+    createdGraph = nullptr;
+    styledGraph = nullptr;
+    generationNumber = 0;
+    pendingNumber = -1;
+    generated.setMaxCost(GENERATED_CACHE_SIZE);
+    connect(&generation, SIGNAL(finished()),
+            this, SLOT(generationFinished()));
 }
 
 /*
@@ -98,6 +120,20 @@ void PreView::scaleView(qreal scaleFactor)
     scale(scaleFactor, scaleFactor);
 }
 
+/*
+ * Name:        mousePressEvent
+ * Purpose:     Starts dragging a graph to the canvas.
+ * Arguments:   QMouseEvent *
+ * Output:      none
+ * Modifies:    dragImage, dragGraph
+ * Returns:     none
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       The drag image is made by dragPixmap() the first time
+ *              a graph is dragged and then reused until the graph is
+ *              regenerated or restyled.
+ */
+
 void PreView::mousePressEvent(QMouseEvent *event)
 {
     if (event->button() == Qt::LeftButton)
@@ -115,25 +151,7 @@ void PreView::mousePressEvent(QMouseEvent *event)
                     GraphMimeData * data = new GraphMimeData(graph);
                     QDrag * drag = new QDrag(this->scene());
                     drag->setMimeData(data);
-
-
-                    QPixmap * image = new QPixmap(
-                                graph->childrenBoundingRect().size().toSize());
-                    image->fill(Qt::white);
-                    QPainter painter(image);
-                    painter.setRenderHints(QPainter::Antialiasing |
-                                           QPainter::HighQualityAntialiasing |
-                                           QPainter::NonCosmeticDefaultPen,
-                                           true);
-                    scene()->render(&painter,QRectF(0,
-                                                    0,
-                                                    scene()->itemsBoundingRect().width(),
-                                                    scene()->itemsBoundingRect().height()),
-                                    scene()->itemsBoundingRect(),
-                                    Qt::IgnoreAspectRatio);
-                    painter.end();
-
-                    drag->setPixmap(*image);
+                    drag->setPixmap(dragPixmap(graph));
                     drag->exec();
                     break;
             }
@@ -142,6 +160,96 @@ void PreView::mousePressEvent(QMouseEvent *event)
     QGraphicsView::mousePressEvent(event);
 }
 
+
+/*
+ * Name:        dragPixmap
+ * Purpose:     Returns the image shown while a graph is dragged.
+ * Arguments:   Graph *
+ * Output:      none
+ * Modifies:    dragImage, dragGraph
+ * Returns:     the image, at most DRAG_PIXMAP_MAX_SIZE on a side
+ * Assumptions: graph is in this view's scene.
+ * Bugs:        none
+ * Notes:       Only the graph is rendered, straight into the smaller
+ *              image, so a large preview costs no more to drag than a
+ *              small one.
+ */
+
+const QPixmap &
+PreView::dragPixmap(Graph * graph)
+{
+    if (dragGraph == graph && !dragImage.isNull())
+        return dragImage;
+
+    QRectF source = graph->sceneBoundingRect();
+    QSize size = source.size().toSize();
+    if (size.isEmpty())
+        size = QSize(1, 1);
+    if (size.width() > DRAG_PIXMAP_MAX_SIZE
+        || size.height() > DRAG_PIXMAP_MAX_SIZE)
+        size.scale(DRAG_PIXMAP_MAX_SIZE, DRAG_PIXMAP_MAX_SIZE,
+                   Qt::KeepAspectRatio);
+
+    dragImage = QPixmap(size);
+    dragImage.fill(Qt::white);
+    QPainter painter(&dragImage);
+    painter.setRenderHints(QPainter::Antialiasing |
+                           QPainter::SmoothPixmapTransform |
+                           QPainter::NonCosmeticDefaultPen,
+                           true);
+    scene()->render(&painter, QRectF(QPointF(0, 0), size), source,
+                    Qt::KeepAspectRatio);
+    painter.end();
+
+    dragGraph = graph;
+    return dragImage;
+}
+
+
+/*
+ * Name:        Clear_Scene
+ * Purpose:     Removes (and deletes) every graph in the preview.
+ * Arguments:   none
+ * Output:      none
+ * Modifies:    the scene, dragImage, dragGraph, createdGraph,
+ *              styledGraph
+ * Returns:     none
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       The next graph may be allocated where a deleted one
+ *              was, so the pointers remembered here are reset too.
+ */
+
+void PreView::Clear_Scene()
+{
+    invalidateDragPixmap();
+    createdGraph = nullptr;
+    styledGraph = nullptr;
+    generationNumber++;
+    scene()->clear();
+}
+
+
+/*
+ * Name:        invalidateDragPixmap
+ * Purpose:     Throws away the drag image of the previewed graph.
+ * Arguments:   none
+ * Output:      none
+ * Modifies:    dragImage, dragGraph
+ * Returns:     none
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       Called whenever the previewed graph is replaced or
+ *              restyled.  Also frees the image, since the previous
+ *              graph may no longer exist.
+ */
+
+void PreView::invalidateDragPixmap()
+{
+    dragGraph = nullptr;
+    dragImage = QPixmap();
+}
+
 /*
  * Name:        zoomIn
  * Purpose:     Zoom in featuture of the QGraphicsScene
@@ -174,92 +282,214 @@ void PreView::zoomOut()
     scaleView(1 / qreal(SCALE_FACTOR));
 }
 
+/*
+ * Name:        Create_Graph
+ * Purpose:     Generates a basic graph and adds it to the preview.
+ * Arguments:   the Graph_Type, the two node counts, the height and
+ *              width (in pixels) and whether to add the edges
+ * Output:      none
+ * Modifies:    the scene
+ * Returns:     the new graph, or nullptr if it is being generated on
+ *              another thread
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       A big graph is described on another thread (see
+ *              BasicGraphs::generate()) and only turned into Nodes
+ *              and Edges once that is done, so the UI doesn't block.
+ *              graphGenerated() is emitted when it has been added.
+ *              If another graph is asked for in the meantime, the
+ *              pending one is thrown away when it is done.
+ *              Recently generated descriptions are cached (see
+ *              cacheDescription()), so asking for the same graph
+ *              again, e.g. after dragging it to the canvas or when
+ *              going back to a type, doesn't generate it again.
+ */
+
 Graph * PreView::Create_Graph(int graph, int topNodes, int bottomNodes,
                               qreal height, qreal width, bool complete)
 {
-    Graph * graphItem = new Graph();
-    BasicGraphs * simpleG = new BasicGraphs();
-    switch (graph) {
-    case BasicGraphs::Bipartite:
-        simpleG->generate_bipartite(graphItem, topNodes, bottomNodes,
-                                    height, width, complete);
-        break;
+    invalidateDragPixmap();
+    generationNumber++;
 
-    case BasicGraphs::Complete:
-        simpleG->generate_complete(graphItem, width / 2, height / 2, topNodes,
-                                   complete);
-        break;
+    Generation_Key key = {graph, topNodes, bottomNodes, height, width,
+                          complete};
+    GraphDescription * cached = generated.object(key);
+    if (cached != nullptr)
+        return addGraph(*cached, graph, height, width);
 
-    case BasicGraphs::Cycle:
-        simpleG->generate_cycle(graphItem, width / 2, height / 2, topNodes,
-                                complete);
-        break;
-    case BasicGraphs::Star:
-        simpleG->generate_star(graphItem, width / 2, height / 2, topNodes,
-                               complete);
-        break;
+    if (BasicGraphs::estimate_size(graph, topNodes, bottomNodes, complete)
+        > ASYNC_GENERATE_SIZE)
+    {
+        pendingNumber = generationNumber;
+        pendingKey = key;
+        generation.setFuture(QtConcurrent::run([=]()
+        {
+            GraphDescription desc;
+            BasicGraphs().generate(&desc, graph, topNodes, bottomNodes,
+                                   height, width, complete);
+            return desc;
+        }));
+        return nullptr;
+    }
 
-    case BasicGraphs::Wheel:
-        simpleG->generate_wheel(graphItem, width / 2, height / 2, topNodes,
-                                complete);
-        break;
+    GraphDescription desc;
+    BasicGraphs().generate(&desc, graph, topNodes, bottomNodes,
+                           height, width, complete);
+    cacheDescription(key, desc);
+    return addGraph(desc, graph, height, width);
+}
 
-    case BasicGraphs::Petersen:
-        simpleG->generate_petersen(graphItem, width / 2, height / 2,
-                           topNodes, bottomNodes, complete);
-        break;
 
-    case BasicGraphs::BBTree:
-        simpleG->generate_balanced_binary_tree(graphItem, height, width,
-                                               topNodes, complete);
-        break;
+/*
+ * Name:        generationFinished
+ * Purpose:     Adds a graph generated on another thread to the preview.
+ * Arguments:   none
+ * Output:      none
+ * Modifies:    the scene
+ * Returns:     none
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       If the preview has moved on to another graph since it
+ *              was asked for, the result is only cached.
+ */
 
-    case BasicGraphs::Crown:
-        simpleG->generate_crown(graphItem, width / 2, height / 2, topNodes,
-                                complete);
-        break;
+void PreView::generationFinished()
+{
+    GraphDescription desc = generation.result();
+    cacheDescription(pendingKey, desc);
 
-    case BasicGraphs::Windmill:
-        simpleG->generate_dutch_windmill(graphItem, height, topNodes,
-                                         bottomNodes, complete);
-        break;
+    if (pendingNumber != generationNumber)
+        return;
 
-    case BasicGraphs::Gear:
-            simpleG->generate_gear(graphItem, width / 2, height / 2, topNodes,
-                                   complete);
-        break;
+    pendingNumber = -1;
+    addGraph(desc, pendingKey.type, pendingKey.height, pendingKey.width);
+    emit graphGenerated();
+}
 
-    case BasicGraphs::Grid:
-        simpleG->generate_grid(graphItem, height, width, topNodes,bottomNodes,
-                               complete);
-        break;
 
-    case BasicGraphs::Helm:
-        simpleG->generate_helm(graphItem, width / 2, height / 2, topNodes,
-                               complete);
-        break;
+/*
+ * Name:        cacheDescription
+ * Purpose:     Remembers a generated description.
+ * Arguments:   what it was generated from, and the description
+ * Output:      none
+ * Modifies:    generated
+ * Returns:     none
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       The cache holds at most GENERATED_CACHE_SIZE nodes and
+ *              edges (an implicit edge set counts as one), and drops
+ *              the least recently used descriptions to make room.
+ *              A description bigger than that isn't kept.  The copy
+ *              is cheap, since QVectors are shared.
+ */
 
-    case BasicGraphs::Path:
-        simpleG->generate_path(graphItem, width, topNodes, complete);
-        break;
+void
+PreView::cacheDescription(const Generation_Key & key,
+                          const GraphDescription & desc)
+{
+    generated.insert(key, new GraphDescription(desc),
+                     desc.nodeCount() + desc.edgeCount()
+                     + desc.implicitEdges.count());
+}
 
-    case BasicGraphs::Prism:
-        simpleG->generate_prism(graphItem, width / 2, height / 2, topNodes,
-                                complete);
-        break;
 
-    case BasicGraphs::Antiprism:
-        simpleG->generate_antiprism(graphItem, width / 2, height / 2, topNodes,
-                                    complete);
-        break;
-    default:
-        break;
-    }
+/*
+ * Name:        addGraph
+ * Purpose:     Turns a description into a Graph in the preview.
+ * Arguments:   the description and the type, height and width it was
+ *              generated with
+ * Output:      none
+ * Modifies:    the scene, createdGraph and friends
+ * Returns:     the new graph
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       The graph is only added to the scene once all of its
+ *              nodes and edges are in it.
+ */
+
+Graph * PreView::addGraph(const GraphDescription & desc, int graphType,
+                          qreal height, qreal width)
+{
+    Graph * graphItem = new Graph();
+    desc.materialize(graphItem);
     this->scene()->addItem(graphItem);
+    createdGraph = graphItem;
+    createdType = graphType;
+    createdHeight = height;
+    createdWidth = width;
     return graphItem;
+}
 
+
+/*
+ * Name:        Resize_Graph
+ * Purpose:     Changes the height and width of the graph made by the
+ *              last call of Create_Graph() without regenerating it.
+ * Arguments:   the graph, its new height and width (in pixels)
+ * Output:      none
+ * Modifies:    the positions of the graph's nodes
+ * Returns:     false if the graph must be regenerated instead.
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       Every generator in BasicGraphs places its nodes at
+ *              coordinates that are proportional to the width (x) and
+ *              the height (y) it is given, except the windmill, which
+ *              uses the height for both, and the path, which only
+ *              uses the width.  So scaling the node positions gives
+ *              exactly the graph that Create_Graph() would have made.
+ *              A graph that was created with a zero height or width
+ *              can't be scaled.
+ */
+
+bool
+PreView::Resize_Graph(Graph * graph, qreal height, qreal width)
+{
+    if (graph != createdGraph)
+        return false;
+
+    qreal oldX = createdWidth, newX = width;
+    qreal oldY = createdHeight, newY = height;
+    if (createdType == BasicGraphs::Windmill)
+    {
+        oldX = createdHeight;
+        newX = height;
+    }
+    else if (createdType == BasicGraphs::Path)
+        oldY = newY = 1;
+
+    if (qFuzzyIsNull(oldX) || qFuzzyIsNull(oldY))
+        return false;
+
+    qreal xScale = newX / oldX;
+    qreal yScale = newY / oldY;
+    if (xScale != 1 || yScale != 1)
+    {
+        foreach (QGraphicsItem * item, graph->childItems())
+            if (item->type() == Node::Type)
+                item->setPos(item->x() * xScale, item->y() * yScale);
+        invalidateDragPixmap();
+    }
+    createdHeight = height;
+    createdWidth = width;
+    return true;
 }
 
+/*
+ * Name:        Style_Graph
+ * Purpose:     Applies the style chosen in the UI to a graph.
+ * Arguments:   the graph and the style attributes
+ * Output:      none
+ * Modifies:    the graph's nodes and edges, style, styledGraph
+ * Returns:     none
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       If graph is the one that was last styled, only the
+ *              attributes that differ from the last call are set, so
+ *              that, for example, picking a new edge colour doesn't
+ *              touch the nodes.  Items are restyled in place; the
+ *              scene collects their updates into a single repaint.
+ */
+
 void PreView::Style_Graph(Graph * graph, int graphType, qreal nodeDiameter,
                           QString topNodeLabels, QString bottomNodeLabels,
                           bool numberedLabels, qreal nodeLabelSize, qreal edgeSize,
@@ -267,19 +497,46 @@ void PreView::Style_Graph(Graph * graph, int graphType, qreal nodeDiameter,
                           QColor nodeFillColor, QColor nodeOutlineColor,
                           QColor edgeLineColor)
 {
+    bool all = graph != styledGraph;
+    bool relabel = all || graphType != style.graphType
+        || topNodeLabels != style.topNodeLabels
+        || bottomNodeLabels != style.bottomNodeLabels
+        || numberedLabels != style.numberedLabels;
+    bool labelSize = relabel || nodeLabelSize != style.nodeLabelSize;
+    bool diameter = all || nodeDiameter != style.nodeDiameter;
+    bool penWidth = all || edgeSize != style.edgeSize;
+    bool fill = all || nodeFillColor != style.nodeFillColor;
+    bool outline = all || nodeOutlineColor != style.nodeOutlineColor;
+    bool colour = all || edgeLineColor != style.edgeLineColor;
+    bool weight = all || edgeLabel != style.edgeLabel;
+    bool weightSize = all || edgeLabelSize != style.edgeLabelSize;
+    bool nodes = relabel || labelSize || diameter || penWidth || fill || outline;
+    bool edges = diameter || penWidth || colour || weight || weightSize;
+
+    if (nodes || edges)
+        invalidateDragPixmap();
+
     int i = 0, j = 0;
     //Styling Nodes
     foreach(QGraphicsItem * item, graph->childItems())
     {
-        if (item->type() == Node::Type)
+        if (nodes && item->type() == Node::Type)
         {
              Node * node = qgraphicsitem_cast<Node *>(item);
-             node->setParentItem(nullptr);
-             node->setDiameter(nodeDiameter);
-             node->setEdgeWeight(edgeSize);
-             node->setFillColour(nodeFillColor);
-             node->setLineColour(nodeOutlineColor);
-             if (numberedLabels)
+             if (diameter)
+                 node->setDiameter(nodeDiameter);
+             if (penWidth)
+                 node->setEdgeWeight(edgeSize);
+             if (fill)
+                 node->setFillColour(nodeFillColor);
+             if (outline)
+                 node->setLineColour(nodeOutlineColor);
+             if (!relabel)
+             {
+                 if (labelSize)
+                     node->setNodeLabelSize(nodeLabelSize);
+             }
+             else if (numberedLabels)
              {
 
                  node->setNodeLabel(i);
@@ -312,6 +569,8 @@ void PreView::Style_Graph(Graph * graph, int graphType, qreal nodeDiameter,
                      node->setNodeLabelSize(nodeLabelSize);
                      i++;
                  }
+                 else if (!all)
+                     node->setNodeLabel(QString());
              }
              else if (topNodeLabels.length() != 0)
              {
@@ -319,24 +578,59 @@ void PreView::Style_Graph(Graph * graph, int graphType, qreal nodeDiameter,
                  node->setNodeLabelSize(nodeLabelSize);
                  i++;
              }
-             node->setParentItem(graph);
+             else if (!all)
+                 node->setNodeLabel(QString());
         }
         //Styling Edges
-        else if (item->type() == Edge::Type)
+        else if (edges && item->type() == Edge::Type)
         {
              Edge * edge = qgraphicsitem_cast<Edge *>(item);
-             edge->setParentItem(nullptr);
-             edge->setDestRadius(nodeDiameter / 2.);
-             edge->setSourceRadius(edge->sourceNode()->getDiameter() / 2.);
-             edge->setPenWidth(edgeSize);
-             edge->setColour(edgeLineColor);
-             edge->setWeightLabelSize((edgeLabelSize > 0) ? edgeLabelSize : 1);
-             if (edgeLabel.length() != 0)
+             if (diameter)
+             {
+                 edge->setDestRadius(nodeDiameter / 2.);
+                 edge->setSourceRadius(nodeDiameter / 2.);
+             }
+             if (penWidth)
+                 edge->setPenWidth(edgeSize);
+             if (colour)
+                 edge->setColour(edgeLineColor);
+             if (weightSize)
+                 edge->setWeightLabelSize((edgeLabelSize > 0)
+                                          ? edgeLabelSize : 1);
+             if (weight && (edgeLabel.length() != 0 || !all))
                 edge->setWeight(edgeLabel);
-             //edge->adjust();
-             edge->setParentItem(graph);
+        }
+        //Styling implicit edges (which have no labels)
+        else if (edges && item->type() == ImplicitEdges::Type)
+        {
+             ImplicitEdges * implicit = static_cast<ImplicitEdges *>(item);
+             if (diameter)
+                 implicit->setRadius(nodeDiameter / 2.);
+             if (penWidth)
+                 implicit->setPenWidth(edgeSize);
+             if (colour)
+                 implicit->setColour(edgeLineColor);
         }
     }
     graph->setPos(mapToScene(viewport()->rect().center()));
-    graph->setRotation(-1 * rotation);
+    if (all || rotation != style.rotation)
+    {
+        graph->setRotation(-1 * rotation);
+        invalidateDragPixmap();
+    }
+
+    styledGraph = graph;
+    style.graphType = graphType;
+    style.nodeDiameter = nodeDiameter;
+    style.topNodeLabels = topNodeLabels;
+    style.bottomNodeLabels = bottomNodeLabels;
+    style.numberedLabels = numberedLabels;
+    style.nodeLabelSize = nodeLabelSize;
+    style.edgeSize = edgeSize;
+    style.edgeLabel = edgeLabel;
+    style.edgeLabelSize = edgeLabelSize;
+    style.rotation = rotation;
+    style.nodeFillColor = nodeFillColor;
+    style.nodeOutlineColor = nodeOutlineColor;
+    style.edgeLineColor = edgeLineColor;
 }
@@ -2,13 +2,61 @@
 #define PREVIEW_H
 
 #include "graph.h"
+#include "graphdescription.h"
 
 #include <QGraphicsView>
 #include <QGraphicsSceneMouseEvent>
+#include <QFutureWatcher>
+#include <QCache>
 
 class Node;
 class Edge;
 
+// The style last applied to the previewed graph, so that Style_Graph()
+// only has to touch the attributes that changed.
+typedef struct gStyle
+{
+    int graphType;
+    qreal nodeDiameter;
+    QString topNodeLabels;
+    QString bottomNodeLabels;
+    bool numberedLabels;
+    qreal nodeLabelSize;
+    qreal edgeSize;
+    QString edgeLabel;
+    qreal edgeLabelSize;
+    qreal rotation;
+    QColor nodeFillColor;
+    QColor nodeOutlineColor;
+    QColor edgeLineColor;
+} Graph_Style;
+
+// What a basic graph was generated from: the key of the cache of
+// generated graphs.
+typedef struct gKey
+{
+    int type;
+    int topNodes;
+    int bottomNodes;
+    qreal height;
+    qreal width;
+    bool complete;
+} Generation_Key;
+
+inline bool operator==(const Generation_Key & a, const Generation_Key & b)
+{
+    return a.type == b.type && a.topNodes == b.topNodes
+        && a.bottomNodes == b.bottomNodes && a.height == b.height
+        && a.width == b.width && a.complete == b.complete;
+}
+
+inline uint qHash(const Generation_Key & key, uint seed = 0)
+{
+    return qHash(((key.type * 31u + key.topNodes) * 31u + key.bottomNodes)
+                 * 2u + key.complete, seed)
+        ^ qHash(key.height, seed) ^ (qHash(key.width, seed) * 7u);
+}
+
 class PreView: public QGraphicsView
 {
     Q_OBJECT
@@ -17,11 +65,14 @@ public:
     bool isComplete();
 
 public slots:
+    void Clear_Scene();
+    void invalidateDragPixmap();
     void zoomIn();
     void zoomOut();
     Graph * Create_Graph(int graph, int topNodes, int bottomNodes,
                              qreal height, qreal width,
                              bool complet);
+    bool Resize_Graph(Graph * graph, qreal height, qreal width);
 
 
     void Style_Graph(Graph * item, int graphType, qreal nodeDiameter,
@@ -30,17 +81,41 @@ public slots:
                      QString edgeLabel, qreal edgeLabelSize, qreal rotation,
                      QColor nodeFillColor, QColor nodeOutlineColor,
                      QColor edgeLineColor);
+signals:
+    void graphGenerated();
+
+private slots:
+    void generationFinished();
+
 protected:
     virtual void keyPressEvent(QKeyEvent *event);
     virtual void scaleView(qreal scaleFactor);
     virtual void mousePressEvent(QMouseEvent *event);
 
+private:
+    const QPixmap & dragPixmap(Graph * graph);
+    Graph * addGraph(const GraphDescription & desc, int graphType,
+                     qreal height, qreal width);
+    void cacheDescription(const Generation_Key & key,
+                          const GraphDescription & desc);
 
 private:
     QGraphicsScene * aScene;
     bool modified;
     QImage image;
     QColor edgeLine, nodeLine, nodeFill;
+    QPixmap dragImage;		// Image shown while dragging dragGraph.
+    Graph * dragGraph;		// nullptr if dragImage is out of date.
+    Graph * createdGraph;	// The graph made by the last Create_Graph().
+    int createdType;		// ... and its type, height and width.
+    qreal createdHeight, createdWidth;
+    Graph * styledGraph;	// The graph style was last applied to.
+    Graph_Style style;
+    QFutureWatcher<GraphDescription> generation;
+    int generationNumber;	// Incremented for each new preview graph.
+    int pendingNumber;		// generationNumber of the pending graph...
+    Generation_Key pendingKey;	// ... and what it is being made from.
+    QCache<Generation_Key, GraphDescription> generated;
 };
 
 #endif // PREVIEW_H
@@ -1,4 +1,5 @@
 #include "sizecontroller.h"
+#include "canvasedit.h"
 
 
 SizeController::SizeController(Edge *anEdge, QDoubleSpinBox *aBox)
@@ -39,13 +40,13 @@ SizeController::SizeController(Node * aNode, QDoubleSpinBox *aBox)
 void SizeController::setEdgeSize(double value)
 {
     if (edge != nullptr || edge != 0)
-    edge->setPenWidth(value);
+    CanvasEdit::setStyle(edge, CanvasEdit::EdgeWidth, value);
 }
 
 void SizeController::setNodeSize(double value)
 {
     if (node != nullptr || node != 0)
-        node->setDiameter(value);
+        CanvasEdit::setStyle(node, CanvasEdit::NodeDiameter, value);
 }
 
 void SizeController::deletedBox()
@@ -0,0 +1,488 @@
+/*
+ * File:    spectrallayout.cpp
+ * Date:    2026/10/18
+ * Version: 1.0
+ *
+ * Purpose: Spectral layout (Hall): node i is placed at (u[i], v[i]),
+ *          where u and v are eigenvectors of the Laplacian L = D - A
+ *          for its two smallest eigenvalues after 0.  These are the
+ *          smoothest non-constant functions on the graph, so nodes
+ *          joined by an edge end up close together.
+ *
+ * Notes:   The eigenvectors are found with the thick-restart Lanczos
+ *          method, applied to M = cI - L (with c at least the largest
+ *          eigenvalue of L) so that the wanted eigenvectors become the
+ *          ones with the largest eigenvalues.  The constant vector
+ *          (L's eigenvector for 0) is projected out, and each
+ *          eigenvector, once found, is too; this also finds two
+ *          eigenvectors with the same eigenvalue, as symmetric graphs
+ *          like grids have.  Lanczos is slow to separate the small
+ *          eigenvalues of a big graph, so it is first run on the
+ *          coarsest graph of the multilevel layout's hierarchy, and
+ *          each result is the start for the next finer graph.
+ *          Memory is O(SPECTRAL_BASIS * n + m).
+ *          The products with M and the orthogonalization are split
+ *          between threads.
+ */
+
+#include "spectrallayout.h"
+#include "layoutgraph.h"
+#include "multilevellayout.h"
+#include "fastrandom.h"
+
+#include <QVector>
+#include <QtConcurrent/QtConcurrentMap>
+#include <QtMath>
+#include <algorithm>
+
+// The most Lanczos vectors kept at once, and how many of them are
+// carried over a restart.
+#define SPECTRAL_BASIS		32
+#define SPECTRAL_KEEP		8
+
+// Give up improving an eigenvector after this many restarts, or stop
+// when its residual is below SPECTRAL_TOLERANCE times its eigenvalue
+// (as an eigenvalue of L).  The eigenvalues we want are about as far
+// apart as they are from 0, so this bounds the error in direction.
+#define SPECTRAL_RESTARTS	300
+#define SPECTRAL_TOLERANCE	0.05
+
+// The eigenvectors are first found for a coarsened graph of at most
+// this many nodes, then refined on each finer level.
+#define SPECTRAL_COARSEST_NODES	200
+
+// The average edge length of the result, in node diameters.
+#define SPECTRAL_EDGE_LENGTH	4
+
+// The number of nodes handed to one thread at a time.
+#define SPECTRAL_CHUNK_SIZE	4096
+
+#define SPECTRAL_SEED		20261018
+
+
+/*
+ * Name:        shifted_product
+ * Purpose:     Multiplies a vector by M = cI - L.
+ * Arguments:   the graph, c, the chunks, x, and where to put Mx
+ * Output:      none
+ * Modifies:    y
+ * Returns:     none
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       (Mx)[i] = (c - degree(i)) x[i] + sum of x[j] over the
+ *              neighbours j of i.  Each thread works on a range of
+ *              rows.
+ */
+
+static void
+shifted_product(const Multilevel_Level & graph, double c,
+		const QVector<Node_Range> & chunks, const double * x,
+		double * y)
+{
+    const int * offsets = graph.offsets.constData();
+    const int * targets = graph.targets.constData();
+
+    QtConcurrent::blockingMap(chunks, [=](const Node_Range & chunk)
+    {
+	for (int i = chunk.first; i < chunk.second; i++)
+	{
+	    double sum = (c - (offsets[i + 1] - offsets[i])) * x[i];
+	    for (int e = offsets[i]; e < offsets[i + 1]; e++)
+		sum += x[targets[e]];
+	    y[i] = sum;
+	}
+    });
+}
+
+
+/*
+ * Name:        orthogonalize
+ * Purpose:     Removes from w its components along some unit vectors.
+ * Arguments:   the vectors, the chunks, w, and where to add the
+ *              removed components (or nullptr)
+ * Output:      none
+ * Modifies:    w, coefficients
+ * Returns:     none
+ * Assumptions: The vectors are orthonormal.
+ * Bugs:        none
+ * Notes:       Classical Gram-Schmidt, done twice, which is as
+ *              accurate as modified Gram-Schmidt but lets each
+ *              thread work on a range of rows at once.  Each thread
+ *              adds up its share of the dot products separately.
+ */
+
+static void
+orthogonalize(const QVector<const double *> & vectors,
+	      const QVector<Node_Range> & chunks, double * w,
+	      double * coefficients)
+{
+    const int count = vectors.count();
+    if (count == 0)
+	return;
+
+    for (int pass = 0; pass < 2; pass++)
+    {
+	QVector<double> partial(chunks.count() * count, 0);
+	double * sums = partial.data();
+
+	QtConcurrent::blockingMap(chunks, [&](const Node_Range & chunk)
+	{
+	    double * sum = sums + (chunk.first / SPECTRAL_CHUNK_SIZE) * count;
+	    for (int v = 0; v < count; v++)
+	    {
+		const double * vector = vectors.at(v);
+		double dot = 0;
+		for (int i = chunk.first; i < chunk.second; i++)
+		    dot += vector[i] * w[i];
+		sum[v] = dot;
+	    }
+	});
+
+	QVector<double> dots(count, 0);
+	for (int c = 0; c < chunks.count(); c++)
+	    for (int v = 0; v < count; v++)
+		dots[v] += partial.at(c * count + v);
+	if (coefficients != nullptr)
+	    for (int v = 0; v < count; v++)
+		coefficients[v] += dots.at(v);
+
+	QtConcurrent::blockingMap(chunks, [&](const Node_Range & chunk)
+	{
+	    for (int v = 0; v < count; v++)
+	    {
+		const double * vector = vectors.at(v);
+		double dot = dots.at(v);
+		for (int i = chunk.first; i < chunk.second; i++)
+		    w[i] -= dot * vector[i];
+	    }
+	});
+    }
+}
+
+
+/*
+ * Name:        norm
+ * Purpose:     Finds the length of a vector.
+ * Arguments:   the vector and its length
+ * Output:      none
+ * Modifies:    nothing
+ * Returns:     the Euclidean norm
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       none
+ */
+
+static double
+norm(const double * x, int n)
+{
+    double sum = 0;
+
+    for (int i = 0; i < n; i++)
+	sum += x[i] * x[i];
+    return qSqrt(sum);
+}
+
+
+/*
+ * Name:        symmetric_eigen
+ * Purpose:     Finds the eigenvalues and eigenvectors of a small
+ *              symmetric matrix.
+ * Arguments:   the matrix (m x m, row-major), m, and where to put the
+ *              eigenvalues and eigenvectors
+ * Output:      none
+ * Modifies:    values, vectors
+ * Returns:     none
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       Cyclic Jacobi rotations; m is at most SPECTRAL_BASIS,
+ *              so speed doesn't matter.  The eigenvalues are sorted
+ *              largest first, and vectors[r * m + k] is entry r of
+ *              the k-th eigenvector.
+ */
+
+static void
+symmetric_eigen(QVector<double> a, int m, QVector<double> & values,
+		QVector<double> & vectors)
+{
+    vectors.fill(0, m * m);
+    for (int i = 0; i < m; i++)
+	vectors[i * m + i] = 1;
+
+    for (int sweep = 0; sweep < 100; sweep++)
+    {
+	double off = 0;
+	for (int p = 0; p < m; p++)
+	    for (int q = p + 1; q < m; q++)
+		off += a.at(p * m + q) * a.at(p * m + q);
+	if (off < 1e-30)
+	    break;
+
+	for (int p = 0; p < m; p++)
+	    for (int q = p + 1; q < m; q++)
+	    {
+		double apq = a.at(p * m + q);
+		if (qAbs(apq) < 1e-300)
+		    continue;
+		double theta = (a.at(q * m + q) - a.at(p * m + p)) / (2 * apq);
+		double t = (theta >= 0 ? 1 : -1)
+		    / (qAbs(theta) + qSqrt(theta * theta + 1));
+		double cs = 1 / qSqrt(t * t + 1), sn = t * cs;
+
+		for (int k = 0; k < m; k++)
+		{
+		    double akp = a.at(k * m + p), akq = a.at(k * m + q);
+		    a[k * m + p] = cs * akp - sn * akq;
+		    a[k * m + q] = sn * akp + cs * akq;
+		}
+		for (int k = 0; k < m; k++)
+		{
+		    double apk = a.at(p * m + k), aqk = a.at(q * m + k);
+		    a[p * m + k] = cs * apk - sn * aqk;
+		    a[q * m + k] = sn * apk + cs * aqk;
+		}
+		for (int k = 0; k < m; k++)
+		{
+		    double vkp = vectors.at(k * m + p);
+		    double vkq = vectors.at(k * m + q);
+		    vectors[k * m + p] = cs * vkp - sn * vkq;
+		    vectors[k * m + q] = sn * vkp + cs * vkq;
+		}
+	    }
+    }
+
+    // Sort, largest eigenvalue first.
+    QVector<int> order(m);
+    for (int i = 0; i < m; i++)
+	order[i] = i;
+    std::sort(order.begin(), order.end(), [&](int x, int y)
+    {
+	return a.at(x * m + x) > a.at(y * m + y);
+    });
+    QVector<double> sorted(m * m);
+    values.resize(m);
+    for (int k = 0; k < m; k++)
+    {
+	values[k] = a.at(order.at(k) * m + order.at(k));
+	for (int r = 0; r < m; r++)
+	    sorted[r * m + k] = vectors.at(r * m + order.at(k));
+    }
+    vectors = sorted;
+}
+
+
+/*
+ * Name:        lanczos
+ * Purpose:     Finds the eigenvector of M with the largest eigenvalue
+ *              that is orthogonal to some known eigenvectors.
+ * Arguments:   the graph, the LayoutGraph (to check for
+ *              cancellation), c, the known (unit) eigenvectors, a
+ *              vector to start from (or nullptr for a random one),
+ *              the random number generator, and where to put the
+ *              eigenvector
+ * Output:      none
+ * Modifies:    result
+ * Returns:     false if the layout was cancelled
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       Thick-restart Lanczos (Wu and Simon) with full
+ *              reorthogonalization.  The basis grows to SPECTRAL_BASIS
+ *              vectors; the SPECTRAL_KEEP best Ritz vectors, and the
+ *              last residual, then become the start of the next basis.
+ *              The projection of M on the basis is then diagonal
+ *              except for the row and column of the residual, and it
+ *              is rebuilt from the Gram-Schmidt coefficients as the
+ *              basis grows again.
+ */
+
+static bool
+lanczos(const Multilevel_Level & graph, LayoutGraph * owner, double c,
+	const QVector<const double *> & known, const double * initial,
+	FastRandom & random, QVector<double> & result)
+{
+    const int n = graph.numOfNodes;
+    const int m = qMin(SPECTRAL_BASIS, n - known.count());
+    const int keep = qMin(SPECTRAL_KEEP, m - 1);
+    const QVector<Node_Range> chunks
+	= LayoutGraph::chunks(n, SPECTRAL_CHUNK_SIZE);
+    QVector<double> basis((m + 1) * (qint64)n);
+    QVector<double> projection(m * m, 0);
+    QVector<double> values, ritz, coefficients(m + 1);
+    QVector<double> kept(qMax(keep, 1) * (qint64)n);
+    double * v = basis.data();
+    int start = 0;
+
+    // Start from the given vector, made orthogonal to the known ones
+    // (and shaken a little, in case that leaves nothing).
+    for (int i = 0; i < n; i++)
+	v[i] = (initial != nullptr ? initial[i] : 0)
+	    + (random.uniform() - 0.5) * 1e-3;
+    orthogonalize(known, chunks, v, nullptr);
+    double length = norm(v, n);
+    for (int i = 0; i < n; i++)
+	v[i] /= length;
+
+    for (int restart = 0; restart < SPECTRAL_RESTARTS; restart++)
+    {
+	double beta = 0;
+	int size = m;
+
+	for (int j = start; j < m; j++)
+	{
+	    if (owner->isCancelled())
+		return false;
+
+	    double * w = v + (j + 1) * (qint64)n;
+	    shifted_product(graph, c, chunks, v + j * (qint64)n, w);
+	    orthogonalize(known, chunks, w, nullptr);
+
+	    QVector<const double *> previous;
+	    for (int i = 0; i <= j; i++)
+		previous.append(v + i * (qint64)n);
+	    coefficients.fill(0, j + 1);
+	    orthogonalize(previous, chunks, w, coefficients.data());
+	    for (int i = 0; i <= j; i++)
+		projection[i * m + j] = projection[j * m + i]
+		    = coefficients.at(i);
+
+	    beta = norm(w, n);
+	    if (beta < 1e-12 * c)
+	    {
+		// The basis spans an invariant subspace: its Ritz
+		// vectors are exact.
+		size = j + 1;
+		break;
+	    }
+	    for (int i = 0; i < n; i++)
+		w[i] /= beta;
+	}
+
+	QVector<double> small(size * size);
+	for (int i = 0; i < size; i++)
+	    for (int j = 0; j < size; j++)
+		small[i * size + j] = projection.at(i * m + j);
+	symmetric_eigen(small, size, values, ritz);
+
+	// Form the kept Ritz vectors: kept_k = sum_j v_j ritz[j][k].
+	const int count = qMax(qMin(keep, size), 1);
+	double * out = kept.data();
+	QtConcurrent::blockingMap(chunks, [&](const Node_Range & chunk)
+	{
+	    for (int k = 0; k < count; k++)
+		for (int i = chunk.first; i < chunk.second; i++)
+		{
+		    double sum = 0;
+		    for (int j = 0; j < size; j++)
+			sum += v[j * (qint64)n + i] * ritz.at(j * size + k);
+		    out[k * (qint64)n + i] = sum;
+		}
+	});
+
+	double residual = beta * qAbs(ritz.at((size - 1) * size));
+	if (size < m || count >= m
+	    || residual < SPECTRAL_TOLERANCE * (c - values.at(0))
+	    || restart == SPECTRAL_RESTARTS - 1)
+	{
+	    result.resize(n);
+	    std::copy(out, out + n, result.begin());
+	    return true;
+	}
+
+	// Restart from the kept Ritz vectors and the residual.
+	std::copy(v + m * (qint64)n, v + (m + 1) * (qint64)n,
+		  v + count * (qint64)n);
+	std::copy(out, out + count * (qint64)n, v);
+	projection.fill(0, m * m);
+	for (int k = 0; k < count; k++)
+	{
+	    projection[k * m + k] = values.at(k);
+	    projection[k * m + count] = projection[count * m + k]
+		= beta * ritz.at((size - 1) * size + k);
+	}
+	start = count;
+    }
+    return true;
+}
+
+
+/*
+ * Name:        spectral_layout
+ * Purpose:     Lays out a graph by the Laplacian's eigenvectors.
+ * Arguments:   the graph
+ * Output:      none
+ * Modifies:    graph->positions
+ * Returns:     none
+ * Assumptions: none
+ * Bugs:        A disconnected graph has more than one eigenvector for
+ *              0, and all but one of its components may be drawn as
+ *              a single point.
+ * Notes:       The result is scaled so that the average edge is
+ *              SPECTRAL_EDGE_LENGTH node diameters long, and centred
+ *              where the graph was.  It is also a good start for the
+ *              force and stress layouts.
+ */
+
+void
+spectral_layout(LayoutGraph * graph)
+{
+    const int n = graph->nodeCount();
+    if (n < 3)
+	return;
+
+    FastRandom random(SPECTRAL_SEED);
+    QVector<Multilevel_Level> levels;
+    if (!build_levels(graph, SPECTRAL_COARSEST_NODES, random, levels))
+	return;
+
+    // Find the eigenvectors of the coarsest graph from scratch, then
+    // use them (copied to the nodes merged into each coarse node) as
+    // the start for the next finer graph.
+    QVector<double> first, second;
+    for (int l = levels.count() - 1; l >= 0; l--)
+    {
+	const Multilevel_Level & level = levels.at(l);
+	const int size = level.numOfNodes;
+	if (size < 3)
+	    continue;
+
+	// By Gershgorin, L's eigenvalues are at most twice the largest
+	// degree.
+	int largest = 0;
+	for (int i = 0; i < size; i++)
+	    largest = qMax(largest, level.offsets.at(i + 1)
+			   - level.offsets.at(i));
+	const double c = qMax(2 * largest, 1);
+
+	QVector<double> start1, start2;
+	if (first.count() > 0)
+	{
+	    start1.resize(size);
+	    start2.resize(size);
+	    for (int i = 0; i < size; i++)
+	    {
+		start1[i] = first.at(level.parent.at(i));
+		start2[i] = second.at(level.parent.at(i));
+	    }
+	}
+
+	QVector<double> constant(size, 1 / qSqrt((double)size));
+	QVector<const double *> known;
+	known.append(constant.constData());
+	if (!lanczos(level, graph, c, known,
+		     start1.isEmpty() ? nullptr : start1.constData(),
+		     random, first))
+	    return;
+	known.append(first.constData());
+	if (!lanczos(level, graph, c, known,
+		     start2.isEmpty() ? nullptr : start2.constData(),
+		     random, second))
+	    return;
+    }
+    if (first.count() != n)
+	return;
+
+    const QPointF centre = graph->centre();
+    for (int i = 0; i < n; i++)
+	graph->positions[i] = QPointF(first.at(i), second.at(i));
+    graph->scaleEdgesTo(SPECTRAL_EDGE_LENGTH * graph->nodeSize);
+    graph->moveCentreTo(centre);
+}
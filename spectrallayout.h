@@ -0,0 +1,17 @@
+/*
+ * File:	spectrallayout.h
+ * Date:	2026/10/18
+ * Version:	1.0
+ *
+ * Purpose:	Declares the spectral layout, which places the nodes by
+ *		the eigenvectors of the graph's Laplacian.
+ */
+
+#ifndef SPECTRALLAYOUT_H
+#define SPECTRALLAYOUT_H
+
+class LayoutGraph;
+
+void spectral_layout(LayoutGraph * graph);
+
+#endif // SPECTRALLAYOUT_H
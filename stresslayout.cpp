@@ -0,0 +1,410 @@
+/*
+ * File:    stresslayout.cpp
+ * Date:    2026/10/18
+ * Version: 1.0
+ *
+ * Purpose: The sparse stress model of Ortmann, Klimenta and Brandes.
+ *          Full stress majorization wants the graph distance between
+ *          every pair of nodes, which takes O(n^2) time and memory.
+ *          Instead, BFS is run (in parallel) from STRESS_PIVOTS
+ *          randomly chosen pivots only, and each node is pulled
+ *          towards its graph distance from its neighbours and from
+ *          every pivot.  A pivot stands in for the nodes nearer to it
+ *          than to any other pivot, so its pull is weighted by how
+ *          many of them it represents.
+ *
+ * Notes:   The layout starts from the pivot MDS of the same distances
+ *          (Brandes and Pich), which already has the right overall
+ *          shape, and is then improved by localized stress
+ *          majorization.  Memory is O(STRESS_PIVOTS * n + m).
+ */
+
+#include "stresslayout.h"
+#include "layoutgraph.h"
+#include "fastrandom.h"
+
+#include <QElapsedTimer>
+#include <QVector>
+#include <QtConcurrent/QtConcurrentMap>
+#include <QtMath>
+#include <algorithm>
+
+// The number of nodes BFS is run from.
+#define STRESS_PIVOTS		50
+
+// The ideal length of an edge, in node diameters.
+#define STRESS_EDGE_LENGTH	4
+
+// The most majorization iterations; the layout stops sooner once the
+// average node moves less than STRESS_TOLERANCE edge lengths.
+#define STRESS_ITERATIONS	200
+#define STRESS_TOLERANCE	0.001
+
+// Power iterations used to find each pivot MDS axis.
+#define STRESS_POWER_ITERATIONS	200
+
+// The number of nodes handed to one thread at a time.
+#define STRESS_CHUNK_SIZE	1024
+
+// Time (in ms) between two calls of publish() during a layout.
+#define STRESS_PUBLISH_INTERVAL	50
+
+#define STRESS_SEED		20261018
+
+
+/*
+ * Name:        breadth_first
+ * Purpose:     Finds the distance (in edges) of every node from one.
+ * Arguments:   the graph, the node, and where to put the distances
+ * Output:      none
+ * Modifies:    distances[0 .. n)
+ * Returns:     none
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       Nodes that can't be reached get -1.
+ */
+
+static void
+breadth_first(const LayoutGraph * graph, int source, int * distances)
+{
+    const int n = graph->nodeCount();
+    QVector<int> queue(n);
+    int head = 0, tail = 0;
+
+    std::fill(distances, distances + n, -1);
+    distances[source] = 0;
+    queue[tail++] = source;
+    while (head < tail)
+    {
+	int u = queue.at(head++);
+	const int * next = graph->neighbours(u);
+	for (int e = graph->degree(u) - 1; e >= 0; e--)
+	    if (distances[next[e]] < 0)
+	    {
+		distances[next[e]] = distances[u] + 1;
+		queue[tail++] = next[e];
+	    }
+    }
+}
+
+
+/*
+ * Name:        pivot_mds_axis
+ * Purpose:     Finds the top eigenvector of a small symmetric matrix.
+ * Arguments:   the k x k matrix, k, an axis to stay orthogonal to
+ *              (or nullptr), and where to put the eigenvector
+ * Output:      none
+ * Modifies:    axis
+ * Returns:     none
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       Power iteration, from a fixed start so that the layout
+ *              is the same every time.
+ */
+
+static void
+pivot_mds_axis(const QVector<double> & matrix, int k,
+	       const QVector<double> * other, QVector<double> & axis)
+{
+    QVector<double> next(k);
+
+    axis.resize(k);
+    for (int p = 0; p < k; p++)
+	axis[p] = 1 + (p % 7) * 0.1 + (p % 3) * 0.01;
+
+    for (int iteration = 0; iteration < STRESS_POWER_ITERATIONS; iteration++)
+    {
+	if (other != nullptr)
+	{
+	    double dot = 0;
+	    for (int p = 0; p < k; p++)
+		dot += axis.at(p) * other->at(p);
+	    for (int p = 0; p < k; p++)
+		axis[p] -= dot * other->at(p);
+	}
+
+	double length = 0;
+	for (int p = 0; p < k; p++)
+	{
+	    double sum = 0;
+	    for (int q = 0; q < k; q++)
+		sum += matrix.at(p * k + q) * axis.at(q);
+	    next[p] = sum;
+	    length += sum * sum;
+	}
+	length = qSqrt(length);
+	if (length < 1e-12)
+	    return;
+	for (int p = 0; p < k; p++)
+	    axis[p] = next.at(p) / length;
+    }
+}
+
+
+/*
+ * Name:        pivot_mds
+ * Purpose:     Places the nodes by pivot MDS.
+ * Arguments:   the distances from each pivot (pivot-major), the
+ *              number of pivots and nodes, and where to put the
+ *              positions
+ * Output:      none
+ * Modifies:    positions
+ * Returns:     none
+ * Assumptions: Unreachable nodes have been given a finite distance.
+ * Bugs:        none
+ * Notes:       C is the double-centred matrix of squared distances
+ *              (n x k); the nodes are placed at C times the top two
+ *              eigenvectors of C^T C.  C is never stored: each column
+ *              is worked out when needed from the distances and the
+ *              row and column means.  The result is in units of
+ *              edges; the caller scales it.
+ */
+
+static void
+pivot_mds(const QVector<int> & distances, int k, int n,
+	  QPointF * positions)
+{
+    QVector<double> pivotMeans(k, 0), nodeMeans(n, 0);
+    double grandMean = 0;
+
+    for (int p = 0; p < k; p++)
+	for (int i = 0; i < n; i++)
+	{
+	    double d = distances.at(p * n + i);
+	    pivotMeans[p] += d * d / n;
+	    nodeMeans[i] += d * d / k;
+	}
+    for (int p = 0; p < k; p++)
+	grandMean += pivotMeans.at(p) / k;
+
+    auto centred = [&](int p, int i)
+    {
+	double d = distances.at(p * n + i);
+	return -0.5 * (d * d - pivotMeans.at(p) - nodeMeans.at(i)
+		       + grandMean);
+    };
+
+    // C^T C, summed over the nodes in parallel.
+    QVector<Node_Range> chunks = LayoutGraph::chunks(n, STRESS_CHUNK_SIZE);
+    QVector<QVector<double> > partial(chunks.count());
+    QVector<double> * sums = partial.data();
+    QtConcurrent::blockingMap(chunks, [&](const Node_Range & chunk)
+    {
+	QVector<double> sum(k * k, 0);
+	QVector<double> column(k);
+	for (int i = chunk.first; i < chunk.second; i++)
+	{
+	    for (int p = 0; p < k; p++)
+		column[p] = centred(p, i);
+	    for (int p = 0; p < k; p++)
+		for (int q = p; q < k; q++)
+		    sum[p * k + q] += column.at(p) * column.at(q);
+	}
+	sums[chunk.first / STRESS_CHUNK_SIZE] = sum;
+    });
+
+    QVector<double> product(k * k, 0);
+    foreach (const QVector<double> & sum, partial)
+	for (int p = 0; p < k; p++)
+	    for (int q = p; q < k; q++)
+		product[p * k + q] += sum.at(p * k + q);
+    for (int p = 0; p < k; p++)
+	for (int q = 0; q < p; q++)
+	    product[p * k + q] = product.at(q * k + p);
+
+    QVector<double> first, second;
+    pivot_mds_axis(product, k, nullptr, first);
+    pivot_mds_axis(product, k, &first, second);
+
+    QtConcurrent::blockingMap(chunks, [&](const Node_Range & chunk)
+    {
+	for (int i = chunk.first; i < chunk.second; i++)
+	{
+	    double x = 0, y = 0;
+	    for (int p = 0; p < k; p++)
+	    {
+		double c = centred(p, i);
+		x += c * first.at(p);
+		y += c * second.at(p);
+	    }
+	    positions[i] = QPointF(x, y);
+	}
+    });
+}
+
+
+/*
+ * Name:        stress_layout
+ * Purpose:     Lays out a graph by sparse stress majorization.
+ * Arguments:   the graph
+ * Output:      none
+ * Modifies:    graph->positions
+ * Returns:     none
+ * Assumptions: none
+ * Bugs:        Nodes in a component with no pivot are only pulled by
+ *              their neighbours, so such components may overlap the
+ *              others.  Nothing pushes apart leaves with the same
+ *              neighbour, since they are the same distance from
+ *              everything; they may end up on top of each other.
+ * Notes:       Each iteration moves every node i to
+ *                  sum_j w_ij (x_j + d_ij (x_i - x_j) / |x_i - x_j|)
+ *                  / sum_j w_ij,
+ *              where j runs over i's neighbours (d = 1, w = 1) and
+ *              the pivots p (d = d(i, p), w = s / d^2, s being the
+ *              number of nodes that p stands in for that are no
+ *              further than d / 2 from p).  All the nodes move at once,
+ *              from the previous positions, so the work can be split
+ *              between threads.  The result, and everything published
+ *              on the way or left by a cancel, is centred where the
+ *              graph was.
+ */
+
+void
+stress_layout(LayoutGraph * graph)
+{
+    const int n = graph->nodeCount();
+    if (n < 2)
+	return;
+
+    const int k = qMin(STRESS_PIVOTS, n);
+    const qreal unit = STRESS_EDGE_LENGTH * graph->nodeSize;
+    QVector<int> pivots(n);
+    QVector<int> distances(k * n);
+    const QPointF centre = graph->centre();
+
+    // Choose the pivots at random, and find the distances from them.
+    FastRandom random(STRESS_SEED);
+    for (int i = 0; i < n; i++)
+	pivots[i] = i;
+    for (int p = 0; p < k; p++)
+	qSwap(pivots[p], pivots[p + random.below(n - p)]);
+    pivots.resize(k);
+
+    QVector<int> rows(k);
+    for (int p = 0; p < k; p++)
+	rows[p] = p;
+    QtConcurrent::blockingMap(rows, [&](const int & p)
+    {
+	breadth_first(graph, pivots.at(p), distances.data() + p * n);
+    });
+    if (graph->isCancelled())
+	return;
+
+    // Each node is represented by its nearest pivot; count how many
+    // nodes each pivot represents at each distance.
+    int farthest = 0;
+    for (int d = 0; d < distances.count(); d++)
+	farthest = qMax(farthest, distances.at(d));
+    QVector<int> represented(k * (farthest + 1), 0);
+    for (int i = 0; i < n; i++)
+    {
+	int nearest = -1;
+	for (int p = 0; p < k; p++)
+	{
+	    int d = distances.at(p * n + i);
+	    if (d >= 0 && (nearest < 0
+			   || d < distances.at(nearest * n + i)))
+		nearest = p;
+	}
+	if (nearest >= 0)
+	    represented[nearest * (farthest + 1)
+			+ distances.at(nearest * n + i)]++;
+    }
+    for (int p = 0; p < k; p++)
+	for (int d = 1; d <= farthest; d++)
+	    represented[p * (farthest + 1) + d]
+		+= represented.at(p * (farthest + 1) + d - 1);
+
+    // Start from pivot MDS, treating unreachable nodes as just beyond
+    // the farthest reachable one.
+    QVector<int> finite = distances;
+    for (int d = 0; d < finite.count(); d++)
+	if (finite.at(d) < 0)
+	    finite[d] = farthest + 1;
+    QPointF * positions = graph->positions.data();
+    pivot_mds(finite, k, n, positions);
+    finite.clear();
+
+    // Scale the MDS layout so that the average edge is one unit long.
+    // Nodes the MDS put on top of each other are spread a little.
+    graph->scaleEdgesTo(unit);
+    for (int i = 0; i < n; i++)
+    {
+	qreal angle = i * 2.39996322972865332;
+	positions[i] += QPointF(qCos(angle), qSin(angle)) * (unit * 1e-3);
+    }
+    graph->moveCentreTo(centre);
+    graph->publish();
+
+    QVector<QPointF> moved(n);
+    QVector<Node_Range> chunks = LayoutGraph::chunks(n, STRESS_CHUNK_SIZE);
+    QVector<qreal> movement(chunks.count());
+    QPointF * out = moved.data();
+    qreal * moves = movement.data();
+    QElapsedTimer clock;
+    clock.start();
+
+    for (int iteration = 0; iteration < STRESS_ITERATIONS; iteration++)
+    {
+	if (graph->isCancelled())
+	    break;
+
+	QtConcurrent::blockingMap(chunks, [&](const Node_Range & chunk)
+	{
+	    qreal distance = 0;
+	    for (int i = chunk.first; i < chunk.second; i++)
+	    {
+		const QPointF p = positions[i];
+		QPointF sum;
+		qreal weights = 0;
+
+		// Adds the term for a node wanting to be d units away.
+		auto pull = [&](const QPointF & other, qreal d, qreal w)
+		{
+		    QPointF away = p - other;
+		    qreal length = qSqrt(away.x() * away.x()
+					 + away.y() * away.y());
+		    if (length > 0)
+			sum += (other + away * (d * unit / length)) * w;
+		    else
+			sum += other * w;
+		    weights += w;
+		};
+
+		const int * next = graph->neighbours(i);
+		for (int e = graph->degree(i) - 1; e >= 0; e--)
+		    pull(positions[next[e]], 1, 1);
+		for (int q = 0; q < k; q++)
+		{
+		    int d = distances.at(q * n + i);
+		    if (d <= 0)
+			continue;
+		    int s = represented.at(q * (farthest + 1) + d / 2);
+		    pull(positions[pivots.at(q)], d, (qreal)s / (d * d));
+		}
+
+		out[i] = weights > 0 ? sum / weights : p;
+		QPointF step = out[i] - p;
+		distance += qSqrt(step.x() * step.x() + step.y() * step.y());
+	    }
+	    moves[chunk.first / STRESS_CHUNK_SIZE] = distance;
+	});
+
+	std::copy(moved.constBegin(), moved.constEnd(), positions);
+	if (clock.elapsed() >= STRESS_PUBLISH_INTERVAL)
+	{
+	    graph->moveCentreTo(centre);
+	    graph->publish();
+	    clock.restart();
+	}
+
+	qreal distance = 0;
+	foreach (qreal d, movement)
+	    distance += d;
+	if (distance < STRESS_TOLERANCE * unit * n)
+	    break;
+    }
+
+    // Put the result where the graph was.
+    graph->moveCentreTo(centre);
+}
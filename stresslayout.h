@@ -0,0 +1,18 @@
+/*
+ * File:	stresslayout.h
+ * Date:	2026/10/18
+ * Version:	1.0
+ *
+ * Purpose:	Declares the sparse stress-majorization layout, which
+ *		places nodes so that their distances on the canvas match
+ *		their distances in the graph.
+ */
+
+#ifndef STRESSLAYOUT_H
+#define STRESSLAYOUT_H
+
+class LayoutGraph;
+
+void stress_layout(LayoutGraph * graph);
+
+#endif // STRESSLAYOUT_H
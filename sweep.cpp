@@ -0,0 +1,621 @@
+/*
+ * File:    sweep.cpp
+ * Date:    2026/10/18
+ * Version: 1.0
+ *
+ * Purpose: Generates a whole family of basic graphs and exports each
+ *          one to its own file(s), without opening a window:
+ *
+ *            Graphic --sweep TYPE COUNTS [COUNTS2] [options]
+ *
+ *          TYPE is a graph type as named in the graph type menu,
+ *          ignoring case, spaces and punctuation ("wheel", "grid",
+ *          "dutchwindmill", "randomerdosrenyi").  COUNTS is a
+ *          number N, a range A..B or a range with a step A..B:S;
+ *          types that use a second number (such as grids) need a
+ *          second range COUNTS2.
+ *          The options are
+ *            --format F[,F...]  grphc (the default), edges, tikz, svg
+ *                               or any image format Qt can write
+ *            --out DIRECTORY    where to put the files (default ".")
+ *            --size INCHES      the height and width of each graph
+ *            --node-size INCHES the diameter of the nodes
+ *          For example
+ *            Graphic --sweep wheel 3..200 --format tikz,svg --out w
+ *            Graphic --sweep grid 2..100 2..100 --format png
+ *
+ * Notes:   The graphs are generated and written in parallel, one
+ *          graph per task.  Each file is written under a temporary
+ *          name and renamed when it is complete, and files that
+ *          already exist are not made again, so an interrupted sweep
+ *          can just be re-run.
+ *          Everything is done from GraphDescriptions (no
+ *          QGraphicsItems), with the style of a newly generated graph
+ *          in the main window: white nodes with black outlines, black
+ *          edges, no labels.
+ */
+
+#include "sweep.h"
+#include "basicgraphs.h"
+#include "graphdescription.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QImage>
+#include <QImageWriter>
+#include <QPainter>
+#include <QTextStream>
+#include <QtConcurrent/QtConcurrentMap>
+#include <QtSvg/QSvgGenerator>
+
+// Pixels per inch of the node positions, as the preview would have on
+// a typical screen.
+#define SWEEP_DPI		96
+
+// The defaults of the graph size, node size and edge width spin boxes.
+#define SWEEP_GRAPH_SIZE	2.5
+#define SWEEP_NODE_SIZE		0.2
+#define SWEEP_PEN_WIDTH		1
+
+// Precision of the positions and widths in TikZ output (as in
+// MainWindow::save_Graph()).
+#define SWEEP_PREC_TIKZ		4
+
+// Added to the name of a file while it is being written.
+#define PARTIAL_SUFFIX		".part"
+
+// A range of node counts: first, first + step, ..., up to last.
+typedef struct sRange
+{
+    int first;
+    int last;
+    int step;
+} Sweep_Range;
+
+// One graph of the sweep.
+typedef struct sJob
+{
+    int type;
+    int topNodes;
+    int bottomNodes;
+    QString baseName;		// The path of its files, less extensions.
+    QStringList written;	// The formats written by this run.
+    QString error;
+} Sweep_Job;
+
+// The settings shared by all of the jobs.
+typedef struct sSettings
+{
+    QStringList formats;
+    qreal graphSize;		// Inches.
+    qreal nodeSize;		// Inches.
+} Sweep_Settings;
+
+
+/*
+ * Name:	type_key
+ * Purpose:	Reduces a graph type name to lower case letters and
+ *		digits, so that it can be typed on a command line.
+ * Arguments:	the name
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	The key.
+ * Assumptions:	none
+ * Bugs:
+ * Notes:	"Gear (generalized)" becomes "geargeneralized"; the
+ *		word in parentheses may also be left off.
+ */
+
+static QString
+type_key(const QString & name)
+{
+    QString key;
+
+    foreach (QChar c, name.toLower())
+	if (c.isLetterOrNumber())
+	    key += c;
+    return key;
+}
+
+
+/*
+ * Name:	find_type
+ * Purpose:	Finds the Graph_Type a command line argument names.
+ * Arguments:	the argument
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	The Graph_Type, or 0 if there is none.
+ * Assumptions:	none
+ * Bugs:
+ * Notes:	none
+ */
+
+static int
+find_type(const QString & arg)
+{
+    BasicGraphs graphs;
+    QString key = type_key(arg);
+
+    for (int type = 1; type < BasicGraphs::Count; type++)
+    {
+	QString name = graphs.getGraphName(type);
+	if (type_key(name) == key
+	    || type_key(name.section('(', 0, 0)) == key)
+	    return type;
+    }
+    return 0;
+}
+
+
+/*
+ * Name:	uses_second_count
+ * Purpose:	Tells whether a graph type uses the second number.
+ * Arguments:	the Graph_Type
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	bool
+ * Assumptions:	none
+ * Bugs:
+ * Notes:	These are the types for which the main window shows the
+ *		second spin box.
+ */
+
+static bool
+uses_second_count(int type)
+{
+    switch (type)
+    {
+      case BasicGraphs::Bipartite:
+      case BasicGraphs::Grid:
+      case BasicGraphs::KTree:
+      case BasicGraphs::Petersen:
+      case BasicGraphs::RandomBA:
+      case BasicGraphs::RandomER:
+      case BasicGraphs::RandomGeometric:
+      case BasicGraphs::RandomRegular:
+      case BasicGraphs::Windmill:
+	return true;
+      default:
+	return false;
+    }
+}
+
+
+/*
+ * Name:	parse_range
+ * Purpose:	Reads a range of node counts.
+ * Arguments:	"N", "A..B" or "A..B:S", and where to put the range
+ * Outputs:	Nothing.
+ * Modifies:	*range
+ * Returns:	false if the argument is not a valid range
+ * Assumptions:	none
+ * Bugs:
+ * Notes:	none
+ */
+
+static bool
+parse_range(const QString & arg, Sweep_Range * range)
+{
+    bool ok1 = true, ok2 = true, ok3 = true;
+    QString counts = arg.section(':', 0, 0);
+
+    range->first = counts.section("..", 0, 0).toInt(&ok1);
+    range->last = counts.contains("..")
+	? counts.section("..", 1, 1).toInt(&ok2) : range->first;
+    range->step = arg.contains(':') ? arg.section(':', 1, 1).toInt(&ok3) : 1;
+
+    return ok1 && ok2 && ok3 && range->step > 0
+	&& range->first >= 0 && range->first <= range->last;
+}
+
+
+/*
+ * Name:	write_grphc
+ * Purpose:	Writes a description in the .grphc format.
+ * Arguments:	the stream, the description and the settings
+ * Outputs:	The graph.
+ * Modifies:	Nothing.
+ * Returns:	Nothing.
+ * Assumptions:	none
+ * Bugs:
+ * Notes:	Same layout as MainWindow::save_Graph(): the number of
+ *		nodes, a line per node (position, diameter, rotation,
+ *		fill and outline colours), then a line per edge (the
+ *		nodes, their radii, rotation, width and colour).
+ */
+
+static void
+write_grphc(QTextStream & out, const GraphDescription & desc,
+	    const Sweep_Settings & settings)
+{
+    QString node = "," + QString::number(settings.nodeSize)
+	+ ",0,1,1,1,0,0,0\n";
+    QString edge = "," + QString::number(settings.nodeSize / 2.)
+	+ "," + QString::number(settings.nodeSize / 2.)
+	+ ",0," + QString::number(SWEEP_PEN_WIDTH) + ",0,0,0\n";
+
+    out << desc.nodeCount() << "\n";
+    foreach (const QPointF & p, desc.positions)
+	out << p.x() << "," << p.y() << node;
+    foreach (const Description_Edge & e, desc.edges)
+	out << qMin(e.source, e.dest) << "," << qMax(e.source, e.dest)
+	    << edge;
+}
+
+
+/*
+ * Name:	write_edges
+ * Purpose:	Writes a description as an edge list.
+ * Arguments:	the stream and the description
+ * Outputs:	The graph.
+ * Modifies:	Nothing.
+ * Returns:	Nothing.
+ * Assumptions:	none
+ * Bugs:
+ * Notes:	The number of nodes, then one "a,b" line per edge.
+ */
+
+static void
+write_edges(QTextStream & out, const GraphDescription & desc)
+{
+    out << desc.nodeCount() << "\n";
+    foreach (const Description_Edge & e, desc.edges)
+	out << qMin(e.source, e.dest) << "," << qMax(e.source, e.dest)
+	    << "\n";
+}
+
+
+/*
+ * Name:	write_tikz
+ * Purpose:	Writes a description as a TikZ picture.
+ * Arguments:	the stream, the description and the settings
+ * Outputs:	The graph.
+ * Modifies:	Nothing.
+ * Returns:	Nothing.
+ * Assumptions:	none
+ * Bugs:
+ * Notes:	As MainWindow::save_Graph() writes it, except that
+ *		since every node (and every edge) looks the same, each
+ *		colour is only defined once.
+ */
+
+static void
+write_tikz(QTextStream & out, const GraphDescription & desc,
+	   const Sweep_Settings & settings)
+{
+    out << "\\begin{tikzpicture} [x=1in, y=1in, xscale=1, yscale=1]\n"
+	<< "\\definecolor{nodeFillColour} {RGB} {255,255,255}\n"
+	<< "\\definecolor{nodeLineColour}{RGB}{0,0,0}\n"
+	<< "\\definecolor{edgeColour}{RGB}{0,0,0}\n";
+
+    QString style = ") [scale=1, inner sep=0,\n\tshape=circle, minimum size="
+	+ QString::number(settings.nodeSize)
+	+ "in,\n\tfill=nodeFillColour, draw=nodeLineColour] {$$};\n";
+    for (int i = 0; i < desc.nodeCount(); i++)
+    {
+	const QPointF & p = desc.positions.at(i);
+	out << "\\node (v" << i << ") at ("
+	    << QString::number(p.x() / SWEEP_DPI, 'f', SWEEP_PREC_TIKZ) << ","
+	    << QString::number(p.y() / -SWEEP_DPI, 'f', SWEEP_PREC_TIKZ)
+	    << style;
+    }
+
+    QString edge = ") edge[draw=edgeColour, line width="
+	+ QString::number((qreal)SWEEP_PEN_WIDTH / SWEEP_DPI, 'f',
+			  SWEEP_PREC_TIKZ)
+	+ "in]\n\tnode[] {$$} (v";
+    foreach (const Description_Edge & e, desc.edges)
+	out << "\\path (v" << e.source << edge << e.dest << ");\n";
+
+    out << "\\end{tikzpicture}";
+}
+
+
+/*
+ * Name:	draw_description
+ * Purpose:	Draws a description.
+ * Arguments:	the painter, the description, the settings and the
+ *		area of the description to draw
+ * Outputs:	The graph.
+ * Modifies:	the painter's device
+ * Returns:	Nothing.
+ * Assumptions:	The painter's device is bounds.size() big.
+ * Bugs:
+ * Notes:	Edges, then nodes on top of them.
+ */
+
+static void
+draw_description(QPainter * painter, const GraphDescription & desc,
+		 const Sweep_Settings & settings, const QRectF & bounds)
+{
+    qreal radius = settings.nodeSize * SWEEP_DPI / 2.;
+    QVector<QLineF> lines;
+
+    painter->setRenderHints(QPainter::Antialiasing, true);
+    painter->translate(-bounds.topLeft());
+    painter->setPen(QPen(Qt::black, SWEEP_PEN_WIDTH));
+
+    lines.reserve(desc.edgeCount());
+    foreach (const Description_Edge & e, desc.edges)
+	lines.append(QLineF(desc.positions.at(e.source),
+			    desc.positions.at(e.dest)));
+    painter->drawLines(lines);
+
+    painter->setBrush(Qt::white);
+    foreach (const QPointF & p, desc.positions)
+	painter->drawEllipse(p, radius, radius);
+}
+
+
+/*
+ * Name:	write_picture
+ * Purpose:	Writes a description as an SVG file or an image.
+ * Arguments:	the file name, the format, the description and the
+ *		settings
+ * Outputs:	The graph.
+ * Modifies:	Nothing.
+ * Returns:	true if the file was written
+ * Assumptions:	none
+ * Bugs:
+ * Notes:	Images have a transparent background, as those saved
+ *		from the main window do.
+ */
+
+static bool
+write_picture(const QString & fileName, const QString & format,
+	      const GraphDescription & desc, const Sweep_Settings & settings)
+{
+    qreal margin = settings.nodeSize * SWEEP_DPI / 2. + SWEEP_PEN_WIDTH;
+    qreal left = 0, right = 0, top = 0, bottom = 0;
+
+    for (int i = 0; i < desc.nodeCount(); i++)
+    {
+	const QPointF & p = desc.positions.at(i);
+	left = i == 0 ? p.x() : qMin(left, p.x());
+	right = i == 0 ? p.x() : qMax(right, p.x());
+	top = i == 0 ? p.y() : qMin(top, p.y());
+	bottom = i == 0 ? p.y() : qMax(bottom, p.y());
+    }
+    QRectF bounds = QRectF(QPointF(left, top), QPointF(right, bottom))
+	.adjusted(-margin, -margin, margin, margin);
+    QSize size = bounds.size().toSize();
+
+    if (format == "svg")
+    {
+	QSvgGenerator svg;
+	svg.setFileName(fileName);
+	svg.setSize(size);
+	svg.setViewBox(QRect(QPoint(0, 0), size));
+	QPainter painter;
+	if (!painter.begin(&svg))
+	    return false;
+	draw_description(&painter, desc, settings, bounds);
+	return painter.end();
+    }
+
+    QImage image(size, QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::transparent);
+    QPainter painter(&image);
+    draw_description(&painter, desc, settings, bounds);
+    painter.end();
+    return image.save(fileName, format.toLatin1().constData());
+}
+
+
+/*
+ * Name:	run_job
+ * Purpose:	Generates one graph of the sweep and writes its files.
+ * Arguments:	the job and the settings
+ * Outputs:	The files that don't exist yet.
+ * Modifies:	job.written, job.error
+ * Returns:	Nothing.
+ * Assumptions:	none
+ * Bugs:
+ * Notes:	Run on a worker thread.  The graph is only generated if
+ *		at least one of its files is missing.
+ */
+
+static void
+run_job(Sweep_Job & job, const Sweep_Settings & settings)
+{
+    QStringList missing;
+
+    foreach (const QString & format, settings.formats)
+	if (!QFileInfo::exists(job.baseName + "." + format))
+	    missing.append(format);
+    if (missing.isEmpty())
+	return;
+
+    qreal size = (settings.graphSize - settings.nodeSize) * SWEEP_DPI;
+    GraphDescription desc;
+    BasicGraphs().generate(&desc, job.type, job.topNodes, job.bottomNodes,
+			   size, size, true);
+    desc.expandImplicitEdges();
+
+    foreach (const QString & format, missing)
+    {
+	QString fileName = job.baseName + "." + format;
+	QString partName = fileName + PARTIAL_SUFFIX;
+	bool ok = true;
+
+	if (format == "grphc" || format == "edges" || format == "tikz")
+	{
+	    QFile file(partName);
+	    ok = file.open(QIODevice::WriteOnly);
+	    if (ok)
+	    {
+		QTextStream out(&file);
+		if (format == "grphc")
+		    write_grphc(out, desc, settings);
+		else if (format == "edges")
+		    write_edges(out, desc);
+		else
+		    write_tikz(out, desc, settings);
+		out.flush();
+		ok = out.status() == QTextStream::Ok;
+		file.close();
+	    }
+	}
+	else
+	    ok = write_picture(partName, format, desc, settings);
+
+	if (ok)
+	    ok = QFile::rename(partName, fileName);
+	if (!ok)
+	{
+	    QFile::remove(partName);
+	    job.error = "unable to write " + fileName;
+	    return;
+	}
+	job.written.append(format);
+    }
+}
+
+
+/*
+ * Name:	usage
+ * Purpose:	Prints how to use --sweep.
+ * Arguments:	the output stream
+ * Outputs:	The usage message and the list of graph types.
+ * Modifies:	Nothing.
+ * Returns:	1, the exit status for bad arguments.
+ * Assumptions:	none
+ * Bugs:
+ * Notes:	none
+ */
+
+static int
+usage(QTextStream & out)
+{
+    BasicGraphs graphs;
+
+    out << "Usage: Graphic --sweep TYPE COUNTS [COUNTS2] [--format F,...]"
+	<< " [--out DIRECTORY]\n"
+	<< "                       [--size INCHES] [--node-size INCHES]\n"
+	<< "COUNTS is N, A..B or A..B:STEP.  Formats: grphc, edges, tikz,"
+	<< " svg, or an image format.\n"
+	<< "Types:";
+    for (int type = 1; type < BasicGraphs::Count; type++)
+	out << " " << type_key(graphs.getGraphName(type));
+    out << endl;
+    return 1;
+}
+
+
+/*
+ * Name:	run_sweep
+ * Purpose:	Runs a sweep.
+ * Arguments:	the command line arguments following "--sweep"
+ * Outputs:	The files, and a line for each graph on stdout.
+ * Modifies:	Nothing.
+ * Returns:	An exit status (0 = success).
+ * Assumptions:	none
+ * Bugs:
+ * Notes:	See the top of this file.
+ */
+
+int
+run_sweep(const QStringList & args)
+{
+    QTextStream out(stdout);
+    QStringList positional;
+    Sweep_Settings settings;
+    QString directory = ".";
+    bool ok = true;
+
+    settings.formats << "grphc";
+    settings.graphSize = SWEEP_GRAPH_SIZE;
+    settings.nodeSize = SWEEP_NODE_SIZE;
+
+    for (int i = 0; i < args.count(); i++)
+    {
+	QString arg = args.at(i);
+	if (!arg.startsWith("--"))
+	{
+	    positional.append(arg);
+	    continue;
+	}
+	if (i + 1 >= args.count())
+	    return usage(out);
+
+	QString value = args.at(++i);
+	if (arg == "--format")
+	    settings.formats = value.toLower().split(',',
+						     QString::SkipEmptyParts);
+	else if (arg == "--out")
+	    directory = value;
+	else if (arg == "--size")
+	    settings.graphSize = value.toDouble(&ok);
+	else if (arg == "--node-size")
+	    settings.nodeSize = value.toDouble(&ok);
+	else
+	    return usage(out);
+	if (!ok)
+	    return usage(out);
+    }
+
+    int type = positional.isEmpty() ? 0 : find_type(positional.at(0));
+    Sweep_Range top, bottom = {0, 0, 1};
+    if (type == 0 || positional.count() < 2
+	|| positional.count() != (uses_second_count(type) ? 3 : 2)
+	|| !parse_range(positional.at(1), &top)
+	|| (positional.count() == 3 && !parse_range(positional.at(2), &bottom))
+	|| settings.formats.isEmpty())
+	return usage(out);
+
+    QList<QByteArray> images = QImageWriter::supportedImageFormats();
+    foreach (const QString & format, settings.formats)
+	if (format != "grphc" && format != "edges" && format != "tikz"
+	    && format != "svg" && !images.contains(format.toLatin1()))
+	{
+	    out << "Unknown format " << format << endl;
+	    return usage(out);
+	}
+
+    if (!QDir().mkpath(directory))
+    {
+	out << "Unable to create " << directory << endl;
+	return 1;
+    }
+
+    QString prefix = QDir(directory).filePath(
+	type_key(BasicGraphs().getGraphName(type)));
+    QVector<Sweep_Job> jobs;
+    for (int t = top.first; t <= top.last; t += top.step)
+	for (int b = bottom.first; b <= bottom.last; b += bottom.step)
+	{
+	    Sweep_Job job;
+	    job.type = type;
+	    job.topNodes = t;
+	    job.bottomNodes = b;
+	    job.baseName = prefix + "-" + QString::number(t);
+	    if (uses_second_count(type))
+		job.baseName += "-" + QString::number(b);
+	    jobs.append(job);
+	}
+
+    QtConcurrent::blockingMap(jobs, [&](Sweep_Job & job)
+    {
+	run_job(job, settings);
+    });
+
+    int failed = 0, skipped = 0;
+    foreach (const Sweep_Job & job, jobs)
+    {
+	QString name = QFileInfo(job.baseName).fileName();
+	if (!job.error.isEmpty())
+	{
+	    out << name << ": " << job.error << endl;
+	    failed++;
+	}
+	else if (job.written.isEmpty())
+	    skipped++;
+	else
+	    out << name << ": " << job.written.join(", ") << endl;
+    }
+    out << jobs.count() << " graphs, " << skipped << " already done, "
+	<< failed << " failed" << endl;
+
+    return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,17 @@
+/*
+ * File:	sweep.h
+ * Date:	2026/10/18
+ * Version:	1.0
+ *
+ * Purpose:	Declares the batch generation and export run by
+ *		"Graphic --sweep".
+ */
+
+#ifndef SWEEP_H
+#define SWEEP_H
+
+#include <QStringList>
+
+int run_sweep(const QStringList & args);
+
+#endif // SWEEP_H
@@ -0,0 +1,202 @@
+/*
+ * File:    undostack.cpp
+ * Date:    2026/10/18
+ * Version: 1.0
+ *
+ * Purpose: Keeps the history of edits that Edit->Undo and Edit->Redo
+ *          step through.
+ *
+ * Notes:   Unlike QUndoStack, the history is limited by the memory its
+ *          commands use rather than by how many there are: one command
+ *          may hold a few moved nodes or a whole deleted graph.  When
+ *          the total passes UNDO_MAX_COST the oldest commands are
+ *          forgotten.  A command pushed right after a similar one may
+ *          be merged into it, so that (say) a run of small drags of the
+ *          same node is undone in one step.
+ */
+
+#include "undostack.h"
+
+// The most memory (in bytes) the history may use.  The newest command
+// is kept even if it alone uses more.
+#define UNDO_MAX_COST	(64 << 20)
+
+
+/*
+ * Name:        mergeWith
+ * Purpose:     Folds the command done next into this one.
+ * Arguments:   the later command
+ * Output:      none
+ * Modifies:    this command
+ * Returns:     true if it was merged, in which case it is deleted
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       By default commands aren't merged.
+ */
+
+bool
+UndoCommand::mergeWith(const UndoCommand * later)
+{
+    Q_UNUSED(later);
+    return false;
+}
+
+
+/*
+ * Name:        UndoStack
+ * Purpose:     Constructor for UndoStack.
+ * Arguments:   the parent QObject
+ * Output:      none
+ * Modifies:    none
+ * Returns:     none
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       none
+ */
+
+UndoStack::UndoStack(QObject * parent)
+    : QObject(parent)
+{
+    done = 0;
+    totalCost = 0;
+}
+
+
+UndoStack::~UndoStack()
+{
+    clear();
+}
+
+
+/*
+ * Name:        push
+ * Purpose:     Adds a command that has just been done to the history.
+ * Arguments:   the command
+ * Output:      none
+ * Modifies:    commands, done, totalCost
+ * Returns:     none
+ * Assumptions: The command has been done, and was allocated with new.
+ * Bugs:        none
+ * Notes:       The commands that had been undone can't be redone any
+ *              more, so they are deleted, newest first.
+ */
+
+void
+UndoStack::push(UndoCommand * command)
+{
+    while (commands.count() > done)
+    {
+	UndoCommand * undone = commands.takeLast();
+	totalCost -= undone->cost();
+	delete undone;
+    }
+
+    if (done > 0 && commands.last()->mergeWith(command))
+    {
+	delete command;
+	changed();
+	return;
+    }
+
+    commands.append(command);
+    done++;
+    totalCost += command->cost();
+
+    while (totalCost > UNDO_MAX_COST && commands.count() > 1)
+    {
+	UndoCommand * oldest = commands.takeFirst();
+	totalCost -= oldest->cost();
+	delete oldest;
+	done--;
+    }
+    changed();
+}
+
+
+bool
+UndoStack::canUndo() const
+{
+    return done > 0;
+}
+
+
+bool
+UndoStack::canRedo() const
+{
+    return done < commands.count();
+}
+
+
+/*
+ * Name:        clear
+ * Purpose:     Forgets the whole history.
+ * Arguments:   none
+ * Output:      none
+ * Modifies:    commands, done, totalCost
+ * Returns:     none
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       The newest commands are deleted first, as in push().
+ */
+
+void
+UndoStack::clear()
+{
+    while (!commands.isEmpty())
+	delete commands.takeLast();
+    done = 0;
+    totalCost = 0;
+    changed();
+}
+
+
+/*
+ * Name:        undo
+ * Purpose:     Undoes the last command done.
+ * Arguments:   none
+ * Output:      none
+ * Modifies:    done, and whatever the command changes
+ * Returns:     none
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       Does nothing if there is nothing to undo.
+ */
+
+void
+UndoStack::undo()
+{
+    if (done == 0)
+	return;
+    commands.at(--done)->undo();
+    changed();
+}
+
+
+/*
+ * Name:        redo
+ * Purpose:     Redoes the last command undone.
+ * Arguments:   none
+ * Output:      none
+ * Modifies:    done, and whatever the command changes
+ * Returns:     none
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       Does nothing if there is nothing to redo.
+ */
+
+void
+UndoStack::redo()
+{
+    if (done == commands.count())
+	return;
+    commands.at(done++)->redo();
+    changed();
+}
+
+
+void
+UndoStack::changed()
+{
+    emit canUndoChanged(canUndo());
+    emit canRedoChanged(canRedo());
+}
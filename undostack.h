@@ -0,0 +1,55 @@
+/*
+ * File:	undostack.h
+ * Date:	2026/10/18
+ * Version:	1.0
+ *
+ * Purpose:	Declares the history of edits that Edit->Undo and
+ *		Edit->Redo step through.
+ */
+
+#ifndef UNDOSTACK_H
+#define UNDOSTACK_H
+
+#include <QList>
+#include <QObject>
+
+// One step of the history.  A command is made after (or while) its
+// edit is done, so undo() is always called before redo().
+class UndoCommand
+{
+public:
+    virtual ~UndoCommand() {}
+    virtual void undo() = 0;
+    virtual void redo() = 0;
+    virtual qint64 cost() const = 0;	// Roughly, in bytes.
+    virtual bool mergeWith(const UndoCommand * later);
+};
+
+class UndoStack : public QObject
+{
+    Q_OBJECT
+public:
+    explicit UndoStack(QObject * parent = 0);
+    ~UndoStack();
+    void push(UndoCommand * command);
+    bool canUndo() const;
+    bool canRedo() const;
+    void clear();
+
+public slots:
+    void undo();
+    void redo();
+
+signals:
+    void canUndoChanged(bool canUndo);
+    void canRedoChanged(bool canRedo);
+
+private:
+    void changed();
+
+    QList<UndoCommand *> commands;	// Oldest first.
+    int done;			// commands[0 .. done) are done.
+    qint64 totalCost;
+};
+
+#endif // UNDOSTACK_H